@@ -8,10 +8,14 @@
 /////////////////////////////////////////////////////////////////
 
 #include "DisplayInterface.h"
+#include "EmbeddedDisplay.h"
 #include "MainWindow.h"
 #include "QOSGWidget.h"
+#include "StallWatchdog.h"
 #include "TreeView.h"
 
+#include <DDDisplayObjects/TaskScheduler.h>
+
 #include <iostream>
 #include <chrono>
 
@@ -25,6 +29,31 @@ DisplayInterface& di()
     return *(DI.get());
 };
 
+/// The newest async add of a name
+struct DisplayInterface::AsyncAdd
+{
+    AsyncAdd() : mutex(), newest(0), token(), pending(0) {};
+
+    std::mutex      mutex;
+    uint64_t        newest;
+    CancelToken     token;
+
+    /// The adds which haven't finished (protected by m_asyncMutex)
+    size_t          pending;
+
+    /// @brief   Is this still the newest add of its name
+    ///
+    /// The add itself happens after the mutex is let go, so the next
+    /// addAsync() of the name doesn't wait for the tree view. A newer add
+    /// which gets in between is just added after it (the tree view keeps the
+    /// last one).
+    bool isNewest(const uint64_t& sequence)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return sequence == newest;
+    };
+};
+
 /////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////
 std::shared_ptr<DisplayInterface> DisplayInterface::get()
@@ -50,11 +79,84 @@ bool DisplayInterface::add(const std::string& name,
                            const osg::ref_ptr<osg::Node> node,
                            const bool& addToDisplay /* = true */)
 {
-    // we have data - the display thread needs to know this before we setup the
-    // main window
-    m_haveData = true;
+    // the latency is measured from here
+    return submit(name, node, addToDisplay, LatencyTracker::now_ns());
+};
 
-    // make sure the main window has been setup
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+bool DisplayInterface::addAsync(const std::string& name,
+                                std::function<osg::ref_ptr<osg::Node>()>&& builder,
+                                const bool& addToDisplay /* = true */)
+{
+    const int64_t submitted( LatencyTracker::now_ns() );
+
+    // the entry stays while any add of the name is still running (or queued)
+    std::shared_ptr<AsyncAdd> async;
+    {
+        std::lock_guard<std::mutex> lock(m_asyncMutex);
+        std::shared_ptr<AsyncAdd>& newest( m_asyncAdds[name] );
+        if ( not newest ) newest = std::make_shared<AsyncAdd>();
+        async = newest;
+        ++async->pending;
+    }
+    const std::shared_ptr<void> done(nullptr,
+                                     [this, name, async](void*)
+                                     {
+                                         std::lock_guard<std::mutex> lock(m_asyncMutex);
+                                         if ( 0 != --async->pending ) return;
+                                         std::unordered_map<std::string, std::shared_ptr<AsyncAdd>>::iterator
+                                             it( m_asyncAdds.find(name) );
+                                         if ( (m_asyncAdds.end() != it) && (async == it->second) )
+                                             m_asyncAdds.erase(it);
+                                     });
+
+    // call off the last one, if it hasn't started - even if this one is
+    // deferred, so the last one can't finish over it
+    CancelToken token;
+    uint64_t sequence(0);
+    {
+        std::lock_guard<std::mutex> lock(async->mutex);
+        async->token.cancel();
+        async->token = token;
+        sequence = ++async->newest;
+    }
+
+    // nobody is looking, so keep the builder for when someone does
+    if ( not isWanted(name) )
+    {
+        if ( not async->isNewest(sequence) ) return true;
+        return addDeferred(name, std::move(builder), addToDisplay);
+    }
+
+    std::shared_ptr<std::function<osg::ref_ptr<osg::Node>()>> shared(
+        std::make_shared<std::function<osg::ref_ptr<osg::Node>()>>(std::move(builder)) );
+    schedule([this, name, shared, addToDisplay, submitted, async, sequence, done]()
+             {
+                 // it may have been hidden while this was queued
+                 if ( not isWanted(name) )
+                 {
+                     if ( async->isNewest(sequence) )
+                         addDeferred(name, std::move(*shared), addToDisplay);
+                     return;
+                 }
+
+                 osg::ref_ptr<osg::Node> node( (*shared)() );
+                 if ( node && async->isNewest(sequence) )
+                     submit(name, node, addToDisplay, submitted);
+             },
+             Priority::STREAMING,
+             token);
+    return true;
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+bool DisplayInterface::addDeferred(const std::string& name,
+                                   std::function<osg::ref_ptr<osg::Node>()>&& builder,
+                                   const bool& addToDisplay /* = true */)
+{
+    m_haveData = true;
     if ( not setupMainWindow() )
     {
         std::cerr << "BUMMER: No main window for you" << std::endl;
@@ -62,20 +164,20 @@ bool DisplayInterface::add(const std::string& name,
         return false;
     }
 
-    // get the lock so we can add stuff
-    std::lock_guard<std::mutex> l_lock(m_mutex);
+    if ( m_pEmbedded )
+        return m_pEmbedded->addDeferred(name, std::move(builder), addToDisplay);
 
-    // add this node to the tree view
-    // @note: the setupMainWindow() also sets up the tree view.
+    std::lock_guard<std::mutex> l_lock(m_mutex);
     static const bool showNode(true);
-    return m_pTreeView->add(name, node, showNode, addToDisplay);
+    return m_pTreeView->addDeferred(name, std::move(builder), showNode, addToDisplay);
 };
 
 /////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////
 bool DisplayInterface::add(const osgGA::GUIEventAdapter::KeySymbol& key,
                            const std::function<bool(const osgGA::GUIEventAdapter&)>& func,
-                           const std::string& description /* = "NONE" */)
+                           const std::string& description /* = "NONE" */,
+                           const ExecutionPolicy& policy /* = ExecutionPolicy() */)
 {
     // we have data - the display thread needs to know this before we setup the
     // main window
@@ -89,26 +191,43 @@ bool DisplayInterface::add(const osgGA::GUIEventAdapter::KeySymbol& key,
         return false;
     }
 
+    const std::function<bool(const osgGA::GUIEventAdapter&)> handler( dispatched(func, policy, osgGA::GUIEventAdapter::KEYDOWN) );
+    if ( not handler ) return false;
+
+    // the embedded widget's handlers belong to the host's thread
+    if ( m_pEmbedded && not m_pEmbedded->onGuiThread() )
+    {
+        EmbeddedDisplay* embedded( m_pEmbedded );
+        m_pEmbedded->post([embedded, key, handler, description]()
+                          {
+                              if ( embedded->getOsgWidget() )
+                                  embedded->getOsgWidget()->addKeyHandler(key, handler, description);
+                          });
+        return true;
+    }
+
     // get the lock so we can add stuff
     std::lock_guard<std::mutex> l_lock(m_mutex);
 
-    return m_pOsgWidget->addKeyHandler(key, func, description);
+    return m_pOsgWidget->addKeyHandler(key, handler, description);
 };
 
 /////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////
 bool DisplayInterface::add(const char& key,
                            const std::function<bool(const osgGA::GUIEventAdapter&)>& func,
-                           const std::string& description /* = "NONE" */)
+                           const std::string& description /* = "NONE" */,
+                           const ExecutionPolicy& policy /* = ExecutionPolicy() */)
 {
-    return add((osgGA::GUIEventAdapter::KeySymbol)key, func, description);
+    return add((osgGA::GUIEventAdapter::KeySymbol)key, func, description, policy);
 };
 
 /////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////
 bool DisplayInterface::add(const osgGA::GUIEventAdapter::MouseButtonMask& button,
                            const std::function<bool(const osgGA::GUIEventAdapter&)>& func,
-                           const std::string& description /* = "NONE" */)
+                           const std::string& description /* = "NONE" */,
+                           const ExecutionPolicy& policy /* = ExecutionPolicy() */)
 {
     m_haveData = true;
 
@@ -119,16 +238,32 @@ bool DisplayInterface::add(const osgGA::GUIEventAdapter::MouseButtonMask& button
         return false;
     }
 
+    const std::function<bool(const osgGA::GUIEventAdapter&)> handler( dispatched(func, policy, osgGA::GUIEventAdapter::PUSH) );
+    if ( not handler ) return false;
+
+    // the embedded widget's handlers belong to the host's thread
+    if ( m_pEmbedded && not m_pEmbedded->onGuiThread() )
+    {
+        EmbeddedDisplay* embedded( m_pEmbedded );
+        m_pEmbedded->post([embedded, button, handler, description]()
+                          {
+                              if ( embedded->getOsgWidget() )
+                                  embedded->getOsgWidget()->addClickHandler(button, handler, description);
+                          });
+        return true;
+    }
+
     // get the lock so we can add stuff
     std::lock_guard<std::mutex> l_lock(m_mutex);
 
-    return m_pOsgWidget->addClickHandler(button, func, description);
+    return m_pOsgWidget->addClickHandler(button, handler, description);
 };
 
 /////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////
 bool DisplayInterface::add(const std::function<bool(const osgGA::GUIEventAdapter&)>& func,
-                           const std::string& description /* = "NONE" */)
+                           const std::string& description /* = "NONE" */,
+                           const ExecutionPolicy& policy /* = ExecutionPolicy() */)
 {
     m_haveData = true;
 
@@ -139,10 +274,44 @@ bool DisplayInterface::add(const std::function<bool(const osgGA::GUIEventAdapter
         return false;
     }
 
+    static const bool latestOnly(true);
+
+    const std::function<bool(const osgGA::GUIEventAdapter&)> handler( dispatched(func, policy, osgGA::GUIEventAdapter::MOVE, latestOnly) );
+    if ( not handler ) return false;
+
+    // the embedded widget's handlers belong to the host's thread
+    if ( m_pEmbedded && not m_pEmbedded->onGuiThread() )
+    {
+        EmbeddedDisplay* embedded( m_pEmbedded );
+        m_pEmbedded->post([embedded, handler, description]()
+                          {
+                              if ( embedded->getOsgWidget() )
+                                  embedded->getOsgWidget()->addMotionEventHandler(handler, description);
+                          });
+        return true;
+    }
+
     // get the lock so we can add stuff
     std::lock_guard<std::mutex> l_lock(m_mutex);
 
-    return m_pOsgWidget->addMotionEventHandler(func, description);
+    return m_pOsgWidget->addMotionEventHandler(handler, description);
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+bool DisplayInterface::post(std::function<void()>&& func)
+{
+    m_haveData = true;
+
+    if ( not setupMainWindow() )
+    {
+        std::cerr << "BUMMER: No main window for you" << std::endl;
+        m_haveData = false;
+        return false;
+    }
+
+    m_pOsgWidget->post(std::move(func));
+    return true;
 };
 
 /////////////////////////////////////////////////////////////////
@@ -164,6 +333,18 @@ bool DisplayInterface::track(const osg::ref_ptr<osg::Node>& node,
         return false;
     }
 
+    // the embedded widget's manipulators belong to the host's thread
+    if ( m_pEmbedded && not m_pEmbedded->onGuiThread() )
+    {
+        EmbeddedDisplay* embedded( m_pEmbedded );
+        m_pEmbedded->post([embedded, node, eye, center, up]()
+                          {
+                              if ( embedded->getOsgWidget() )
+                                  embedded->getOsgWidget()->trackNode(node, eye, center, up);
+                          });
+        return true;
+    }
+
     m_pOsgWidget->trackNode(node, eye, center, up);
     return true;
 };
@@ -187,6 +368,10 @@ void DisplayInterface::blockForClose()
 /////////////////////////////////////////////////////////////////
 bool DisplayInterface::running() const
 {
+    // the widget can only be asked on the host's thread, so ask what it saw
+    if ( m_pEmbedded )
+        return m_pEmbedded->isShown();
+
     return (m_pMainWindow && m_pMainWindow->isVisible());
 };
 
@@ -284,6 +469,251 @@ void DisplayInterface::unpause()
     m_pauseNotifier.notify_all();
 };
 
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void DisplayInterface::setMemoryBudget(const size_t& bytes,
+                                       const std::string& spillDirectory /* = "" */)
+{
+    // hold on to this for when the tree view gets created
+    std::lock_guard<std::mutex> l_lock(m_mutex);
+    m_memoryBudget = bytes;
+    m_spillDirectory = spillDirectory;
+
+    if ( m_pTreeView )
+        m_pTreeView->setMemoryBudget(m_memoryBudget, m_spillDirectory);
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void DisplayInterface::setOcclusionCulling(const size_t& minVertices)
+{
+    // hold on to this for when the tree view gets created
+    std::lock_guard<std::mutex> l_lock(m_mutex);
+    m_occlusionVertices = minVertices;
+
+    if ( m_pTreeView )
+        m_pTreeView->setOcclusionCulling(m_occlusionVertices);
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void DisplayInterface::setWorkerThreads(const unsigned int& numWorkers,
+                                        const std::vector<int>& cpus /* = std::vector<int>() */)
+{
+    d3::setWorkerThreads(numWorkers, cpus);
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+bool DisplayInterface::setVisibleInViewport(const std::string& name,
+                                            const unsigned int& viewport,
+                                            const bool& visible)
+{
+    if ( (nullptr == m_pTreeView) || (viewport >= QOSGWidget::maxViewports) )
+        return false;
+
+    // the embedded tree view belongs to the host's thread
+    if ( m_pEmbedded && not m_pEmbedded->onGuiThread() )
+    {
+        EmbeddedDisplay* embedded( m_pEmbedded );
+        m_pEmbedded->post([embedded, name, viewport, visible]()
+                          {
+                              if ( embedded->getTreeView() )
+                                  embedded->getTreeView()->setVisibleInView(name, QOSGWidget::viewMask(viewport), visible);
+                          });
+        return true;
+    }
+
+    return m_pTreeView->setVisibleInView(name, QOSGWidget::viewMask(viewport), visible);
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+bool DisplayInterface::setViewportFrameRate(const unsigned int& viewport,
+                                            const double& hz)
+{
+    QOSGWidget* widget( m_pMainWindow ? m_pMainWindow->getViewport(viewport) :
+                        (0 == viewport ? m_pOsgWidget : nullptr) );
+    if ( nullptr == widget ) return false;
+
+    widget->setMaxFrameRate(hz);
+    return true;
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+bool DisplayInterface::setPose(const std::string& name,
+                               const osg::Matrixd& pose)
+{
+    PoseHandle handle;
+    {
+        std::lock_guard<std::mutex> lock(m_poseMutex);
+        auto itt( m_poseHandles.find(name) );
+        if ( m_poseHandles.end() != itt ) handle = itt->second;
+    }
+
+    // the first pose of a name may wait for the embedded host's thread, so
+    // the other names don't wait with it (the handles of an item all share
+    // its poses, so it doesn't matter whose is kept)
+    if ( not handle.valid() )
+    {
+        handle = getPoseHandle(name);
+        if ( not handle.valid() ) return false;
+
+        std::lock_guard<std::mutex> lock(m_poseMutex);
+        m_poseHandles.insert(std::make_pair(name, handle));
+    }
+    return handle.set(pose);
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+PoseHandle DisplayInterface::getPoseHandle(const std::string& name)
+{
+    if ( nullptr == m_pTreeView ) return PoseHandle();
+
+    // the item may get wrapped in a transform, on the host's thread
+    if ( m_pEmbedded )
+    {
+        EmbeddedDisplay* embedded( m_pEmbedded );
+        return m_pEmbedded->call([embedded, name]()
+                                 {
+                                     return embedded->getTreeView() ?
+                                         embedded->getTreeView()->getPoseHandle(name) : PoseHandle();
+                                 });
+    }
+
+    return m_pTreeView->getPoseHandle(name);
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+bool DisplayInterface::setStyle(const std::string& name,
+                                const Style& style)
+{
+    if ( nullptr == m_pTreeView ) return false;
+
+    // the embedded tree view belongs to the host's thread
+    if ( m_pEmbedded && not m_pEmbedded->onGuiThread() )
+    {
+        EmbeddedDisplay* embedded( m_pEmbedded );
+        m_pEmbedded->post([embedded, name, style]()
+                          {
+                              if ( embedded->getTreeView() )
+                                  embedded->getTreeView()->setStyle(name, style);
+                          });
+        return true;
+    }
+
+    return m_pTreeView->setStyle(name, style);
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void DisplayInterface::enableWatchdog(const unsigned int& threshold_ms /* = 250 */)
+{
+    if ( threshold_ms ) watchdog().start(threshold_ms);
+    else                watchdog().stop();
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void DisplayInterface::enableDrawProfiling(const bool& enable /* = true */)
+{
+    // the tree view lives on the display thread
+    if ( m_pTreeView )
+        QMetaObject::invokeMethod(m_pTreeView,
+                                  "setProfiling",
+                                  Qt::QueuedConnection,
+                                  Q_ARG(bool, enable));
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+std::map<std::string, LatencyStats> DisplayInterface::getLatencyStats() const
+{
+    if ( nullptr == m_pTreeView ) return std::map<std::string, LatencyStats>();
+    return m_pTreeView->getLatencyTracker()->getStats();
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void DisplayInterface::showLatencyHud(const bool& show /* = true */)
+{
+    if ( not show && (nullptr == m_pTreeView) ) return;
+
+    // the hud is data, so this brings up the display like an add() does
+    m_haveData = true;
+    if ( not setupMainWindow() )
+    {
+        std::cerr << "BUMMER: No main window for you" << std::endl;
+        m_haveData = false;
+        return;
+    }
+
+    // the first time, the hud is added like any other item
+    const osg::ref_ptr<LatencyTracker>& tracker( m_pTreeView->getLatencyTracker() );
+    if ( show && not m_latencyHudAdded.exchange(true) )
+        add("Latency HUD", tracker->getHud());
+    tracker->showHud(show);
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+std::shared_future<std::vector<SceneFinding>> DisplayInterface::analyze()
+{
+    if ( nullptr == m_pTreeView )
+    {
+        std::promise<std::vector<SceneFinding>> nothing;
+        nothing.set_value(std::vector<SceneFinding>());
+        return nothing.get_future().share();
+    }
+
+    // the snapshot walks the tree view, on the host's thread
+    if ( m_pEmbedded )
+    {
+        EmbeddedDisplay* embedded( m_pEmbedded );
+        return m_pEmbedded->call([embedded]()
+                                 {
+                                     if ( embedded->getTreeView() )
+                                         return embedded->getTreeView()->analyze();
+                                     std::promise<std::vector<SceneFinding>> nothing;
+                                     nothing.set_value(std::vector<SceneFinding>());
+                                     return nothing.get_future().share();
+                                 });
+    }
+
+    return m_pTreeView->analyze();
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+EmbeddedDisplay* DisplayInterface::embed(QObject* parent /* = nullptr */)
+{
+    std::unique_lock<std::mutex> l_lock(m_mutex);
+    if ( m_pEmbedded ) return m_pEmbedded;
+
+    if ( m_pMainWindow || m_haveData )
+    {
+        std::cerr << "BUMMER: Can't embed the display, it's already running" << std::endl;
+        return nullptr;
+    }
+
+    m_pEmbedded = new EmbeddedDisplay(parent);
+    m_pOsgWidget = m_pEmbedded->getOsgWidget();
+    m_pTreeView = m_pEmbedded->getTreeView();
+    m_pTreeView->setMemoryBudget(m_memoryBudget, m_spillDirectory);
+    m_pTreeView->setOcclusionCulling(m_occlusionVertices);
+
+    // let the display thread go, there's nothing for it to do
+    m_threadShouldRun = false;
+    m_haveData = true;
+    m_setupComplete = true;
+    m_addNotify.notify_all();
+
+    return m_pEmbedded;
+};
+
 /////////////////////////////////////////////////////////////////
 ///////////////////// PRIVATES /////////////////////////////////
 ///////////////////////////////////////////////////////////////
@@ -294,6 +724,7 @@ DisplayInterface::DisplayInterface() :
     m_pMainWindow(nullptr),
     m_pTreeView(nullptr),
     m_pOsgWidget(nullptr),
+    m_pEmbedded(nullptr),
     m_mutex(),
     m_addNotify(),
     m_haveData(false),
@@ -301,7 +732,15 @@ DisplayInterface::DisplayInterface() :
     m_displayThread(),
     m_threadShouldRun(true),
     m_pauseMutex(),
-    m_pauseNotifier()
+    m_pauseNotifier(),
+    m_memoryBudget(0),
+    m_spillDirectory(),
+    m_occlusionVertices(0),
+    m_poseMutex(),
+    m_poseHandles(),
+    m_latencyHudAdded(false),
+    m_asyncMutex(),
+    m_asyncAdds()
 {
     m_displayThread =
         std::thread
@@ -356,6 +795,8 @@ DisplayInterface::DisplayInterface() :
                  {
                      m_pTreeView = new TreeView();
                      m_pTreeView->setOsgWidget(m_pOsgWidget);
+                     m_pTreeView->setMemoryBudget(m_memoryBudget, m_spillDirectory);
+                     m_pTreeView->setOcclusionCulling(m_occlusionVertices);
                  }
 
                  // pack this tree view into the main window
@@ -372,12 +813,16 @@ DisplayInterface::DisplayInterface() :
              // run the application - forever
              while ( m_threadShouldRun )
              {
+                 // let the watchdog know we're still going
+                 watchdog().beat();
+
                  // lock osg so qt doesn't clobber osg
                  if ( m_pOsgWidget->try_lock() )
                  {
                      // lock the main window
                      if ( m_pMainWindow->try_lock() )
                      {
+                         StallWatchdog::ScopedPhase phase(StallWatchdog::Phase::PROCESS_EVENTS);
                          application->processEvents();
                          m_pMainWindow->unlock();
                      }
@@ -395,8 +840,9 @@ DisplayInterface::DisplayInterface() :
 /////////////////////////////////////////////////////////////////
 DisplayInterface::~DisplayInterface()
 {
-    // exit the qt appliation
-    QCoreApplication::exit(0);
+    // exit the qt appliation - unless it's the host's
+    if ( nullptr == m_pEmbedded )
+        QCoreApplication::exit(0);
 
     // see if we have been setup and need to close the main window
     if ( nullptr != m_pMainWindow )
@@ -420,6 +866,9 @@ DisplayInterface::~DisplayInterface()
 /////////////////////////////////////////////////////////////////
 bool DisplayInterface::setupMainWindow()
 {
+    // the host set everything up
+    if ( m_pEmbedded ) return true;
+
     // setup the main window if we need to
     if ( nullptr == m_pMainWindow )
     {
@@ -436,4 +885,36 @@ bool DisplayInterface::setupMainWindow()
     return nullptr != m_pMainWindow;
 };
 
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+bool DisplayInterface::submit(const std::string& name,
+                              const osg::ref_ptr<osg::Node> node,
+                              const bool& addToDisplay,
+                              const int64_t& submitted_ns)
+{
+    // we have data - the display thread needs to know this before we setup the
+    // main window
+    m_haveData = true;
+
+    // make sure the main window has been setup
+    if ( not setupMainWindow() )
+    {
+        std::cerr << "BUMMER: No main window for you" << std::endl;
+        m_haveData = false;
+        return false;
+    }
+
+    // the embedded display hands this to the host's thread
+    if ( m_pEmbedded )
+        return m_pEmbedded->add(name, node, addToDisplay, submitted_ns);
+
+    // get the lock so we can add stuff
+    std::lock_guard<std::mutex> l_lock(m_mutex);
+
+    // add this node to the tree view
+    // @note: the setupMainWindow() also sets up the tree view.
+    static const bool showNode(true);
+    return m_pTreeView->submit(name, node, showNode, addToDisplay, submitted_ns);
+};
+
 } // namespace d3
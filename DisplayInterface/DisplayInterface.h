@@ -9,17 +9,28 @@
 
 #pragma once
 
+#include <DDDisplayInterface/HandlerExecution.h>
+#include <DDDisplayInterface/LatencyTracker.h>
 #include <DDDisplayInterface/MainPage.h>
+#include <DDDisplayInterface/PoseHandle.h>
+#include <DDDisplayInterface/SceneAnalyzer.h>
+#include <DDDisplayInterface/Style.h>
+#include <DDDisplayInterface/Subscriptions.h>
 
 #include <osg/Node>
 #include <osgViewer/Viewer>
 
+#include <atomic>
+#include <map>
 #include <queue>
 #include <condition_variable>
+#include <future>
 #include <thread>
+#include <unordered_map>
 
 class QWidget;
 class QDockWidget;
+class QObject;
 
 namespace d3
 {
@@ -35,6 +46,7 @@ class TreeView;
 DisplayInterface& di();
 
 /// forward declare the stuff that makes life good
+class EmbeddedDisplay;
 class MainWindow;
 class QOSGWidget;
 
@@ -144,17 +156,88 @@ class DisplayInterface
              const osg::ref_ptr<osg::Node> node,
              const bool& addToDisplay = true);
 
+    /// @brief   Method to add stuff which is only built once it's shown
+    /// @param   name The name of the thing we are adding (as in add())
+    /// @param   builder The function which builds the osg node
+    /// @param   addToDisplay Should we add this node to the display?
+    /// @return  boolean True implies success
+    ///
+    /// The tree view remembers the items the user hides (per application, as
+    /// path patterns) and the next run starts them out hidden. A heavy layer
+    /// that is always hidden can be added this way, so its node isn't built
+    /// (and never uploaded) unless someone checks it:
+    /// @code
+    /// d3::di().addDeferred( "map::raw", [&]() { return d3::get(rawMap, 1.0); } );
+    /// @endcode
+    /// The builder runs on the display thread, so it must not rely on
+    /// anything that goes away after this call.
+    bool addDeferred(const std::string& name,
+                     std::function<osg::ref_ptr<osg::Node>()>&& builder,
+                     const bool& addToDisplay = true);
+
+    /// @brief   Method to add stuff built on the shared workers, only if
+    ///          someone is looking at it
+    /// @param   name The name of the thing we are adding (as in add())
+    /// @param   builder The function which builds the osg node
+    /// @param   addToDisplay Should we add this node to the display?
+    /// @return  boolean True implies the add was queued (or deferred)
+    ///
+    /// This returns right away. If the name is wanted (see isWanted()), the
+    /// builder runs on the shared workers and the node is added when it's
+    /// done. If not, it's kept like addDeferred() and only built if the item
+    /// is checked, so a producer which streams a hidden layer pays about
+    /// nothing for it. Only the newest add of a name counts - an older one
+    /// which hasn't started is dropped, and one which finishes late is thrown
+    /// away. The builder should share the data (i.e. hold a shared_ptr to it)
+    /// rather than copy it, or the copy is what the producer pays for:
+    /// @code
+    /// std::shared_ptr<const Scan> pScan( ... );
+    /// d3::di().addAsync( "lidar::scan", [pScan]() { return d3::get(*pScan); } );
+    /// @endcode
+    bool addAsync(const std::string& name,
+                  std::function<osg::ref_ptr<osg::Node>()>&& builder,
+                  const bool& addToDisplay = true);
+
+    /// @brief   Is anyone looking at a name
+    /// @param   name The full name of an item, or a namespace (i.e. "AA::BB")
+    /// @return  boolean False if the item (or the nearest namespace of it the
+    ///          display has) is unchecked or under an unchecked namespace
+    ///
+    /// This is a few atomic loads - no locks, no allocation, and it doesn't
+    /// start the display - so a producer can check it every cycle and skip
+    /// the work for what nobody is viewing:
+    /// @code
+    /// if ( d3::di().isWanted("planner::debug") )
+    ///     d3::di().add( "planner::debug::tree", d3::get(planner.tree()) );
+    /// @endcode
+    /// A name the display has never seen is always wanted, so the first add
+    /// has to happen for the user to be able to hide it.
+    bool isWanted(const std::string& name) const { return Subscriptions::get().isWanted(name); };
+
     /// @brief   Method to add a function bound to a keypress
     /// @param   key The key to bind to this function
     /// @param   func The function to call when the key is pressed
     /// @param   description The description of the function
+    /// @param   policy Where the function runs (the render thread by default)
     /// @return  boolean True implies success
     ///
     /// This is the add function that allows arbitrary functions to be tied to
-    /// key events.
+    /// key events. A function that takes a while shouldn't hold up the
+    /// rendering, so run it somewhere else:
+    /// @code
+    /// d3::di().add( 'r', [&](const osgGA::GUIEventAdapter&)
+    ///                    {
+    ///                        d3::di().add( "plan", d3::get(planner.step()) );
+    ///                        return true;
+    ///                    },
+    ///               "Re-run the planner", d3::ExecutionPolicy::workerPool() );
+    /// @endcode
+    /// See ExecutionPolicy for how those run, and which events they get. An
+    /// off-thread policy without an executor is refused.
     bool add(const osgGA::GUIEventAdapter::KeySymbol& key,
              const std::function<bool(const osgGA::GUIEventAdapter&)>& func,
-             const std::string& description = "NONE");
+             const std::string& description = "NONE",
+             const ExecutionPolicy& policy = ExecutionPolicy());
 
     /// @brief   Method to add a function bound to a keypress
     /// @param   key The key to bind to this function (char version)
@@ -167,25 +250,42 @@ class DisplayInterface
     /// a proper KeySymbol
     bool add(const char& key,
              const std::function<bool(const osgGA::GUIEventAdapter&)>& func,
-             const std::string& description = "NONE");
+             const std::string& description = "NONE",
+             const ExecutionPolicy& policy = ExecutionPolicy());
 
     /// @brief   Method to add a function bound to a mouse button press
     /// @param   button The mouse button to bind to this function
     /// @param   func The function to call when the key is pressed
     /// @param   description The description of the function
+    /// @param   policy Where the function runs (the render thread by default)
     /// @return  boolean True implies success
     bool add(const osgGA::GUIEventAdapter::MouseButtonMask& button,
              const std::function<bool(const osgGA::GUIEventAdapter&)>& func,
-             const std::string& description = "NONE");
+             const std::string& description = "NONE",
+             const ExecutionPolicy& policy = ExecutionPolicy());
 
     /// @brief   Add a method to handle mouse movement events
     /// @param   func The function to call for mouse movements
     /// @param   description The description of the function (i.e. for help)
+    /// @param   policy Where the function runs (the render thread by default)
     /// @return  boolean True implies success
     /// @note    The function will only be called when no mouse buttons are
-    ///          pressed, and only when the event type is "MOVE"
+    ///          pressed, and only when the event type is "MOVE". Off the
+    ///          render thread, moves which queue up while it runs are
+    ///          collapsed to the latest one.
     bool add(const std::function<bool(const osgGA::GUIEventAdapter&)>& func,
-             const std::string& description = "NONE");
+             const std::string& description = "NONE",
+             const ExecutionPolicy& policy = ExecutionPolicy());
+
+    /// @brief   Run a function on the display thread, in the next update
+    ///          traversal (from any thread)
+    /// @param   func The function to run
+    /// @return  boolean True implies success
+    ///
+    /// This is the way for a handler running off the render thread to touch
+    /// the scene (i.e. change a node it holds on to) without taking the lock.
+    /// The posted functions run in the order they were posted.
+    bool post(std::function<void()>&& func);
 
     /// @brief   Track a node with the camera
     /// @param   node The node to track
@@ -268,7 +368,192 @@ class DisplayInterface
 
     /// @brief   Also need to be able to unpause processing
     void unpause();
-    
+
+    /// @brief   Set a memory budget for the displayed items
+    /// @param   bytes The number of bytes the displayed items may hold (0, the
+    ///          default, means there is no limit)
+    /// @param   spillDirectory Where to write evicted items, leave empty to
+    ///          keep the compressed copies in RAM
+    ///
+    /// Long debugging sessions can pile up gigabytes of geometry in items that
+    /// have been unchecked in the tree view and are never looked at again. When
+    /// the display goes over this budget, hidden items are evicted (least
+    /// recently viewed first). The GL objects and arrays of an evicted item are
+    /// released and a compressed serialized copy is kept in RAM or in the spill
+    /// directory. The item is rebuilt when it is checked again. Items which
+    /// are still changing (update callbacks, DYNAMIC data, or nodes the
+    /// application holds on to) are never evicted.
+    void setMemoryBudget(const size_t& bytes,
+                         const std::string& spillDirectory = "");
+
+    /// @brief   Put the heavy parts of the added items behind occlusion queries
+    /// @param   minVertices How many vertices a geode needs before it's worth
+    ///          a query (0, the default, turns it off)
+    ///
+    /// A layer of millions of points is drawn in full even when it's behind a
+    /// wall or a terrain mesh. With this on, every geode of at least this many
+    /// vertices in the items added from here on is wrapped in an occlusion
+    /// query (a single cloud of points is split into spatial chunks first, so
+    /// the parts behind something can be skipped). A chunk is only skipped
+    /// once its whole bounding box was hidden in the last query, so nothing
+    /// visible is ever culled, but a chunk coming into view can show up a
+    /// frame late. The queries cost a little, so keep the threshold high
+    /// (100000 or so) so only the heavy layers get them. Items which change
+    /// their own geometry (update callbacks) are wrapped whole, not chunked.
+    void setOcclusionCulling(const size_t& minVertices);
+
+    /// @brief   Set up the threads for the display's background work
+    /// @param   numWorkers The number of threads (0 for one less than the
+    ///          number of cores, the default)
+    /// @param   cpus The cores they can run on (empty for any)
+    ///
+    /// The parallel builders, the image decoding, the scene analysis and the
+    /// handlers on the worker pool all share these threads, with the
+    /// handlers and the builders first, then the streaming (decoding), then
+    /// the rest - so the display's cpu use is bounded by this, however much
+    /// is going on. See DDDisplayObjects/TaskScheduler.h to put your own
+    /// work on them.
+    void setWorkerThreads(const unsigned int& numWorkers,
+                          const std::vector<int>& cpus = std::vector<int>());
+
+    /// @brief   Show or hide an item in one viewport only
+    /// @param   name The full name of the item
+    /// @param   viewport The index of the viewport (0 is the main one, the
+    ///          others are added with "Split View" in the menu)
+    /// @param   visible Should the item be drawn in that viewport
+    /// @return  boolean True if the item was found
+    bool setVisibleInViewport(const std::string& name,
+                              const unsigned int& viewport,
+                              const bool& visible);
+
+    /// @brief   Limit how often a viewport is rendered
+    /// @param   viewport The index of the viewport
+    /// @param   hz The most frames per second (0 for no limit)
+    /// @return  boolean True if there is such a viewport
+    bool setViewportFrameRate(const unsigned int& viewport,
+                              const double& hz);
+
+    /// @brief   Move an item without rebuilding it
+    /// @param   name The full name of the item
+    /// @param   pose The matrix from the item to its parent in the tree
+    /// @return  boolean True if the item was found
+    ///
+    /// The first pose wraps the item in a transform, after that only the
+    /// matrix is written. The poses are applied in the next frame, and only the
+    /// newest one if several were set between frames. This looks the item up by
+    /// name, use a PoseHandle to move many items every frame.
+    bool setPose(const std::string& name,
+                 const osg::Matrixd& pose);
+
+    /// @brief   Get a handle to move an item without any lookups or locks
+    /// @param   name The full name of the item
+    /// @return  PoseHandle The handle, invalid if the item is not displayed
+    ///          (yet)
+    ///
+    /// For example, to move a fleet of items every frame
+    /// @code
+    /// std::vector<d3::PoseHandle> handles;
+    /// for ( const auto& name : names )
+    ///     handles.push_back(d3::di().getPoseHandle(name));
+    /// ...
+    /// for ( size_t ii(0) ; ii<handles.size() ; ++ii )
+    ///     handles[ii].set(osg::Matrixd::translate(positions[ii]));
+    /// @endcode
+    PoseHandle getPoseHandle(const std::string& name);
+
+    /// @brief   Restyle an item without rebuilding it
+    /// @param   name The full name of the item
+    /// @param   style The tint, opacity, point size and line width
+    /// @return  boolean True if the item was found
+    ///
+    /// For example, to highlight the selected path and fade out the rest
+    /// @code
+    /// d3::di().setStyle("planner::selected", {d3::red(), 1.0, 0, 4.0});
+    /// d3::di().setStyle("planner::candidates", {{0, 0, 0, 0}, 0.2, 0, 0});
+    /// @endcode
+    /// The style is state on the item's transform (the same one as the pose),
+    /// so it costs the same whatever the size of the item, and it covers the
+    /// item's children. It's applied in the next frame, and only the newest
+    /// one if several were set between frames. The tint keeps the item's
+    /// first texture (modulated, as usual) but drops any others while it's
+    /// on. A fade alone keeps everything, but it takes the place of the
+    /// item's own translucency.
+    bool setStyle(const std::string& name,
+                  const Style& style);
+
+    /// @brief   Take the style back off an item
+    /// @param   name The full name of the item
+    /// @return  boolean True if the item was found
+    bool clearStyle(const std::string& name) { return setStyle(name, Style::none()); };
+
+    /// @brief   Watch the display thread for stalls
+    /// @param   threshold_ms How long a frame can take before it's reported as
+    ///          a stall (0 stops the watchdog)
+    ///
+    /// When the display freezes, the report says what the display thread was
+    /// doing (processing events, rendering, resizing the tree, writing a
+    /// capture...) and the last item applied, and then how long it lasted.
+    void enableWatchdog(const unsigned int& threshold_ms = 250);
+
+    /// @brief   Profile what each item costs to cull and draw
+    /// @param   enable Turn the profiling on or off
+    ///
+    /// The same as "Profile Draw Cost" in the menu. The tree view gets a column
+    /// with the cull and draw time of each item per frame (GPU timed where the
+    /// driver has timer queries), sorted with the most expensive items first.
+    void enableDrawProfiling(const bool& enable = true);
+
+    /// @brief   Get the add-to-display latency, by namespace
+    /// @return  std::map<std::string, LatencyStats> The latency histogram and
+    ///          the mean of each stage for each namespace (the part of the
+    ///          name before the first "::")
+    ///
+    /// Every add() is followed from the call through to the end of the draw of
+    /// the first frame with the item in it, so this is how long it takes the
+    /// data to actually show up on screen, not just how long add() takes.
+    std::map<std::string, LatencyStats> getLatencyStats() const;
+
+    /// @brief   Show the latency of each namespace in a HUD
+    /// @param   show Show or hide the HUD
+    void showLatencyHud(const bool& show = true);
+
+    /// @brief   Look for the usual performance problems in the displayed items
+    /// @return  std::shared_future<std::vector<SceneFinding>> The findings,
+    ///          most expensive first, once the analysis is done
+    ///
+    /// The same as "Analyze Scene" in the menu. The analysis runs in the
+    /// background on a snapshot of the items, locking the display for one
+    /// item at a time, so the display doesn't stall. It
+    /// looks for lots of tiny drawables (i.e. a get(const Point&) per point),
+    /// geometry split into tiny primitive sets, abuse of the transparent bin,
+    /// display lists on changing data and deep chains of single child groups
+    /// or namespaces. The items (and the namespaces above them) get a warning
+    /// icon with the estimated cost and what to use instead in the tool tip.
+    std::shared_future<std::vector<SceneFinding>> analyze();
+
+    /// @brief   Run the display on the host application's event loop
+    /// @param   parent The qt parent for the embedded display
+    /// @return  EmbeddedDisplay* The display with the widgets for the host to
+    ///          lay out, nullptr if the display thread is already running
+    ///
+    /// Applications which already run a QApplication can call this (on their
+    /// GUI thread, before anything is added) instead of having the display
+    /// thread start a second application and its own main window. All the
+    /// d3::di() calls then go to the embedded display, which is driven by a
+    /// timer on the host's event loop. blockForClose() returns right away
+    /// since the host owns the loop. The calls which change the widgets from
+    /// other threads are handed to the host's thread (the handler adds,
+    /// track(), setStyle() and setVisibleInViewport() return true once
+    /// they're queued, and getPoseHandle() and analyze() wait for the next
+    /// tick). running() reports what the widget was at the last tick, and
+    /// lock() is only the osg lock, so holding it just skips the host's
+    /// frames.
+    ///
+    /// The host owns the embedded display, like its widgets: give it a parent,
+    /// or delete it once it's done with d3::di() (and before the
+    /// QApplication goes). The display interface never deletes it.
+    EmbeddedDisplay* embed(QObject* parent = nullptr);
+
   private:
 
     /// @brief   Hidden constructor
@@ -294,6 +579,12 @@ class DisplayInterface
     /// many places and only does work if the main window is not already created
     bool setupMainWindow();
 
+    /// @brief   Add a node, followed for the latency from when it was submitted
+    bool submit(const std::string& name,
+                const osg::ref_ptr<osg::Node> node,
+                const bool& addToDisplay,
+                const int64_t& submitted_ns);
+
     /// @brief   The display loop runs in a thread
     ///
     void displayThreadLoop();
@@ -307,6 +598,9 @@ class DisplayInterface
     /// The osg widget
     QOSGWidget*                   m_pOsgWidget;
 
+    /// The embedded display, when the host runs the event loop
+    EmbeddedDisplay*              m_pEmbedded;
+
     /// The mutext to add stuff
     std::mutex                    m_mutex;
 
@@ -330,6 +624,33 @@ class DisplayInterface
 
     /// a notifier to wake us up from a paused state
     std::condition_variable       m_pauseNotifier;
+
+    /// The memory budget for the tree view
+    size_t                        m_memoryBudget;
+
+    /// Where the tree view spills evicted items
+    std::string                   m_spillDirectory;
+
+    /// The vertices a geode needs to go behind an occlusion query (0 is off)
+    size_t                        m_occlusionVertices;
+
+    /// Protect the pose handles
+    std::mutex                    m_poseMutex;
+
+    /// The handles for the items posed by name
+    std::unordered_map<std::string, PoseHandle> m_poseHandles;
+
+    /// Has the latency hud been added
+    std::atomic<bool>             m_latencyHudAdded;
+
+    /// The newest async add of a name
+    struct AsyncAdd;
+
+    /// Protect the async adds
+    std::mutex                    m_asyncMutex;
+
+    /// The newest async add of each name
+    std::unordered_map<std::string, std::shared_ptr<AsyncAdd>> m_asyncAdds;
 };
 
 } // namespace d3
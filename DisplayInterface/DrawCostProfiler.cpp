@@ -0,0 +1,373 @@
+/////////////////////////////////////////////////////////////////
+/// @file      DrawCostProfiler.cpp
+/// @author    Chris L Baker (clb) <chris@chimail.net>
+/// @date      2026.10.18
+/// @brief     Attribute the cull and draw time of a frame to the displayed
+///            items
+///
+/// @attention Copyright (C) 2026
+/// @attention All rights reserved
+/////////////////////////////////////////////////////////////////
+
+#include "DrawCostProfiler.h"
+#include "QOSGWidget.h"
+
+#include <osg/Drawable>
+#include <osg/Geode>
+#include <osg/NodeVisitor>
+#include <osg/OcclusionQueryNode>
+#include <osg/Version>
+#include <osg/buffered_value>
+#if      OSG_MIN_VERSION_REQUIRED(3,4,0)
+#include <osg/GLExtensions>
+#endif   // OSG_MIN_VERSION_REQUIRED(3,4,0)
+
+#include <algorithm>
+#include <chrono>
+
+#ifndef GL_QUERY_RESULT
+#define GL_QUERY_RESULT                 0x8866
+#endif
+#ifndef GL_QUERY_RESULT_AVAILABLE
+#define GL_QUERY_RESULT_AVAILABLE       0x8867
+#endif
+#ifndef GL_TIME_ELAPSED
+#define GL_TIME_ELAPSED                 0x88BF
+#endif
+
+namespace d3
+{
+
+namespace
+{
+
+/// @brief   The steady clock in ns
+inline int64_t now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+};
+
+#if      OSG_MIN_VERSION_REQUIRED(3,4,0)
+typedef osg::GLExtensions QueryExtensions;
+typedef GLuint64          QueryResult;
+
+inline QueryExtensions* queryExtensions(osg::RenderInfo& renderInfo)
+{
+    return renderInfo.getState()->get<osg::GLExtensions>();
+};
+
+inline bool hasTimerQuery(const QueryExtensions* ext)
+{
+    return ext && ext->isTimerQuerySupported;
+};
+#else    // OSG_MIN_VERSION_REQUIRED(3,4,0)
+typedef osg::Drawable::Extensions QueryExtensions;
+typedef GLuint64EXT               QueryResult;
+
+inline QueryExtensions* queryExtensions(osg::RenderInfo& renderInfo)
+{
+    return osg::Drawable::getExtensions(renderInfo.getContextID(), true);
+};
+
+inline bool hasTimerQuery(const QueryExtensions* ext)
+{
+    return ext && ext->isTimerQuerySupported();
+};
+#endif   // OSG_MIN_VERSION_REQUIRED(3,4,0)
+
+/////////////////////////////////////////////////////////////////
+/// @brief   Count the frames (an update operation)
+/////////////////////////////////////////////////////////////////
+class FrameCounter : public osg::Operation
+{
+  public:
+
+    FrameCounter() :
+        osg::Operation("FrameCounter", true),
+        m_frames(0)
+    {
+    };
+
+    virtual void operator()(osg::Object*) { ++m_frames; };
+
+    uint64_t frames() const { return m_frames; };
+
+  private:
+
+    std::atomic<uint64_t>    m_frames;
+};
+
+/////////////////////////////////////////////////////////////////
+/// @brief   Time the cull traversal of a subgraph
+/////////////////////////////////////////////////////////////////
+class CullTimer : public osg::NodeCallback
+{
+  public:
+
+    explicit CullTimer(DrawCost* cost) : m_cost(cost) {};
+
+    virtual void operator()(osg::Node* node, osg::NodeVisitor* nv)
+    {
+        const int64_t begin( now_ns() );
+        traverse(node, nv);
+        m_cost->addCull(now_ns() - begin);
+    };
+
+  private:
+
+    osg::ref_ptr<DrawCost>    m_cost;
+};
+
+/////////////////////////////////////////////////////////////////
+/// @brief   Time the draw of a drawable
+/////////////////////////////////////////////////////////////////
+class DrawTimer : public osg::Drawable::DrawCallback
+{
+  public:
+
+    /// The queries in flight - the results are read a few frames later
+    static const unsigned int numQueries = 4;
+
+    explicit DrawTimer(DrawCost* cost) :
+        m_cost(cost),
+        m_contexts()
+    {
+    };
+
+    /// @brief   Destructor - the queries are handed to osg to delete the next
+    ///          time each context flushes its deleted GL objects
+    virtual ~DrawTimer()
+    {
+        for ( unsigned int contextID(0) ; contextID<m_contexts.size() ; ++contextID )
+        {
+            const Queries& queries( m_contexts[contextID] );
+            if ( not queries.generated ) continue;
+            for ( unsigned int ii(0) ; ii<numQueries ; ++ii )
+                osg::QueryGeometry::deleteQueryObject(contextID, queries.ids[ii]);
+        }
+    };
+
+    virtual void drawImplementation(osg::RenderInfo& renderInfo,
+                                    const osg::Drawable* drawable) const
+    {
+        QueryExtensions* ext( queryExtensions(renderInfo) );
+        if ( not hasTimerQuery(ext) )
+        {
+            // the best we can do is the time to submit it
+            const int64_t begin( now_ns() );
+            drawable->drawImplementation(renderInfo);
+            m_cost->addDraw(now_ns() - begin);
+            return;
+        }
+
+        // query objects aren't shared between contexts (i.e. the split
+        // viewports), so each context has its own
+        m_cost->setGpuTimed();
+        Queries& queries( m_contexts[renderInfo.getContextID()] );
+        if ( not queries.generated )
+        {
+            ext->glGenQueries(numQueries, queries.ids);
+            queries.generated = true;
+        }
+
+        // collect the finished queries, oldest first
+        while ( queries.pending )
+        {
+            const unsigned int oldest( (queries.next + numQueries - queries.pending) % numQueries );
+            GLint available(0);
+            ext->glGetQueryObjectiv(queries.ids[oldest], GL_QUERY_RESULT_AVAILABLE, &available);
+            if ( not available ) break;
+
+            QueryResult elapsed(0);
+            ext->glGetQueryObjectui64v(queries.ids[oldest], GL_QUERY_RESULT, &elapsed);
+            m_cost->addDraw(static_cast<int64_t>(elapsed));
+            --queries.pending;
+        }
+
+        // every query is still in flight, so this one goes untimed
+        if ( numQueries == queries.pending )
+        {
+            drawable->drawImplementation(renderInfo);
+            return;
+        }
+
+        ext->glBeginQuery(GL_TIME_ELAPSED, queries.ids[queries.next]);
+        drawable->drawImplementation(renderInfo);
+        ext->glEndQuery(GL_TIME_ELAPSED);
+        queries.next = (queries.next + 1) % numQueries;
+        ++queries.pending;
+    };
+
+  private:
+
+    /// The queries of one context
+    struct Queries
+    {
+        Queries() : ids(), generated(false), next(0), pending(0) {};
+
+        GLuint          ids[numQueries];
+        bool            generated;
+        unsigned int    next;
+        unsigned int    pending;
+    };
+
+    osg::ref_ptr<DrawCost>                  m_cost;
+    mutable osg::buffered_object<Queries>   m_contexts;
+};
+
+/////////////////////////////////////////////////////////////////
+/// @brief   Put the draw timers on (or take them off) the drawables of a
+///          subgraph
+/////////////////////////////////////////////////////////////////
+class DrawTimerVisitor : public osg::NodeVisitor
+{
+  public:
+
+    /// @param   cost The cost to time into, nullptr to take the timers off
+    explicit DrawTimerVisitor(DrawCost* cost) :
+        osg::NodeVisitor(osg::NodeVisitor::TRAVERSE_ALL_CHILDREN),
+        m_cost(cost)
+    {
+    };
+
+    virtual void apply(osg::Geode& geode)
+    {
+        for ( unsigned int ii(0) ; ii<geode.getNumDrawables() ; ++ii )
+        {
+            osg::Drawable* drawable( geode.getDrawable(ii) );
+            DrawTimer* timer( dynamic_cast<DrawTimer*>(drawable->getDrawCallback()) );
+            if ( m_cost && (nullptr == drawable->getDrawCallback()) )
+                drawable->setDrawCallback(new DrawTimer(m_cost));
+            else if ( (nullptr == m_cost) && timer )
+                drawable->setDrawCallback(nullptr);
+        }
+        traverse(geode);
+    };
+
+  private:
+
+    DrawCost*    m_cost;
+};
+
+} // namespace
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+DrawCost::DrawCost() :
+    m_cull(0),
+    m_draw(0),
+    m_cullBuckets(),
+    m_drawBuckets(),
+    m_bucket(0),
+    m_windowCull(0),
+    m_windowDraw(0),
+    m_gpuTimed(false)
+{
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void DrawCost::roll()
+{
+    m_bucket = (m_bucket + 1) % windowBuckets;
+    m_windowCull -= m_cullBuckets[m_bucket];
+    m_windowDraw -= m_drawBuckets[m_bucket];
+    m_cullBuckets[m_bucket] = m_cull.exchange(0, std::memory_order_relaxed);
+    m_drawBuckets[m_bucket] = m_draw.exchange(0, std::memory_order_relaxed);
+    m_windowCull += m_cullBuckets[m_bucket];
+    m_windowDraw += m_drawBuckets[m_bucket];
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+DrawCostProfiler::DrawCostProfiler(QOSGWidget* widget) :
+    m_pWidget(widget),
+    m_frameCounter(new FrameCounter()),
+    m_frameBuckets(),
+    m_bucket(0),
+    m_lastFrames(0),
+    m_windowFrames(0),
+    m_measured()
+{
+    m_pWidget->addUpdateOperation(m_frameCounter);
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+DrawCostProfiler::~DrawCostProfiler()
+{
+    m_pWidget->lock();
+    for ( auto& measured : m_measured )
+        detach(measured.second);
+    m_pWidget->unlock();
+    m_pWidget->removeUpdateOperation(m_frameCounter);
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+DrawCostProfiler::Cost DrawCostProfiler::measure(const void* key,
+                                                 osg::Node* node)
+{
+    m_pWidget->lock();
+    Measured& measured( m_measured[key] );
+    if ( measured.node.get() != node )
+    {
+        detach(measured);
+        measured.node = node;
+        measured.cost = new DrawCost();
+        measured.cullTimer = new CullTimer(measured.cost);
+        node->addCullCallback(measured.cullTimer);
+    }
+
+    // catch any drawables added since last time
+    DrawTimerVisitor visitor(measured.cost);
+    node->accept(visitor);
+    m_pWidget->unlock();
+
+    const double frames( std::max<uint64_t>(1, m_windowFrames) );
+    return Cost{ measured.cost->getCull() / frames / 1e6,
+                 measured.cost->getDraw() / frames / 1e6,
+                 measured.cost->isGpuTimed() };
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void DrawCostProfiler::roll()
+{
+    const uint64_t frames( static_cast<FrameCounter*>(m_frameCounter.get())->frames() );
+    m_bucket = (m_bucket + 1) % DrawCost::windowBuckets;
+    m_windowFrames -= m_frameBuckets[m_bucket];
+    m_frameBuckets[m_bucket] = frames - m_lastFrames;
+    m_windowFrames += m_frameBuckets[m_bucket];
+    m_lastFrames = frames;
+
+    for ( auto itt(m_measured.begin()) ; itt != m_measured.end() ; )
+    {
+        if ( not itt->second.node.valid() )
+        {
+            itt = m_measured.erase(itt);
+            continue;
+        }
+        itt->second.cost->roll();
+        ++itt;
+    }
+};
+
+/////////////////////////////////////////////////////////////////
+///////////////////// PRIVATES /////////////////////////////////
+///////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void DrawCostProfiler::detach(Measured& measured)
+{
+    osg::ref_ptr<osg::Node> node;
+    if ( not measured.node.lock(node) ) return;
+
+    node->removeCullCallback(measured.cullTimer);
+    DrawTimerVisitor visitor(nullptr);
+    node->accept(visitor);
+};
+
+} // namespace d3
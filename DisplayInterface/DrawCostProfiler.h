@@ -0,0 +1,160 @@
+/////////////////////////////////////////////////////////////////
+/// @file      DrawCostProfiler.h
+/// @author    Chris L Baker (clb) <chris@chimail.net>
+/// @date      2026.10.18
+/// @brief     Attribute the cull and draw time of a frame to the displayed
+///            items
+///
+/// @attention Copyright (C) 2026
+/// @attention All rights reserved
+/////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <osg/Node>
+#include <osg/observer_ptr>
+#include <osg/OperationThread>
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+
+namespace d3
+{
+
+class QOSGWidget;
+
+/////////////////////////////////////////////////////////////////
+/// @brief   The measured cost of one subgraph
+///
+/// The callbacks add to the current bucket from the render thread, and roll()
+/// moves it into a ring of buckets, so the cost is averaged over a sliding
+/// window.
+/////////////////////////////////////////////////////////////////
+class DrawCost : public osg::Referenced
+{
+  public:
+
+    /// The number of buckets in the window
+    static const unsigned int windowBuckets = 8;
+
+    /// @brief   Constructor
+    DrawCost();
+
+    /// @{
+    /// @name    Add some time to the current bucket (from any thread)
+    void addCull(const int64_t& ns) { m_cull.fetch_add(ns, std::memory_order_relaxed); };
+    void addDraw(const int64_t& ns) { m_draw.fetch_add(ns, std::memory_order_relaxed); };
+    /// @}
+
+    /// @brief   Note that the draw time came from GPU timer queries
+    void setGpuTimed() { m_gpuTimed = true; };
+
+    /// @brief   Did the draw time come from GPU timer queries
+    bool isGpuTimed() const { return m_gpuTimed; };
+
+    /// @brief   Move the current bucket into the window
+    void roll();
+
+    /// @{
+    /// @name    The time over the window (ns)
+    int64_t getCull() const { return m_windowCull; };
+    int64_t getDraw() const { return m_windowDraw; };
+    /// @}
+
+  private:
+
+    /// The current bucket
+    std::atomic<int64_t>    m_cull;
+    std::atomic<int64_t>    m_draw;
+
+    /// The ring of buckets
+    int64_t                 m_cullBuckets[windowBuckets];
+    int64_t                 m_drawBuckets[windowBuckets];
+    unsigned int            m_bucket;
+
+    /// The sums over the ring
+    int64_t                 m_windowCull;
+    int64_t                 m_windowDraw;
+
+    /// Did the draw time come from GPU timer queries
+    std::atomic<bool>       m_gpuTimed;
+};
+
+/////////////////////////////////////////////////////////////////
+/// @brief   Time the cull and draw of subgraphs
+///
+/// Each measured subgraph gets a cull callback which times its cull traversal
+/// on the CPU, and each drawable in it gets a draw callback. The draw
+/// callbacks use GPU timer queries (read back a few frames later, so they
+/// never stall the pipeline) when the context has them, otherwise they time
+/// the submission on the CPU. Drawables which already have a draw callback are
+/// left alone. Removing the profiler takes all the callbacks back out.
+/////////////////////////////////////////////////////////////////
+class DrawCostProfiler
+{
+  public:
+
+    /// @brief   A cost per frame over the window
+    struct Cost
+    {
+        double    cull_ms;
+        double    draw_ms;
+        bool      gpu;
+        double total_ms() const { return cull_ms + draw_ms; };
+    };
+
+    /// @{
+    /// @name Noncopyable
+    DrawCostProfiler(const DrawCostProfiler&) = delete;
+    DrawCostProfiler& operator=(const DrawCostProfiler&) = delete;
+    /// @}
+
+    /// @brief   Constructor
+    /// @param   widget The widget drawing the scene (to count the frames)
+    explicit DrawCostProfiler(QOSGWidget* widget);
+
+    /// @brief   Destructor - removes all the callbacks
+    ~DrawCostProfiler();
+
+    /// @brief   Measure a subgraph
+    /// @param   key Who the subgraph belongs to (i.e. a tree view item)
+    /// @param   node The subgraph - when a key's node changes, the old one is
+    ///          no longer measured
+    /// @return  Cost The cost of the subgraph per frame over the window
+    Cost measure(const void* key,
+                 osg::Node* node);
+
+    /// @brief   Move the current costs into the window
+    void roll();
+
+  private:
+
+    /// The callbacks for a subgraph
+    struct Measured
+    {
+        osg::observer_ptr<osg::Node>        node;
+        osg::ref_ptr<DrawCost>              cost;
+        osg::ref_ptr<osg::NodeCallback>     cullTimer;
+    };
+
+    /// @brief   Take the callbacks back out of a subgraph
+    static void detach(Measured& measured);
+
+    /// The widget drawing the scene
+    QOSGWidget*                               m_pWidget;
+
+    /// Counts the frames
+    osg::ref_ptr<osg::Operation>              m_frameCounter;
+
+    /// The frames in each bucket of the window
+    uint64_t                                  m_frameBuckets[DrawCost::windowBuckets];
+    unsigned int                              m_bucket;
+    uint64_t                                  m_lastFrames;
+    uint64_t                                  m_windowFrames;
+
+    /// The measured subgraphs
+    std::map<const void*, Measured>           m_measured;
+};
+
+} // namespace d3
@@ -0,0 +1,152 @@
+/////////////////////////////////////////////////////////////////
+/// @file      EmbeddedDisplay.cpp
+/// @author    Chris L Baker (clb) <chris@chimail.net>
+/// @date      2026.10.18
+/// @brief     Run the display on the event loop of a host Qt application
+///
+/// @attention Copyright (C) 2026
+/// @attention All rights reserved
+/////////////////////////////////////////////////////////////////
+
+#include "EmbeddedDisplay.h"
+#include "QOSGWidget.h"
+#include "StallWatchdog.h"
+#include "TreeView.h"
+
+#include <QtCore/QThread>
+
+#include <memory>
+
+namespace d3
+{
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+EmbeddedDisplay::EmbeddedDisplay(QObject* parent /* = nullptr */,
+                                 const int& frameInterval_ms /* = 33 */) :
+    QObject(parent),
+    m_pOsgWidget(new QOSGWidget()),
+    m_pTreeView(new TreeView()),
+    m_mutex(),
+    m_queue(),
+    m_timer(),
+    m_shown(false)
+{
+    m_pOsgWidget->initialize();
+    m_pTreeView->setOsgWidget(m_pOsgWidget);
+
+    // render on the host's loop
+    connect(&m_timer, SIGNAL(timeout()), this, SLOT(tick()));
+    m_timer.setInterval(frameInterval_ms);
+    m_timer.start();
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+EmbeddedDisplay::~EmbeddedDisplay()
+{
+    m_timer.stop();
+
+    if ( m_pTreeView && (nullptr == m_pTreeView->parent()) ) delete m_pTreeView;
+    if ( m_pOsgWidget && (nullptr == m_pOsgWidget->parent()) ) delete m_pOsgWidget;
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+bool EmbeddedDisplay::add(const std::string& name,
+                          const osg::ref_ptr<osg::Node> node,
+                          const bool& addToDisplay /* = true */,
+                          const int64_t& submitted_ns /* = 0 */)
+{
+    const int64_t submitted( submitted_ns ? submitted_ns : LatencyTracker::now_ns() );
+
+    if ( onGuiThread() )
+        return apply(name, node, addToDisplay, submitted);
+
+    post([this, name, node, addToDisplay, submitted]()
+         {
+             apply(name, node, addToDisplay, submitted);
+         });
+    return true;
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+bool EmbeddedDisplay::addDeferred(const std::string& name,
+                                  std::function<osg::ref_ptr<osg::Node>()>&& builder,
+                                  const bool& addToDisplay /* = true */)
+{
+    static const bool showNode(true);
+
+    if ( onGuiThread() )
+        return m_pTreeView && m_pTreeView->addDeferred(name, std::move(builder), showNode, addToDisplay);
+
+    std::shared_ptr<std::function<osg::ref_ptr<osg::Node>()>> shared(
+        std::make_shared<std::function<osg::ref_ptr<osg::Node>()>>(std::move(builder)) );
+    post([this, name, shared, addToDisplay]()
+         {
+             if ( m_pTreeView ) m_pTreeView->addDeferred(name, std::move(*shared), showNode, addToDisplay);
+         });
+    return true;
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void EmbeddedDisplay::post(std::function<void()>&& func)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_queue.push_back(std::move(func));
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+bool EmbeddedDisplay::onGuiThread() const
+{
+    return QThread::currentThread() == thread();
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////// SLOTS //////////////////////////////////////////
+///////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void EmbeddedDisplay::tick()
+{
+    watchdog().beat();
+
+    // take the queued work, so the other threads can keep queueing
+    std::vector<std::function<void()>> queue;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        queue.swap(m_queue);
+    }
+    for ( auto& func : queue )
+        func();
+
+    m_shown = m_pOsgWidget && m_pOsgWidget->isVisible();
+
+    // render - the osg lock is only contended if someone used di().lock()
+    if ( m_shown && m_pOsgWidget->try_lock() )
+    {
+        m_pOsgWidget->updateGL();
+        m_pOsgWidget->unlock();
+    }
+};
+
+/////////////////////////////////////////////////////////////////
+///////////////////// PRIVATES /////////////////////////////////
+///////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+bool EmbeddedDisplay::apply(const std::string& name,
+                            const osg::ref_ptr<osg::Node> node,
+                            const bool& addToDisplay,
+                            const int64_t& submitted_ns)
+{
+    static const bool showNode(true);
+    return m_pTreeView && m_pTreeView->submit(name, node, showNode, addToDisplay, submitted_ns);
+};
+
+} // namespace d3
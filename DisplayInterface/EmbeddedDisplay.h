@@ -0,0 +1,165 @@
+/////////////////////////////////////////////////////////////////
+/// @file      EmbeddedDisplay.h
+/// @author    Chris L Baker (clb) <chris@chimail.net>
+/// @date      2026.10.18
+/// @brief     Run the display on the event loop of a host Qt application
+///
+/// @attention Copyright (C) 2026
+/// @attention All rights reserved
+/////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <QtCore/QObject>
+#include <QtCore/QPointer>
+#include <QtCore/QTimer>
+
+#include <osg/Node>
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <string>
+#include <vector>
+
+namespace d3
+{
+
+class QOSGWidget;
+class TreeView;
+
+/////////////////////////////////////////////////////////////////
+/// @brief   A QOSGWidget and TreeView pair driven by the host's event loop
+///
+/// Applications which already run a QApplication don't need the display thread
+/// (and the second QApplication it polls every 10 ms). Instead, the host puts
+/// these two widgets where it wants them, and a timer on the host's event loop
+/// renders the frames. Adds from other threads are queued and handed to the
+/// tree view on the next tick, so nothing has to lock against the host.
+///
+/// This is normally created through DisplayInterface::embed(), so all the
+/// d3::di() calls in the rest of the code end up here:
+/// @code
+/// QApplication app(argc, argv);
+/// d3::EmbeddedDisplay* display( d3::di().embed() );
+/// layout->addWidget(display->getOsgWidget());
+/// dock->setWidget(display->getTreeView());
+/// @endcode
+/////////////////////////////////////////////////////////////////
+class EmbeddedDisplay : public QObject
+{
+    /// standard q-craziness
+    Q_OBJECT;
+
+  public:
+
+    /// @brief   Constructor - must be called on the host's GUI thread
+    /// @param   parent The qt parent of this object
+    /// @param   frameInterval_ms The time between rendered frames
+    explicit EmbeddedDisplay(QObject* parent = nullptr,
+                             const int& frameInterval_ms = 33);
+
+    /// @brief   Destructor
+    ///
+    /// The widgets belong to whatever the host put them in, so they are only
+    /// deleted here if the host never took them.
+    virtual ~EmbeddedDisplay();
+
+    /// @brief   Access to the osg widget for the host to lay out
+    QOSGWidget* getOsgWidget() const { return m_pOsgWidget; };
+
+    /// @brief   Access to the tree view for the host to lay out
+    TreeView* getTreeView() const { return m_pTreeView; };
+
+    /// @brief   Add stuff to the display
+    /// @param   name The name of the item in the tree view
+    /// @param   node The osg node we are adding
+    /// @param   addToDisplay Should we add this node to the display?
+    /// @param   submitted_ns When the add was submitted, for the latency
+    ///          stats (0 means now)
+    /// @return  boolean True implies success (or, from another thread, that
+    ///          the add was queued)
+    ///
+    /// Adds from the GUI thread go straight to the tree view, adds from other
+    /// threads wait for the next tick.
+    bool add(const std::string& name,
+             const osg::ref_ptr<osg::Node> node,
+             const bool& addToDisplay = true,
+             const int64_t& submitted_ns = 0);
+
+    /// @brief   Add stuff which is only built once it is shown
+    /// @param   name The name of the item in the tree view
+    /// @param   builder The function which builds the node
+    /// @param   addToDisplay Should we add this node to the display?
+    /// @return  boolean True implies success (or that the add was queued)
+    bool addDeferred(const std::string& name,
+                     std::function<osg::ref_ptr<osg::Node>()>&& builder,
+                     const bool& addToDisplay = true);
+
+    /// @brief   Run something on the GUI thread at the next tick
+    /// @param   func The function to run
+    void post(std::function<void()>&& func);
+
+    /// @brief   Is this the GUI thread (the one the display belongs to)
+    bool onGuiThread() const;
+
+    /// @brief   Was the osg widget visible at the last tick (from any thread)
+    bool isShown() const { return m_shown; };
+
+    /// @brief   Run something on the GUI thread and wait for its result
+    /// @param   func The function to run
+    /// @return  The result of the function
+    ///
+    /// From the GUI thread this just runs it. From another thread it waits
+    /// for the next tick, so don't call it from there before the host's event
+    /// loop is running.
+    template <typename Func>
+    typename std::result_of<Func()>::type call(Func&& func)
+    {
+        typedef typename std::result_of<Func()>::type Result_t;
+        if ( onGuiThread() ) return func();
+
+        std::shared_ptr<std::packaged_task<Result_t()>> task
+            ( std::make_shared<std::packaged_task<Result_t()>>(std::forward<Func>(func)) );
+        std::future<Result_t> result( task->get_future() );
+        post([task]() { (*task)(); });
+        return result.get();
+    };
+
+  public Q_SLOTS:
+
+    /// @brief   Run the queued work and render a frame
+    void tick();
+
+  private:
+
+    /// @brief   Hand an add to the tree view and note it for the latency stats
+    bool apply(const std::string& name,
+               const osg::ref_ptr<osg::Node> node,
+               const bool& addToDisplay,
+               const int64_t& submitted_ns);
+
+    /// The osg widget
+    QPointer<QOSGWidget>                m_pOsgWidget;
+
+    /// The tree view
+    QPointer<TreeView>                  m_pTreeView;
+
+    /// Protect the queued work
+    std::mutex                          m_mutex;
+
+    /// The work queued from other threads
+    std::vector<std::function<void()>>  m_queue;
+
+    /// The timer to render the frames
+    QTimer                              m_timer;
+
+    /// Was the osg widget visible at the last tick
+    std::atomic<bool>                   m_shown;
+};
+
+} // namespace d3
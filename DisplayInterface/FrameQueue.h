@@ -0,0 +1,88 @@
+/////////////////////////////////////////////////////////////////
+/// @file      FrameQueue.h
+/// @author    Chris L Baker (clb) <chris@chimail.net>
+/// @date      2026.10.18
+/// @brief     A lock free queue of updates to apply in the next frame
+///
+/// @attention Copyright (C) 2026
+/// @attention All rights reserved
+/////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+namespace d3
+{
+
+/////////////////////////////////////////////////////////////////
+/// @brief   Any number of threads push, the display thread drains
+///
+/// This is a lock free stack - a push is one compare and swap, and the drain
+/// takes the whole stack with one exchange (so there is no ABA problem, since
+/// nothing is ever popped one at a time). The updates are drained newest
+/// first, which makes it easy to only apply the latest update for a target.
+/////////////////////////////////////////////////////////////////
+template <typename T>
+class FrameQueue
+{
+  public:
+
+    /// @{
+    /// @name Noncopyable
+    FrameQueue(const FrameQueue&) = delete;
+    FrameQueue& operator=(const FrameQueue&) = delete;
+    /// @}
+
+    /// @brief   Constructor
+    FrameQueue() : m_head(nullptr) {};
+
+    /// @brief   Destructor - drop anything not applied
+    ~FrameQueue() { drain([](T&){}); };
+
+    /// @brief   Queue an update (from any thread)
+    void push(T&& value)
+    {
+        Node* node( new Node{std::move(value), m_head.load(std::memory_order_relaxed)} );
+        while ( not m_head.compare_exchange_weak(node->next, node,
+                                                 std::memory_order_release,
+                                                 std::memory_order_relaxed) );
+    };
+
+    /// @brief   Take everything queued so far and hand it to func, newest first
+    /// @return  size_t The number of updates drained
+    template <typename Func>
+    size_t drain(Func&& func)
+    {
+        Node* node( m_head.exchange(nullptr, std::memory_order_acquire) );
+        size_t count(0);
+        while ( node )
+        {
+            func(node->value);
+            Node* next( node->next );
+            delete node;
+            node = next;
+            ++count;
+        }
+        return count;
+    };
+
+    /// @brief   Is there anything queued
+    bool empty() const { return nullptr == m_head.load(std::memory_order_relaxed); };
+
+  private:
+
+    /// A queued update
+    struct Node
+    {
+        T        value;
+        Node*    next;
+    };
+
+    /// The newest update
+    std::atomic<Node*>    m_head;
+};
+
+} // namespace d3
@@ -0,0 +1,200 @@
+/////////////////////////////////////////////////////////////////
+/// @file      HandlerExecution.cpp
+/// @author    Chris L Baker (clb) <chris@chimail.net>
+/// @date      2026.10.18
+/// @brief     Run the key, click and motion handlers off the render thread
+///
+/// @attention Copyright (C) 2026
+/// @attention All rights reserved
+/////////////////////////////////////////////////////////////////
+
+#include "HandlerExecution.h"
+
+#include <DDDisplayObjects/TaskScheduler.h>
+
+#include <deque>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace d3
+{
+
+namespace
+{
+
+/////////////////////////////////////////////////////////////////
+/// @brief   Runs the events of one handler one at a time on an executor
+/////////////////////////////////////////////////////////////////
+class Strand : public std::enable_shared_from_this<Strand>
+{
+  public:
+
+    Strand(const std::function<bool(const osgGA::GUIEventAdapter&)>& func,
+           const ExecutionPolicy::Executor_t& executor,
+           const bool& latestOnly) :
+        m_func(func),
+        m_executor(executor),
+        m_latestOnly(latestOnly),
+        m_mutex(),
+        m_pending(),
+        m_running(false)
+    {};
+
+    /// @brief   Queue an event (render thread)
+    void push(const osgGA::GUIEventAdapter& event)
+    {
+        osg::ref_ptr<osgGA::GUIEventAdapter> copy( new osgGA::GUIEventAdapter(event) );
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if ( m_latestOnly && not m_pending.empty() )
+                m_pending.back() = copy;
+            else
+                m_pending.push_back(copy);
+
+            if ( m_running ) return;
+            m_running = true;
+        }
+        schedule();
+    };
+
+  private:
+
+    /// @brief   Hand the next event to the executor
+    void schedule()
+    {
+        std::shared_ptr<Strand> self( shared_from_this() );
+        m_executor([self]() { self->run(); });
+    };
+
+    /// @brief   Run the next event (on the executor)
+    void run()
+    {
+        osg::ref_ptr<osgGA::GUIEventAdapter> event;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            event = m_pending.front();
+            m_pending.pop_front();
+        }
+
+        try
+        {
+            m_func(*event);
+        }
+        catch ( const std::exception& ex )
+        {
+            std::cerr << "BUMMER: A handler threw: " << ex.what() << std::endl;
+        }
+
+        // go around again (through the executor, so it stays fair)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if ( m_pending.empty() )
+            {
+                m_running = false;
+                return;
+            }
+        }
+        schedule();
+    };
+
+    /// The handler
+    std::function<bool(const osgGA::GUIEventAdapter&)>    m_func;
+
+    /// Where it runs
+    ExecutionPolicy::Executor_t                           m_executor;
+
+    /// Only run the latest event
+    bool                                                  m_latestOnly;
+
+    /// Protect the events
+    std::mutex                                            m_mutex;
+
+    /// The events waiting to run
+    std::deque<osg::ref_ptr<osgGA::GUIEventAdapter>>      m_pending;
+
+    /// Is an event with the executor
+    bool                                                  m_running;
+};
+
+} // namespace
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+ExecutionPolicy ExecutionPolicy::workerPool()
+{
+    ExecutionPolicy policy;
+    policy.where = Where::WORKER_POOL;
+    policy.executor = [](std::function<void()>&& func) { schedule(std::move(func), Priority::INTERACTIVE); };
+    return policy;
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+ExecutionPolicy ExecutionPolicy::onExecutor(Executor_t&& executor)
+{
+    ExecutionPolicy policy;
+    policy.where = Where::EXECUTOR;
+    policy.executor = std::move(executor);
+    return policy;
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+std::function<bool(const osgGA::GUIEventAdapter&)>
+dispatched(const std::function<bool(const osgGA::GUIEventAdapter&)>& func,
+           const ExecutionPolicy& policy,
+           const unsigned int& eventTypes,
+           const bool& latestOnly /* = false */)
+{
+    if ( ExecutionPolicy::Where::RENDER_THREAD == policy.where )
+        return func;
+
+    if ( not policy.executor )
+    {
+        std::cerr << "BUMMER: A handler can't run off the render thread without an executor" << std::endl;
+        return std::function<bool(const osgGA::GUIEventAdapter&)>();
+    }
+
+    // the events it isn't handed are left for the other handlers
+    const unsigned int types( policy.eventTypes ? policy.eventTypes : eventTypes );
+    std::shared_ptr<Strand> strand( std::make_shared<Strand>(func, policy.executor, latestOnly) );
+    return [strand, types](const osgGA::GUIEventAdapter& event)
+    {
+        if ( 0 == (types & static_cast<unsigned int>(event.getEventType())) ) return false;
+        strand->push(event);
+        return true;
+    };
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+PostQueue::PostQueue() :
+    osg::Operation("PostQueue", true),
+    m_queue()
+{
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void PostQueue::post(std::function<void()>&& func)
+{
+    m_queue.push(std::move(func));
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void PostQueue::operator()(osg::Object*)
+{
+    if ( m_queue.empty() ) return;
+
+    // the queue drains newest first, and these run in the order they came in
+    std::vector<std::function<void()>> posted;
+    m_queue.drain([&](std::function<void()>& func) { posted.push_back(std::move(func)); });
+    for ( auto itt(posted.rbegin()) ; posted.rend() != itt ; ++itt )
+        (*itt)();
+};
+
+} // namespace d3
@@ -0,0 +1,114 @@
+/////////////////////////////////////////////////////////////////
+/// @file      HandlerExecution.h
+/// @author    Chris L Baker (clb) <chris@chimail.net>
+/// @date      2026.10.18
+/// @brief     Run the key, click and motion handlers off the render thread
+///
+/// @attention Copyright (C) 2026
+/// @attention All rights reserved
+/////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "FrameQueue.h"
+
+#include <osg/OperationThread>
+#include <osgGA/GUIEventAdapter>
+
+#include <functional>
+
+namespace d3
+{
+
+/////////////////////////////////////////////////////////////////
+/// @brief   Where a key, click or motion handler runs
+///
+/// By default a handler runs right in the event traversal, on the render
+/// thread, so nothing is drawn until it returns. A handler which takes a while
+/// (re-running a planner step, dumping state) should run on the worker pool,
+/// or on an executor the caller owns (i.e. one which hands the work to the
+/// thread owning the planner). Those handlers get a copy of the event, and
+/// since they can't say whether they handled it before it's handed over,
+/// they're only handed the event types in eventTypes (by default, the key
+/// press for a key, the push for a button and the move for the motion). Those
+/// always count as handled, and the rest go on to the other handlers and the
+/// camera manipulator as if the handler wasn't there. The invocations of
+/// one handler never overlap - they run one at a time, in order (for a motion
+/// handler, only the latest of the queued moves is run). To change the scene
+/// from such a handler, add() as usual, or post() a function to the update
+/// traversal.
+/////////////////////////////////////////////////////////////////
+struct ExecutionPolicy
+{
+    /// Runs a function on some thread, some time soon
+    typedef std::function<void(std::function<void()>&&)> Executor_t;
+
+    /// Where the handler runs
+    enum class Where
+    {
+        RENDER_THREAD = 0, ///< In the event traversal (blocks the rendering)
+        WORKER_POOL,       ///< On the shared workers, ahead of the other work
+        EXECUTOR           ///< On the caller's executor
+    };
+
+    /// Where the handler runs
+    Where        where;
+
+    /// The caller's executor (for EXECUTOR)
+    Executor_t   executor;
+
+    /// The osgGA::GUIEventAdapter::EventType bits handed to a handler off the
+    /// render thread (0 for the usual ones for the handler)
+    unsigned int eventTypes;
+
+    /// @brief   Default to the render thread
+    ExecutionPolicy() : where(Where::RENDER_THREAD), executor(), eventTypes(0) {};
+
+    /// @{
+    /// @name    The policies
+    static ExecutionPolicy renderThread() { return ExecutionPolicy(); };
+    static ExecutionPolicy workerPool();
+    static ExecutionPolicy onExecutor(Executor_t&& executor);
+    /// @}
+};
+
+/// @brief   Wrap a handler so it runs where its policy says
+/// @param   func The handler
+/// @param   policy Where it runs
+/// @param   eventTypes The event types handed over off the render thread,
+///          unless the policy says otherwise
+/// @param   latestOnly Only run the latest of the queued events (i.e. for
+///          motion), rather than every one
+/// @return  std::function<bool(const osgGA::GUIEventAdapter&)> The handler to
+///          register - it's the handler itself for the render thread, and
+///          empty if the policy has no executor to run it on
+std::function<bool(const osgGA::GUIEventAdapter&)>
+dispatched(const std::function<bool(const osgGA::GUIEventAdapter&)>& func,
+           const ExecutionPolicy& policy,
+           const unsigned int& eventTypes,
+           const bool& latestOnly = false);
+
+/////////////////////////////////////////////////////////////////
+/// @brief   Functions posted (from any thread) to run in the next update
+///          traversal, in the order they were posted
+/////////////////////////////////////////////////////////////////
+class PostQueue : public osg::Operation
+{
+  public:
+
+    /// @brief   Constructor
+    PostQueue();
+
+    /// @brief   Queue a function (from any thread)
+    void post(std::function<void()>&& func);
+
+    /// @brief   Run the queued functions (the update traversal calls this)
+    virtual void operator()(osg::Object*);
+
+  private:
+
+    /// The queued functions
+    FrameQueue<std::function<void()>>   m_queue;
+};
+
+} // namespace d3
@@ -0,0 +1,326 @@
+/////////////////////////////////////////////////////////////////
+/// @file      LatencyTracker.cpp
+/// @author    Chris L Baker (clb) <chris@chimail.net>
+/// @date      2026.10.18
+/// @brief     Measure how long it takes an added item to show up on screen
+///
+/// @attention Copyright (C) 2026
+/// @attention All rights reserved
+/////////////////////////////////////////////////////////////////
+
+#include "LatencyTracker.h"
+
+#include <DDDisplayObjects/HeadsUpDisplay.h>
+
+#include <osg/NodeVisitor>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+namespace d3
+{
+
+namespace
+{
+
+/// How long an item can take to show up before we give up on it
+const int64_t expire_ns( int64_t(10) * 1000000000 );
+
+/// How often the HUD is written
+const int64_t hudPeriod_ns( 1000000000 );
+
+/////////////////////////////////////////////////////////////////
+/// @brief   Stamp the first cull of a node
+/////////////////////////////////////////////////////////////////
+class CullStamp : public osg::NodeCallback
+{
+  public:
+
+    CullStamp() : m_culled(0) {};
+
+    virtual void operator()(osg::Node* node, osg::NodeVisitor* nv)
+    {
+        if ( 0 == m_culled.load(std::memory_order_relaxed) )
+            m_culled.store(LatencyTracker::now_ns(), std::memory_order_relaxed);
+        traverse(node, nv);
+    };
+
+    int64_t culled() const { return m_culled.load(std::memory_order_relaxed); };
+
+  private:
+
+    std::atomic<int64_t>    m_culled;
+};
+
+/////////////////////////////////////////////////////////////////
+/// @brief   Stamp the end of the draw of a frame
+/////////////////////////////////////////////////////////////////
+class DrawStamp : public osg::Camera::DrawCallback
+{
+  public:
+
+    /// @note    The tracker holds on to this, so this can't hold on to it
+    explicit DrawStamp(LatencyTracker* tracker) : m_pTracker(tracker) {};
+
+    virtual void operator()(osg::RenderInfo&) const { m_pTracker->drawn(); };
+
+  private:
+
+    LatencyTracker*    m_pTracker;
+};
+
+/// @brief   ns to ms
+inline double ms(const int64_t& ns)
+{
+    return ns / 1e6;
+};
+
+} // namespace
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+double LatencyStats::bucketLimit_ms(const unsigned int& bucket)
+{
+    if ( bucket + 1 >= numBuckets )
+        return std::numeric_limits<double>::infinity();
+    return std::ldexp(1.0, bucket);
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+double LatencyStats::percentile_ms(const double& fraction) const
+{
+    if ( 0 == count ) return 0.0;
+
+    const double wanted( fraction * count );
+    uint64_t seen(0);
+    for ( unsigned int ii(0) ; ii<numBuckets ; ++ii )
+    {
+        seen += buckets[ii];
+        if ( seen >= wanted )
+            return std::min(bucketLimit_ms(ii), max_ms);
+    }
+    return max_ms;
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+int64_t LatencyTracker::now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+LatencyTracker::LatencyTracker() :
+    osg::Operation("LatencyTracker", true),
+    m_applied(),
+    m_pendingMutex(),
+    m_pending(),
+    m_drawCallback(new DrawStamp(this)),
+    m_statsMutex(),
+    m_stats(),
+    m_pHud(),
+    m_hudUpdated(0)
+{
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+LatencyTracker::~LatencyTracker()
+{
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void LatencyTracker::applied(const std::string& name,
+                             osg::Node* node,
+                             const int64_t& submitted_ns,
+                             const int64_t& applying_ns)
+{
+    if ( nullptr == node ) return;
+
+    Pending pending;
+    pending.ns = name.substr(0, name.find("::"));
+    pending.node = node;
+    pending.submitted = submitted_ns;
+    pending.applying = applying_ns;
+    pending.applied = now_ns();
+    pending.culled = 0;
+    pending.drawn = 0;
+    m_applied.push(std::move(pending));
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+std::map<std::string, LatencyStats> LatencyTracker::getStats() const
+{
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+
+    std::map<std::string, LatencyStats> stats;
+    for ( const auto& acc : m_stats )
+    {
+        const Accumulated& in( acc.second );
+        LatencyStats& out( stats[acc.first] );
+        const double count( std::max<uint64_t>(1, in.count) );
+
+        out.count = in.count;
+        std::copy(in.buckets, in.buckets + LatencyStats::numBuckets, out.buckets);
+        out.queue_ms = ms(in.queue) / count;
+        out.apply_ms = ms(in.apply) / count;
+        out.wait_ms  = ms(in.wait)  / count;
+        out.draw_ms  = ms(in.draw)  / count;
+        out.total_ms = out.queue_ms + out.apply_ms + out.wait_ms + out.draw_ms;
+        out.max_ms   = ms(in.max);
+    }
+    return stats;
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void LatencyTracker::reset()
+{
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    m_stats.clear();
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+osg::ref_ptr<osg::Node> LatencyTracker::getHud()
+{
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    if ( not m_pHud )
+        m_pHud.reset(new HeadsUpDisplay(1.0, 0.15, HeadsUpDisplay::Position::TOP, "Latency: waiting for items"));
+    return m_pHud->get();
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void LatencyTracker::showHud(const bool& show)
+{
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    if ( m_pHud ) m_pHud->show(show);
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void LatencyTracker::drawn()
+{
+    std::lock_guard<std::mutex> lock(m_pendingMutex);
+    if ( m_pending.empty() ) return;
+
+    const int64_t now( now_ns() );
+    for ( auto& pending : m_pending )
+    {
+        if ( pending.drawn ) continue;
+        pending.culled = static_cast<const CullStamp*>(pending.cullStamp.get())->culled();
+        if ( pending.culled ) pending.drawn = now;
+    }
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void LatencyTracker::operator()(osg::Object*)
+{
+    const int64_t now( now_ns() );
+
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+
+        // stamp the first cull of the newly applied items
+        m_applied.drain([&](Pending& pending)
+                        {
+                            osg::ref_ptr<osg::Node> node;
+                            if ( not pending.node.lock(node) ) return;
+                            pending.cullStamp = new CullStamp();
+                            node->addCullCallback(pending.cullStamp);
+                            m_pending.push_back(std::move(pending));
+                        });
+
+        // record the drawn ones and give up on the ones that never showed up
+        for ( size_t ii(0) ; ii<m_pending.size() ; )
+        {
+            Pending& pending( m_pending[ii] );
+            if ( (0 == pending.drawn) && (now - pending.applied < expire_ns) && pending.node.valid() )
+            {
+                ++ii;
+                continue;
+            }
+
+            if ( pending.drawn ) record(pending);
+
+            osg::ref_ptr<osg::Node> node;
+            if ( pending.node.lock(node) )
+                node->removeCullCallback(pending.cullStamp);
+
+            std::swap(pending, m_pending.back());
+            m_pending.pop_back();
+        }
+    }
+
+    if ( now - m_hudUpdated > hudPeriod_ns )
+    {
+        m_hudUpdated = now;
+        updateHud();
+    }
+};
+
+/////////////////////////////////////////////////////////////////
+///////////////////// PRIVATES /////////////////////////////////
+///////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void LatencyTracker::record(const Pending& pending)
+{
+    const int64_t total( pending.drawn - pending.submitted );
+    const double total_ms( ms(total) );
+    unsigned int bucket(0);
+    while ( (bucket + 1 < LatencyStats::numBuckets) && (total_ms >= LatencyStats::bucketLimit_ms(bucket)) )
+        ++bucket;
+
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    Accumulated& acc( m_stats[pending.ns] );
+    ++acc.count;
+    ++acc.buckets[bucket];
+    acc.queue += pending.applying - pending.submitted;
+    acc.apply += pending.applied - pending.applying;
+    acc.wait  += pending.culled - pending.applied;
+    acc.draw  += pending.drawn - pending.culled;
+    acc.max = std::max(acc.max, total);
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void LatencyTracker::updateHud()
+{
+    const std::map<std::string, LatencyStats> stats( getStats() );
+
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    if ( not m_pHud || not m_pHud->isShown() || stats.empty() ) return;
+
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(1);
+    for ( const auto& ns : stats )
+    {
+        const LatencyStats& st( ns.second );
+        text << ns.first << ": " << st.count << " adds"
+             << ", mean " << st.total_ms << " ms"
+             << " (queue " << st.queue_ms
+             << ", apply " << st.apply_ms
+             << ", wait " << st.wait_ms
+             << ", draw " << st.draw_ms << ")"
+             << ", p50 < " << st.percentile_ms(0.5) << " ms"
+             << ", p99 < " << st.percentile_ms(0.99) << " ms"
+             << ", max " << st.max_ms << " ms\n";
+    }
+    m_pHud->setText(text.str());
+};
+
+} // namespace d3
@@ -0,0 +1,194 @@
+/////////////////////////////////////////////////////////////////
+/// @file      LatencyTracker.h
+/// @author    Chris L Baker (clb) <chris@chimail.net>
+/// @date      2026.10.18
+/// @brief     Measure how long it takes an added item to show up on screen
+///
+/// @attention Copyright (C) 2026
+/// @attention All rights reserved
+/////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "FrameQueue.h"
+
+#include <osg/Camera>
+#include <osg/Node>
+#include <osg/observer_ptr>
+#include <osg/OperationThread>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace d3
+{
+
+class HeadsUpDisplay;
+
+/////////////////////////////////////////////////////////////////
+/// @brief   The add-to-display latency of a namespace
+///
+/// The total latency is from the add() call to the end of the draw of the
+/// first frame which had the item in it. The stages add up to the total:
+///  - queue: waiting for the display (the locks, or the host's event loop)
+///  - apply: putting the item in the tree view and the scene
+///  - wait:  waiting for the next frame to cull the item
+///  - draw:  the draw of that frame, which is where osg compiles the item's
+///           GL objects
+/////////////////////////////////////////////////////////////////
+struct LatencyStats
+{
+    /// The number of buckets in the histogram
+    static const unsigned int numBuckets = 14;
+
+    /// @brief   The upper bound of a bucket (ms) - the first bucket is under
+    ///          1 ms, each one after that doubles, and the last one holds
+    ///          everything above 4 s
+    static double bucketLimit_ms(const unsigned int& bucket);
+
+    /// @brief   The latency under which a fraction of the items showed up
+    ///          (the upper bound of the bucket, so it's conservative)
+    /// @param   fraction The fraction (i.e. 0.99 for the 99th percentile)
+    double percentile_ms(const double& fraction) const;
+
+    /// The number of items measured
+    uint64_t    count;
+
+    /// The histogram of the total latency
+    uint64_t    buckets[numBuckets];
+
+    /// @{
+    /// @name    The mean of each stage and the total (ms)
+    double      queue_ms;
+    double      apply_ms;
+    double      wait_ms;
+    double      draw_ms;
+    double      total_ms;
+    /// @}
+
+    /// The worst total latency (ms)
+    double      max_ms;
+};
+
+/////////////////////////////////////////////////////////////////
+/// @brief   Follow the added items through to the first frame they are drawn
+///
+/// The adders stamp each item with the (steady clock) time it was submitted
+/// and the time it was applied. The tracker is an update operation on the
+/// render thread: it takes the applied items from a lock free queue and puts
+/// a one shot cull callback on each, which stamps the first cull. The post
+/// draw callback of the main camera then stamps the end of that frame's draw.
+/// Items which aren't drawn within a few seconds (i.e. they start out hidden)
+/// are dropped rather than counted.
+/////////////////////////////////////////////////////////////////
+class LatencyTracker : public osg::Operation
+{
+  public:
+
+    /// @brief   The steady clock in ns
+    static int64_t now_ns();
+
+    /// @brief   Constructor
+    LatencyTracker();
+
+    /// @brief   Destructor
+    virtual ~LatencyTracker();
+
+    /// @brief   Note an item has been applied to the scene (from any thread)
+    /// @param   name The full name of the item (the namespace is the part
+    ///          before the first "::")
+    /// @param   node The node added
+    /// @param   submitted_ns When add() was called
+    /// @param   applying_ns When the display started applying it
+    void applied(const std::string& name,
+                 osg::Node* node,
+                 const int64_t& submitted_ns,
+                 const int64_t& applying_ns);
+
+    /// @brief   Get the latencies measured so far, by namespace
+    std::map<std::string, LatencyStats> getStats() const;
+
+    /// @brief   Forget the latencies measured so far
+    void reset();
+
+    /// @brief   The callback to put on the main camera as its post draw
+    ///          callback
+    osg::ref_ptr<osg::Camera::DrawCallback> getDrawCallback() const { return m_drawCallback; };
+
+    /// @brief   Get the HUD showing the latencies (created on the first call)
+    osg::ref_ptr<osg::Node> getHud();
+
+    /// @brief   Show or hide the HUD
+    void showHud(const bool& show);
+
+    /// @brief   Stamp the draw of the items culled this frame (called by the
+    ///          post draw callback)
+    void drawn();
+
+    /// @brief   The update operation
+    virtual void operator()(osg::Object*);
+
+  private:
+
+    /// An applied item on its way to the screen
+    struct Pending
+    {
+        std::string                         ns;
+        osg::observer_ptr<osg::Node>        node;
+        osg::ref_ptr<osg::NodeCallback>     cullStamp;
+        int64_t                             submitted;
+        int64_t                             applying;
+        int64_t                             applied;
+        int64_t                             culled;
+        int64_t                             drawn;
+    };
+
+    /// The latencies of a namespace
+    struct Accumulated
+    {
+        uint64_t    count;
+        uint64_t    buckets[LatencyStats::numBuckets];
+        int64_t     queue;
+        int64_t     apply;
+        int64_t     wait;
+        int64_t     draw;
+        int64_t     max;
+    };
+
+    /// @brief   Add a drawn item to the stats
+    void record(const Pending& pending);
+
+    /// @brief   Write the stats to the HUD
+    void updateHud();
+
+    /// The applied items, handed to the render thread
+    FrameQueue<Pending>                         m_applied;
+
+    /// Protect the pending items (they only see the render thread, but the
+    /// update and draw callbacks aren't guaranteed to be on the same one)
+    std::mutex                                  m_pendingMutex;
+
+    /// The items waiting to be drawn
+    std::vector<Pending>                        m_pending;
+
+    /// The post draw callback of the main camera
+    osg::ref_ptr<osg::Camera::DrawCallback>     m_drawCallback;
+
+    /// Protect the stats and the HUD
+    mutable std::mutex                          m_statsMutex;
+
+    /// The latencies by namespace
+    std::map<std::string, Accumulated>          m_stats;
+
+    /// The HUD (if anyone asked for it)
+    std::unique_ptr<HeadsUpDisplay>             m_pHud;
+
+    /// When the HUD was last written
+    int64_t                                     m_hudUpdated;
+};
+
+} // namespace d3
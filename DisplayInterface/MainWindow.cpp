@@ -25,6 +25,8 @@ namespace d3
 MainWindow::MainWindow() :
     QMainWindow(),
     m_pOsgWidget(nullptr),
+    m_pViewSplitter(nullptr),
+    m_viewports(),
     m_pTree(nullptr),
     m_pMenuBar(),
     m_timer()
@@ -101,9 +103,13 @@ void MainWindow::setOsgWidget(QOSGWidget* widget)
     // Hold the widget
     m_pOsgWidget = widget;
 
-    // Set the main splitter with this widget
+    // Set the main splitter with a splitter for the viewports, starting with
+    // this widget
     QSplitter* splitter( static_cast<QSplitter*>(centralWidget()) );
-    if ( splitter ) splitter->addWidget(widget);
+    m_pViewSplitter = new QSplitter(Qt::Horizontal);
+    m_pViewSplitter->setChildrenCollapsible(false);
+    m_pViewSplitter->addWidget(widget);
+    if ( splitter ) splitter->addWidget(m_pViewSplitter);
 
     // set the render timer
     connect(&m_timer, SIGNAL(timeout()), this, SLOT(render()));
@@ -130,6 +136,15 @@ void MainWindow::setTreeView(TreeView* treeView)
     addDockWidget(Qt::RightDockWidgetArea, dockWidget);
 };
 
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+QOSGWidget* MainWindow::getViewport(const unsigned int& index) const
+{
+    if ( 0 == index ) return m_pOsgWidget;
+    if ( index <= m_viewports.size() ) return m_viewports[index - 1];
+    return nullptr;
+};
+
 /////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////
 // bool MainWindow::add(const std::string& name,
@@ -194,6 +209,48 @@ void MainWindow::render()
     }
 };
 
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void MainWindow::splitView()
+{
+    if ( (nullptr == m_pOsgWidget) || (m_viewports.size() + 1 >= QOSGWidget::maxViewports) ) return;
+
+    // the new viewport shares the scene, context and viewer of the osg widget
+    m_pOsgWidget->lock();
+    QOSGWidget* viewport( new QOSGWidget(m_pOsgWidget) );
+    viewport->initialize();
+    viewport->setClearColor(m_pOsgWidget->getClearColor());
+    m_pOsgWidget->unlock();
+
+    m_pViewSplitter->addWidget(viewport);
+    m_viewports.push_back(viewport);
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void MainWindow::unsplitView()
+{
+    if ( m_viewports.empty() ) return;
+
+    // the viewport takes itself out of the viewer
+    delete m_viewports.back();
+    m_viewports.pop_back();
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void MainWindow::profileDrawCost(bool checked)
+{
+    if ( m_pTree ) m_pTree->setProfiling(checked);
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void MainWindow::analyzeScene()
+{
+    if ( m_pTree ) m_pTree->analyze();
+};
+
 /////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////
 void MainWindow::lock()     {        m_pOsgWidget->lock();     };
@@ -202,9 +259,9 @@ void MainWindow::unlock()   {        m_pOsgWidget->unlock();   };
 
 /////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////
-void MainWindow::setDarkClear()  { m_pOsgWidget->setClearColor(osg::Vec4(0.1, 0.1, 0.1, 1.0)); };
-void MainWindow::setLightClear() { m_pOsgWidget->setClearColor(osg::Vec4(0.5, 0.5, 0.5, 1.0)); };
-void MainWindow::setWhiteClear() { m_pOsgWidget->setClearColor(osg::Vec4(1.0, 1.0, 1.0, 1.0)); };
+void MainWindow::setDarkClear()  { setClearColor(osg::Vec4(0.1, 0.1, 0.1, 1.0)); };
+void MainWindow::setLightClear() { setClearColor(osg::Vec4(0.5, 0.5, 0.5, 1.0)); };
+void MainWindow::setWhiteClear() { setClearColor(osg::Vec4(1.0, 1.0, 1.0, 1.0)); };
 
 /////////////////////////////////////////////////////////////////
 ///////////// PRIVATES /////////////////////////////////////////
@@ -232,6 +289,31 @@ void MainWindow::buildDisplayMenu(QMenu* dspMenu)
         QWidget::connect(pAction, SIGNAL(triggered(bool)), this, SLOT(enableNodeTracking(bool)));
     }
 
+    // split the 3D area into more viewports on the same scene
+    {
+        QAction* pAction = dspMenu->addAction("Split View");
+        pAction->setShortcut(QKeySequence(Qt::CTRL + Qt::Key_Plus));
+        QWidget::connect(pAction, SIGNAL(triggered()), this, SLOT(splitView()));
+
+        QAction* pActionUnsplit = dspMenu->addAction("Unsplit View");
+        pActionUnsplit->setShortcut(QKeySequence(Qt::CTRL + Qt::Key_Minus));
+        QWidget::connect(pActionUnsplit, SIGNAL(triggered()), this, SLOT(unsplitView()));
+    }
+
+    // show what each item costs to cull and draw
+    {
+        QAction* pAction = dspMenu->addAction("Profile Draw Cost");
+        pAction->setCheckable(true);
+        pAction->setChecked(false);
+        QWidget::connect(pAction, SIGNAL(triggered(bool)), this, SLOT(profileDrawCost(bool)));
+    }
+
+    // look for the usual performance problems
+    {
+        QAction* pAction = dspMenu->addAction("Analyze Scene");
+        QWidget::connect(pAction, SIGNAL(triggered()), this, SLOT(analyzeScene()));
+    }
+
     // setup the background clear color (CC)
     {
         QAction* pActionDark = dspMenu->addAction("CC: dark");
@@ -255,4 +337,13 @@ void MainWindow::closeEvent(QCloseEvent* theEvent)
     QMainWindow::closeEvent(theEvent);
 };
 
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void MainWindow::setClearColor(const osg::Vec4& color)
+{
+    m_pOsgWidget->setClearColor(color);
+    for ( QOSGWidget* viewport : m_viewports )
+        viewport->setClearColor(color);
+};
+
 } // namespace d3
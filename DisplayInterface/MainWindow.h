@@ -18,6 +18,7 @@
 
 #include <osg/Node>
 #include <mutex>
+#include <vector>
 
 namespace d3
 {
@@ -47,6 +48,11 @@ class MainWindow : public QMainWindow
     /// @brief   Add the tree view
     void setTreeView(TreeView* treeView);
 
+    /// @brief   Get at a viewport
+    /// @param   index The index of the viewport (0 is the osg widget)
+    /// @return  QOSGWidget* The viewport, nullptr if there isn't one
+    QOSGWidget* getViewport(const unsigned int& index) const;
+
   public Q_SLOTS:
 
     /// @brief   Method to make things go full screen
@@ -61,6 +67,18 @@ class MainWindow : public QMainWindow
     /// @brief   Activate a frame render
     void render();
 
+    /// @brief   Add another viewport on the scene beside the others
+    void splitView();
+
+    /// @brief   Remove the last viewport added
+    void unsplitView();
+
+    /// @brief   Turn the per item draw cost column on or off
+    void profileDrawCost(bool checked);
+
+    /// @brief   Look for performance problems in the displayed items
+    void analyzeScene();
+
     /// @{
     /// @name    Public locking functionality
     void lock();
@@ -84,9 +102,18 @@ class MainWindow : public QMainWindow
     /// @brief   The method for window closing
     virtual void closeEvent(QCloseEvent *ev);
 
+    /// @brief   Set the clear color of all the viewports
+    void setClearColor(const osg::Vec4& color);
+
     /// The osg widget
     QOSGWidget*               m_pOsgWidget;
 
+    /// The splitter holding the viewports
+    QSplitter*                m_pViewSplitter;
+
+    /// The other viewports on the scene of the osg widget
+    std::vector<QOSGWidget*>  m_viewports;
+
     /// The tree
     TreeView*                 m_pTree;
 
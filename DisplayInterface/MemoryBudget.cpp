@@ -0,0 +1,329 @@
+/////////////////////////////////////////////////////////////////
+/// @file      MemoryBudget.cpp
+/// @author    Chris L Baker (clb) <chris@chimail.net>
+/// @date      2026.10.18
+/// @brief     Track the memory held by displayed items and evict the
+///            ones nobody is looking at
+///
+/// @attention Copyright (C) 2026
+/// @attention All rights reserved
+/////////////////////////////////////////////////////////////////
+
+#include "MemoryBudget.h"
+
+#include <osg/Geode>
+#include <osg/Geometry>
+#include <osg/NodeVisitor>
+#include <osg/Texture>
+#include <osgDB/Registry>
+
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <sstream>
+
+#include <unistd.h>
+
+namespace d3
+{
+
+namespace
+{
+
+/////////////////////////////////////////////////////////////////
+/// @brief   Visitor to add up the size of the arrays in a subgraph
+/////////////////////////////////////////////////////////////////
+class MemoryVisitor : public osg::NodeVisitor
+{
+  public:
+
+    MemoryVisitor() :
+        osg::NodeVisitor(osg::NodeVisitor::TRAVERSE_ALL_CHILDREN),
+        m_bytes(0),
+        m_counted()
+    {
+    };
+
+    virtual void apply(osg::Node& node)
+    {
+        addStateSet(node.getStateSet());
+        traverse(node);
+    };
+
+    virtual void apply(osg::Geode& geode)
+    {
+        addStateSet(geode.getStateSet());
+        for ( unsigned int ii(0) ; ii<geode.getNumDrawables() ; ++ii )
+        {
+            osg::Drawable* drawable( geode.getDrawable(ii) );
+            if ( not drawable ) continue;
+            addStateSet(drawable->getStateSet());
+
+            osg::Geometry* geometry( drawable->asGeometry() );
+            if ( not geometry ) continue;
+
+            addArray(geometry->getVertexArray());
+            addArray(geometry->getNormalArray());
+            addArray(geometry->getColorArray());
+            addArray(geometry->getSecondaryColorArray());
+            addArray(geometry->getFogCoordArray());
+            for ( unsigned int tt(0) ; tt<geometry->getNumTexCoordArrays() ; ++tt )
+                addArray(geometry->getTexCoordArray(tt));
+            for ( unsigned int aa(0) ; aa<geometry->getNumVertexAttribArrays() ; ++aa )
+                addArray(geometry->getVertexAttribArray(aa));
+
+            for ( unsigned int pp(0) ; pp<geometry->getNumPrimitiveSets() ; ++pp )
+            {
+                const osg::DrawElements* elements( geometry->getPrimitiveSet(pp)->getDrawElements() );
+                if ( elements && m_counted.insert(elements).second )
+                    m_bytes += elements->getTotalDataSize();
+            }
+        }
+        traverse(geode);
+    };
+
+    size_t bytes() const { return m_bytes; };
+
+  private:
+
+    void addArray(const osg::Array* array)
+    {
+        if ( array && m_counted.insert(array).second )
+            m_bytes += array->getTotalDataSize();
+    };
+
+    void addStateSet(const osg::StateSet* stateSet)
+    {
+        if ( not stateSet ) return;
+        for ( unsigned int unit(0) ; unit<stateSet->getTextureAttributeList().size() ; ++unit )
+        {
+            const osg::Texture* texture
+                ( dynamic_cast<const osg::Texture*>
+                  (stateSet->getTextureAttribute(unit, osg::StateAttribute::TEXTURE)) );
+            if ( not texture ) continue;
+            for ( unsigned int ii(0) ; ii<texture->getNumImages() ; ++ii )
+            {
+                const osg::Image* image( texture->getImage(ii) );
+                if ( image && m_counted.insert(image).second )
+                    m_bytes += image->getTotalSizeInBytes();
+            }
+        }
+    };
+
+    /// The running total
+    size_t                    m_bytes;
+
+    /// Things we have already counted (shared arrays and images)
+    std::set<const void*>     m_counted;
+};
+
+/////////////////////////////////////////////////////////////////
+/// @brief   Visitor to look for anything which would keep changing (or be
+///          held on to) after the subgraph is evicted
+/////////////////////////////////////////////////////////////////
+class LiveVisitor : public osg::NodeVisitor
+{
+  public:
+
+    explicit LiveVisitor(const unsigned int& ownRefs) :
+        osg::NodeVisitor(osg::NodeVisitor::TRAVERSE_ALL_CHILDREN),
+        m_ownRefs(ownRefs),
+        m_live(false)
+    {
+        // the hidden nodes are the ones we're looking at
+        setNodeMaskOverride(~0u);
+    };
+
+    virtual void apply(osg::Node& node)
+    {
+        // the root is also held by whoever asked
+        const unsigned int ownRefs( node.getNumParents() + m_ownRefs );
+        m_ownRefs = 0;
+
+        if ( node.getUpdateCallback() ||
+             (0 != node.getNumChildrenRequiringUpdateTraversal()) ||
+             isLive(node, ownRefs) ||
+             isLive(node.getStateSet()) )
+        {
+            m_live = true;
+            return;
+        }
+        traverse(node);
+    };
+
+    virtual void apply(osg::Geode& geode)
+    {
+        apply(static_cast<osg::Node&>(geode));
+        for ( unsigned int ii(0) ; not m_live && (ii<geode.getNumDrawables()) ; ++ii )
+        {
+            const osg::Drawable* drawable( geode.getDrawable(ii) );
+            if ( drawable &&
+                 (drawable->getUpdateCallback() ||
+                  isLive(*drawable, drawable->getNumParents()) ||
+                  isLive(drawable->getStateSet())) )
+                m_live = true;
+        }
+    };
+
+    bool live() const { return m_live; };
+
+  private:
+
+    /// @brief   Is something changing, or held by more than its parents
+    static bool isLive(const osg::Object& object,
+                       const unsigned int& ownRefs)
+    {
+        return (osg::Object::DYNAMIC == object.getDataVariance()) ||
+               (object.referenceCount() > static_cast<int>(ownRefs));
+    };
+
+    /// @brief   Is a state set (or a texture in it) changing
+    static bool isLive(const osg::StateSet* stateSet)
+    {
+        if ( not stateSet ) return false;
+        if ( (osg::Object::DYNAMIC == stateSet->getDataVariance()) || stateSet->getUpdateCallback() )
+            return true;
+
+        for ( unsigned int unit(0) ; unit<stateSet->getTextureAttributeList().size() ; ++unit )
+        {
+            const osg::StateAttribute* texture
+                ( stateSet->getTextureAttribute(unit, osg::StateAttribute::TEXTURE) );
+            if ( texture && (osg::Object::DYNAMIC == texture->getDataVariance()) )
+                return true;
+        }
+        return false;
+    };
+
+    /// The references to the root besides its parents
+    unsigned int              m_ownRefs;
+
+    /// Did we find anything live
+    bool                      m_live;
+};
+
+/// @brief   Get the native binary reader/writer and its options
+osgDB::ReaderWriter* binaryReaderWriter()
+{
+    return osgDB::Registry::instance()->getReaderWriterForExtension("osgb");
+};
+
+} // namespace
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+size_t estimateMemory(osg::Node* node)
+{
+    if ( not node ) return 0;
+    MemoryVisitor visitor;
+    node->accept(visitor);
+    return visitor.bytes();
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+bool isEvictable(osg::Node* node,
+                 const unsigned int& ownRefs)
+{
+    if ( not node ) return false;
+    LiveVisitor visitor(ownRefs);
+    node->accept(visitor);
+    return not visitor.live();
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+std::shared_ptr<EvictedNode> EvictedNode::evict(const osg::ref_ptr<osg::Node>& node,
+                                                const std::string& spillDirectory)
+{
+    osgDB::ReaderWriter* rw( binaryReaderWriter() );
+    if ( not node || not rw )
+        return nullptr;
+
+    // serialize the node - compressed
+    static const osg::ref_ptr<osgDB::Options> options(new osgDB::Options("Compressor=zlib"));
+    std::stringstream ss(std::ios::in | std::ios::out | std::ios::binary);
+    if ( not rw->writeNode(*node, ss, options.get()).success() )
+    {
+        std::cerr << "BUMMER: Could not serialize " << node->className()
+                  << " for eviction" << std::endl;
+        return nullptr;
+    }
+
+    std::shared_ptr<EvictedNode> evicted(new EvictedNode());
+    evicted->m_data = ss.str();
+    evicted->m_size = evicted->m_data.size();
+
+    // conditionally spill this to disk
+    if ( not spillDirectory.empty() )
+    {
+        static std::atomic<unsigned int> counter(0);
+        std::stringstream fname;
+        fname << spillDirectory << "/d3_evicted_" << getpid() << "_" << counter++ << ".osgb";
+
+        std::ofstream spill(fname.str().c_str(), std::ios::out | std::ios::binary);
+        if ( spill.write(evicted->m_data.data(), evicted->m_data.size()) )
+        {
+            evicted->m_spillFile = fname.str();
+            evicted->m_data.clear();
+            evicted->m_data.shrink_to_fit();
+        }
+        else
+        {
+            std::cerr << "BUMMER: Could not spill to " << fname.str()
+                      << " - keeping the evicted data in RAM" << std::endl;
+        }
+    }
+
+    return evicted;
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+EvictedNode::~EvictedNode()
+{
+    if ( not m_spillFile.empty() )
+        unlink(m_spillFile.c_str());
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+osg::ref_ptr<osg::Node> EvictedNode::restore() const
+{
+    osgDB::ReaderWriter* rw( binaryReaderWriter() );
+    if ( rw )
+    {
+        osgDB::ReaderWriter::ReadResult result;
+        if ( m_spillFile.empty() )
+        {
+            std::stringstream ss(m_data, std::ios::in | std::ios::binary);
+            result = rw->readNode(ss);
+        }
+        else
+        {
+            std::ifstream spill(m_spillFile.c_str(), std::ios::in | std::ios::binary);
+            result = rw->readNode(spill);
+        }
+
+        if ( result.success() && result.getNode() )
+            return result.getNode();
+    }
+
+    std::cerr << "BUMMER: Could not restore an evicted node" << std::endl;
+    return new osg::Group();
+};
+
+/////////////////////////////////////////////////////////////////
+///////////////////// PRIVATES /////////////////////////////////
+///////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+EvictedNode::EvictedNode() :
+    m_data(),
+    m_spillFile(),
+    m_size(0)
+{
+};
+
+} // namespace d3
@@ -0,0 +1,100 @@
+/////////////////////////////////////////////////////////////////
+/// @file      MemoryBudget.h
+/// @author    Chris L Baker (clb) <chris@chimail.net>
+/// @date      2026.10.18
+/// @brief     Track the memory held by displayed items and evict the
+///            ones nobody is looking at
+///
+/// @attention Copyright (C) 2026
+/// @attention All rights reserved
+/////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <osg/Node>
+
+#include <memory>
+#include <string>
+
+namespace d3
+{
+
+/// @brief   Estimate the memory held by a subgraph
+/// @param   node The root of the subgraph to measure
+/// @return  size_t The number of bytes held in vertex/color/normal/texture
+///          coordinate arrays, primitive sets and texture images
+///
+/// This is an estimate, it only counts the big stuff (the arrays) since that's
+/// what makes up the gigabytes in a long debugging session. Shared arrays are
+/// only counted once per subgraph.
+size_t estimateMemory(osg::Node* node);
+
+/// @brief   Can a subgraph be evicted and rebuilt from a serialized copy
+/// @param   node The root of the subgraph
+/// @param   ownRefs The references the caller holds to the root (besides
+///          its parents)
+/// @return  boolean False if anything in it is still live
+///
+/// A subgraph which changes itself (an update callback, like the accumulated
+/// clouds or an image still loading), is marked DYNAMIC (it's changed from
+/// outside), or is held on to by someone else would stay frozen after it's
+/// rebuilt - its owner keeps changing the old copy - and nothing would be
+/// freed anyway. Call this with the renderer locked out.
+bool isEvictable(osg::Node* node,
+                 const unsigned int& ownRefs);
+
+/////////////////////////////////////////////////////////////////
+/// @brief   Hold a compressed, serialized copy of a node that has been
+///          evicted from the scene
+///
+/// When the display runs over its memory budget, hidden items are serialized
+/// into the osg native binary format (zlib compressed when the plugin supports
+/// it) and their geometry and GL objects are released. The serialized copy is
+/// held in RAM or, if a spill directory is given, in a file on disk. The node
+/// is rebuilt from that copy when it is shown again.
+/////////////////////////////////////////////////////////////////
+class EvictedNode
+{
+  public:
+
+    /// @{
+    /// @name Noncopyable
+    EvictedNode(const EvictedNode&) = delete;
+    EvictedNode& operator=(const EvictedNode&) = delete;
+    /// @}
+
+    /// @brief   Serialize a node so it can be dropped from the scene
+    /// @param   node The node to evict
+    /// @param   spillDirectory Where to write the serialized copy - leave empty
+    ///          to keep the copy in RAM
+    /// @return  The evicted copy, or nullptr if the node could not be
+    ///          serialized (in which case it should stay resident)
+    static std::shared_ptr<EvictedNode> evict(const osg::ref_ptr<osg::Node>& node,
+                                              const std::string& spillDirectory);
+
+    /// @brief   Destructor - cleans up any spill file
+    ~EvictedNode();
+
+    /// @brief   Rebuild the node from the serialized copy
+    /// @return  The rebuilt node, or an empty group if it can't be read back
+    osg::ref_ptr<osg::Node> restore() const;
+
+    /// @brief   The number of bytes of the serialized copy
+    size_t size() const { return m_size; };
+
+  private:
+
+    /// @brief   Hidden constructor, use evict()
+    EvictedNode();
+
+    /// The serialized copy when held in RAM
+    std::string               m_data;
+
+    /// The spill file when held on disk
+    std::string               m_spillFile;
+
+    /// The size of the serialized copy
+    size_t                    m_size;
+};
+
+} // namespace d3
@@ -0,0 +1,268 @@
+/////////////////////////////////////////////////////////////////
+/// @file      OcclusionCulling.cpp
+/// @author    Chris L Baker (clb) <chris@chimail.net>
+/// @date      2026.10.18
+/// @brief     Put the heavy parts of a scene behind occlusion queries
+///
+/// @attention Copyright (C) 2026
+/// @attention All rights reserved
+/////////////////////////////////////////////////////////////////
+
+#include "OcclusionCulling.h"
+
+#include <osg/Geode>
+#include <osg/Geometry>
+#include <osg/NodeVisitor>
+#include <osg/OcclusionQueryNode>
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+namespace d3
+{
+
+namespace
+{
+
+/// The pixels of a box which have to pass for it to be visible - any at all
+const unsigned int visiblePixels(0);
+
+/// How often a hidden chunk is queried again (frames)
+const unsigned int queryFrames(3);
+
+/// @brief   The number of vertices in a geode
+size_t numVertices(const osg::Geode& geode)
+{
+    size_t count(0);
+    for ( unsigned int ii(0) ; ii<geode.getNumDrawables() ; ++ii )
+    {
+        const osg::Geometry* geometry( geode.getDrawable(ii)->asGeometry() );
+        if ( geometry && geometry->getVertexArray() )
+            count += geometry->getVertexArray()->getNumElements();
+    }
+    return count;
+};
+
+/////////////////////////////////////////////////////////////////
+/// @brief   Find the heavy geodes
+/////////////////////////////////////////////////////////////////
+class HeavyGeodes : public osg::NodeVisitor
+{
+  public:
+
+    explicit HeavyGeodes(const size_t& minVertices) :
+        osg::NodeVisitor(osg::NodeVisitor::TRAVERSE_ALL_CHILDREN),
+        geodes(),
+        dynamic(false),
+        m_minVertices(minVertices)
+    {
+        setNodeMaskOverride(~0u);
+    };
+
+    virtual void apply(osg::Node& node)
+    {
+        dynamic = dynamic || node.getUpdateCallback();
+        traverse(node);
+    };
+
+    virtual void apply(osg::Geode& geode)
+    {
+        dynamic = dynamic || geode.getUpdateCallback();
+        for ( unsigned int ii(0) ; ii<geode.getNumDrawables() ; ++ii )
+            dynamic = dynamic ||
+                geode.getDrawable(ii)->getUpdateCallback() ||
+                (osg::Object::DYNAMIC == geode.getDrawable(ii)->getDataVariance());
+
+        if ( numVertices(geode) >= m_minVertices )
+            geodes.push_back(&geode);
+    };
+
+    /// Don't look under the ones already wrapped
+    virtual void apply(osg::Group& group)
+    {
+        dynamic = dynamic || group.getUpdateCallback();
+        if ( nullptr == dynamic_cast<osg::OcclusionQueryNode*>(&group) )
+            traverse(group);
+    };
+
+    /// The heavy geodes
+    std::vector<osg::ref_ptr<osg::Geode>>    geodes;
+
+    /// Does anything in the subgraph change the geometry (then the clouds
+    /// can't be split, since the chunks would be left behind)
+    bool                                     dynamic;
+
+  private:
+
+    size_t    m_minVertices;
+};
+
+/////////////////////////////////////////////////////////////////
+/// @brief   A bounding box which doesn't come from all the vertices (the
+///          chunks share the vertex array of the whole cloud)
+/////////////////////////////////////////////////////////////////
+class ChunkBound : public osg::Drawable::ComputeBoundingBoxCallback
+{
+  public:
+
+    explicit ChunkBound(const osg::BoundingBox& box) : m_box(box) {};
+
+    virtual osg::BoundingBox computeBound(const osg::Drawable&) const { return m_box; };
+
+  private:
+
+    osg::BoundingBox    m_box;
+};
+
+/// @brief   Wrap something in a query
+osg::ref_ptr<osg::OcclusionQueryNode> query(osg::Node* node)
+{
+    osg::ref_ptr<osg::OcclusionQueryNode> oqn( new osg::OcclusionQueryNode() );
+    oqn->setVisibilityThreshold(visiblePixels);
+    oqn->setQueryFrameCount(queryFrames);
+    oqn->setDebugDisplay(false);
+    oqn->addChild(node);
+    return oqn;
+};
+
+/// @brief   Get the point indices of a single cloud of points
+/// @return  boolean True if the geode is a single cloud of points
+bool cloudIndices(const osg::Geode& geode,
+                  std::vector<unsigned int>& indices)
+{
+    if ( 1 != geode.getNumDrawables() ) return false;
+    const osg::Geometry* geometry( geode.getDrawable(0)->asGeometry() );
+    if ( (nullptr == geometry) || (1 != geometry->getNumPrimitiveSets()) ) return false;
+
+    const osg::Vec3Array* verts( dynamic_cast<const osg::Vec3Array*>(geometry->getVertexArray()) );
+    const osg::PrimitiveSet* points( geometry->getPrimitiveSet(0) );
+    if ( (nullptr == verts) || (osg::PrimitiveSet::POINTS != points->getMode()) ) return false;
+
+    indices.resize(points->getNumIndices());
+    for ( unsigned int ii(0) ; ii<indices.size() ; ++ii )
+    {
+        indices[ii] = points->index(ii);
+        if ( indices[ii] >= verts->size() ) return false;
+    }
+    return true;
+};
+
+/// @brief   Split a cloud of points into spatial chunks, each with a query
+osg::ref_ptr<osg::Group> chunked(const osg::Geode& geode,
+                                 std::vector<unsigned int>& indices,
+                                 const size_t& minVertices)
+{
+    const osg::Geometry* geometry( geode.getDrawable(0)->asGeometry() );
+    const osg::Vec3Array& verts( *static_cast<const osg::Vec3Array*>(geometry->getVertexArray()) );
+
+    osg::ref_ptr<osg::Group> chunks( new osg::Group() );
+    chunks->setStateSet(const_cast<osg::StateSet*>(geode.getStateSet()));
+
+    // split at the median of the widest axis, until the chunks are small
+    std::vector<std::pair<size_t, size_t>> todo(1, std::make_pair(size_t(0), indices.size()));
+    while ( not todo.empty() )
+    {
+        const size_t begin( todo.back().first ), end( todo.back().second );
+        todo.pop_back();
+
+        osg::BoundingBox box;
+        for ( size_t ii(begin) ; ii<end ; ++ii )
+            box.expandBy(verts[indices[ii]]);
+
+        if ( end - begin > 2 * minVertices )
+        {
+            const osg::Vec3 size( box._max - box._min );
+            const int axis( (size.x() >= size.y()) ? ((size.x() >= size.z()) ? 0 : 2)
+                                                   : ((size.y() >= size.z()) ? 1 : 2) );
+            const size_t middle( begin + (end - begin) / 2 );
+            std::nth_element(indices.begin() + begin,
+                             indices.begin() + middle,
+                             indices.begin() + end,
+                             [&](const unsigned int& aa, const unsigned int& bb)
+                             { return verts[aa][axis] < verts[bb][axis]; });
+            todo.push_back(std::make_pair(begin, middle));
+            todo.push_back(std::make_pair(middle, end));
+            continue;
+        }
+
+        // the chunk shares everything but the primitive set
+        osg::ref_ptr<osg::Geometry> chunk( new osg::Geometry(*geometry, osg::CopyOp::SHALLOW_COPY) );
+        chunk->removePrimitiveSet(0, chunk->getNumPrimitiveSets());
+        chunk->addPrimitiveSet(new osg::DrawElementsUInt(osg::PrimitiveSet::POINTS,
+                                                         indices.begin() + begin,
+                                                         indices.begin() + end));
+        chunk->setComputeBoundingBoxCallback(new ChunkBound(box));
+        chunk->dirtyBound();
+
+        osg::ref_ptr<osg::Geode> chunkGeode( new osg::Geode() );
+        chunkGeode->addDrawable(chunk);
+        chunks->addChild(query(chunkGeode));
+    }
+    return chunks;
+};
+
+/// @brief   Copy the groups above the swapped nodes, with the swaps in them
+/// @param   node The subgraph
+/// @param   swaps The swapped nodes (and what takes their place), and then
+///          every node seen so far, so a shared node is only copied once
+/// @return  osg::ref_ptr<osg::Node> The node itself if nothing under it was
+///          swapped
+osg::ref_ptr<osg::Node> swapped(osg::Node* node,
+                                std::map<const osg::Node*, osg::ref_ptr<osg::Node>>& swaps)
+{
+    const std::map<const osg::Node*, osg::ref_ptr<osg::Node>>::const_iterator found( swaps.find(node) );
+    if ( swaps.end() != found ) return found->second;
+
+    osg::ref_ptr<osg::Node> result( node );
+    osg::Group* group( node->asGroup() );
+    if ( group && (nullptr == dynamic_cast<osg::OcclusionQueryNode*>(group)) )
+    {
+        osg::ref_ptr<osg::Group> copy;
+        for ( unsigned int ii(0) ; ii<group->getNumChildren() ; ++ii )
+        {
+            const osg::ref_ptr<osg::Node> child( swapped(group->getChild(ii), swaps) );
+            if ( child == group->getChild(ii) ) continue;
+            if ( not copy ) copy = osg::clone(group, osg::CopyOp::SHALLOW_COPY);
+            copy->setChild(ii, child);
+        }
+        if ( copy ) result = copy;
+    }
+    swaps[node] = result;
+    return result;
+};
+
+} // namespace
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+osg::ref_ptr<osg::Node> occlusionCulled(const osg::ref_ptr<osg::Node>& node,
+                                        const size_t& minVertices)
+{
+    if ( (not node) || (0 == minVertices) ) return node;
+
+    HeavyGeodes heavy(minVertices);
+    node->accept(heavy);
+
+    if ( heavy.geodes.empty() ) return node;
+
+    std::map<const osg::Node*, osg::ref_ptr<osg::Node>> swaps;
+    for ( const auto& geode : heavy.geodes )
+    {
+        std::vector<unsigned int> indices;
+        osg::ref_ptr<osg::Node> culled;
+        if ( not heavy.dynamic && cloudIndices(*geode, indices) )
+            culled = chunked(*geode, indices, minVertices);
+        else
+            culled = query(geode);
+        culled->setNodeMask(geode->getNodeMask());
+        culled->setName(geode->getName());
+        swaps[geode.get()] = culled;
+    }
+
+    // the subgraph may already be displayed, so it's left alone and only the
+    // groups above the geodes are copied
+    return swapped(node.get(), swaps);
+};
+
+} // namespace d3
@@ -0,0 +1,41 @@
+/////////////////////////////////////////////////////////////////
+/// @file      OcclusionCulling.h
+/// @author    Chris L Baker (clb) <chris@chimail.net>
+/// @date      2026.10.18
+/// @brief     Put the heavy parts of a scene behind occlusion queries
+///
+/// @attention Copyright (C) 2026
+/// @attention All rights reserved
+/////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <osg/Node>
+
+#include <cstddef>
+
+namespace d3
+{
+
+/// @brief   Put the heavy parts of a subgraph behind occlusion queries
+/// @param   node The subgraph
+/// @param   minVertices How many vertices a geode needs before it's worth a
+///          query
+/// @return  osg::ref_ptr<osg::Node> The subgraph to display - the node itself
+///          if there's nothing heavy in it
+///
+/// Each heavy geode is wrapped in an osg::OcclusionQueryNode, which draws its
+/// bounding box as a query and skips the draw while the box is hidden. A
+/// single cloud of points is too big to ever be hidden as a whole, so it's
+/// split into spatial chunks of minVertices to 2 minVertices points, each with
+/// its own query (the chunks share the arrays, so it costs no more memory).
+/// The visibility is conservative and frame coherent: a chunk is drawn if a
+/// single pixel of its box passed the last query, and hidden chunks are
+/// queried again every few frames. The subgraph handed in isn't changed (it
+/// may already be displayed): the groups above the heavy geodes are shallow
+/// copies with the queries in place of the geodes, and everything else is
+/// shared.
+osg::ref_ptr<osg::Node> occlusionCulled(const osg::ref_ptr<osg::Node>& node,
+                                        const size_t& minVertices);
+
+} // namespace d3
@@ -0,0 +1,131 @@
+/////////////////////////////////////////////////////////////////
+/// @file      PoseHandle.cpp
+/// @author    Chris L Baker (clb) <chris@chimail.net>
+/// @date      2026.10.18
+/// @brief     Move displayed items by their pose alone
+///
+/// @attention Copyright (C) 2026
+/// @attention All rights reserved
+/////////////////////////////////////////////////////////////////
+
+#include "PoseHandle.h"
+
+namespace d3
+{
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+PoseSlot::PoseSlot(osg::ref_ptr<osg::MatrixTransform> transform) :
+    m_transform(transform),
+    m_poses(),
+    m_newest(0),
+    m_writing(1),
+    m_reading(2),
+    m_writeLock(),
+    m_queued(false),
+    m_next(nullptr)
+{
+    m_writeLock.clear();
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+bool PoseSlot::write(const osg::Matrixd& pose)
+{
+    while ( m_writeLock.test_and_set(std::memory_order_acquire) );
+    m_poses[m_writing] = pose;
+    m_writing = m_newest.exchange(m_writing | fresh, std::memory_order_acq_rel) & ~fresh;
+    m_writeLock.clear(std::memory_order_release);
+
+    // the first set since the last frame queues it
+    return not m_queued.exchange(true, std::memory_order_acq_rel);
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void PoseSlot::apply()
+{
+    // off the list before the pose is taken, so a set after this queues it
+    // again
+    m_queued.exchange(false, std::memory_order_acq_rel);
+    if ( 0 == (m_newest.load(std::memory_order_relaxed) & fresh) ) return;
+
+    m_reading = m_newest.exchange(m_reading, std::memory_order_acq_rel) & ~fresh;
+    m_transform->setMatrix(m_poses[m_reading]);
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+PoseQueue::PoseQueue() :
+    osg::Operation("PoseQueue", true),
+    m_head(nullptr)
+{
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+PoseQueue::~PoseQueue()
+{
+    PoseSlot* slot( m_head.exchange(nullptr, std::memory_order_acquire) );
+    while ( slot )
+    {
+        PoseSlot* next( slot->m_next );
+        slot->unref();
+        slot = next;
+    }
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void PoseQueue::push(PoseSlot* slot)
+{
+    // the list holds a reference until the slot is applied
+    slot->ref();
+    slot->m_next = m_head.load(std::memory_order_relaxed);
+    while ( not m_head.compare_exchange_weak(slot->m_next, slot,
+                                             std::memory_order_release,
+                                             std::memory_order_relaxed) );
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void PoseQueue::operator()(osg::Object*)
+{
+    PoseSlot* slot( m_head.exchange(nullptr, std::memory_order_acquire) );
+    while ( slot )
+    {
+        // the slot can be queued again once it's applied
+        PoseSlot* next( slot->m_next );
+        slot->apply();
+        slot->unref();
+        slot = next;
+    }
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+PoseHandle::PoseHandle() :
+    m_slot(),
+    m_queue()
+{
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+PoseHandle::PoseHandle(osg::ref_ptr<PoseSlot> slot,
+                       osg::ref_ptr<PoseQueue> queue) :
+    m_slot(slot),
+    m_queue(queue)
+{
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+bool PoseHandle::set(const osg::Matrixd& pose) const
+{
+    if ( not valid() ) return false;
+    if ( m_slot->write(pose) ) m_queue->push(m_slot.get());
+    return true;
+};
+
+} // namespace d3
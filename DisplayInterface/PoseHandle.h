@@ -0,0 +1,150 @@
+/////////////////////////////////////////////////////////////////
+/// @file      PoseHandle.h
+/// @author    Chris L Baker (clb) <chris@chimail.net>
+/// @date      2026.10.18
+/// @brief     Move displayed items by their pose alone
+///
+/// @attention Copyright (C) 2026
+/// @attention All rights reserved
+/////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <osg/MatrixTransform>
+#include <osg/OperationThread>
+#include <osg/Referenced>
+
+#include <atomic>
+
+namespace d3
+{
+
+/////////////////////////////////////////////////////////////////
+/// @brief   The pose of one posed item, handed from the setters to the
+///          update traversal without allocating
+///
+/// This is a triple buffer of matrices. A set writes the matrix it owns and
+/// swaps it for the newest one, and the update traversal swaps the newest one
+/// for the matrix it reads, so neither waits on the other and a set is one
+/// matrix write. Setters of the same item on different threads take turns on
+/// a spin lock (held for the write and the swap).
+/////////////////////////////////////////////////////////////////
+class PoseSlot : public osg::Referenced
+{
+  public:
+
+    /// @brief   Constructor
+    /// @param   transform The transform to move
+    explicit PoseSlot(osg::ref_ptr<osg::MatrixTransform> transform);
+
+    /// @brief   Write a new pose (from any thread)
+    /// @param   pose The new matrix for the transform
+    /// @return  boolean True if the slot has to be queued (it wasn't already)
+    bool write(const osg::Matrixd& pose);
+
+    /// @brief   Move the transform to the newest pose (the update traversal)
+    void apply();
+
+  private:
+
+    friend class PoseQueue;
+
+    /// The bit of m_newest set while its pose hasn't been applied
+    static const unsigned int fresh = 4;
+
+    /// The transform to move
+    osg::ref_ptr<osg::MatrixTransform>    m_transform;
+
+    /// The matrices
+    osg::Matrixd                          m_poses[3];
+
+    /// The matrix with the newest pose (and the fresh bit)
+    std::atomic<unsigned int>             m_newest;
+
+    /// The matrix the setters write
+    unsigned int                          m_writing;
+
+    /// The matrix the update traversal reads
+    unsigned int                          m_reading;
+
+    /// Taken by a setter while it writes
+    std::atomic_flag                      m_writeLock;
+
+    /// Is the slot on the queue's list
+    std::atomic<bool>                     m_queued;
+
+    /// The next slot on the queue's list
+    PoseSlot*                             m_next;
+};
+
+/////////////////////////////////////////////////////////////////
+/// @brief   The pose updates for the next frame
+///
+/// This runs as an update operation of the viewer, so the poses are applied
+/// in the update traversal where nothing else is looking at the transforms.
+/// The items set since the last frame are on a lock free list (each at most
+/// once, linked through the slots themselves), so a thread setting poses
+/// faster than the display draws costs one matrix write per set, and the
+/// update one matrix write per moved item.
+/////////////////////////////////////////////////////////////////
+class PoseQueue : public osg::Operation
+{
+  public:
+
+    /// @brief   Constructor
+    PoseQueue();
+
+    /// @brief   Destructor - drop anything not applied
+    virtual ~PoseQueue();
+
+    /// @brief   Queue a slot with a new pose (from any thread)
+    /// @param   slot The slot, which has just said it has to be queued
+    void push(PoseSlot* slot);
+
+    /// @brief   Apply the queued poses (the update traversal calls this)
+    virtual void operator()(osg::Object*);
+
+  private:
+
+    /// The newest queued slot
+    std::atomic<PoseSlot*>    m_head;
+};
+
+/////////////////////////////////////////////////////////////////
+/// @brief   A handle to set the pose of one displayed item
+///
+/// Get one with d3::di().getPoseHandle("name"), and hold on to it. Setting a
+/// pose through the handle doesn't look anything up or allocate, so this is
+/// the way to move thousands of items every frame.
+/////////////////////////////////////////////////////////////////
+class PoseHandle
+{
+  public:
+
+    /// @brief   Constructor for an invalid handle
+    PoseHandle();
+
+    /// @brief   Constructor
+    /// @param   slot The pose of the item
+    /// @param   queue The queue for the display
+    PoseHandle(osg::ref_ptr<PoseSlot> slot,
+               osg::ref_ptr<PoseQueue> queue);
+
+    /// @brief   Does this handle move anything
+    bool valid() const { return m_slot.valid() && m_queue.valid(); };
+
+    /// @brief   Set the pose of the item, applied in the next frame
+    /// @param   pose The matrix from the item to its parent in the tree
+    /// @return  boolean True if the handle is valid
+    bool set(const osg::Matrixd& pose) const;
+
+  private:
+
+    /// The pose of the item
+    osg::ref_ptr<PoseSlot>                m_slot;
+
+    /// The queue for the display
+    osg::ref_ptr<PoseQueue>               m_queue;
+};
+
+} // namespace d3
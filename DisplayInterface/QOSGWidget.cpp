@@ -8,6 +8,7 @@
 /////////////////////////////////////////////////////////////////
 
 #include "QOSGWidget.h"
+#include "StallWatchdog.h"
 
 #include <osg/MatrixTransform>
 #include <osgViewer/ViewerEventHandlers>
@@ -25,13 +26,70 @@
 namespace d3
 {
 
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+ViewportWindow::ViewportWindow(osg::GraphicsContext::Traits* traits,
+                               QGLWidget* widget) :
+    osgViewer::GraphicsWindowEmbedded(traits),
+    m_pWidget(widget),
+    m_minFrameTime(std::chrono::steady_clock::duration::zero()),
+    m_lastFrame(),
+    m_skipFrame(false)
+{
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void ViewportWindow::setMaxFrameRate(const double& hz)
+{
+    m_minFrameTime = (hz > 0.0) ?
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / hz)) :
+        std::chrono::steady_clock::duration::zero();
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+bool ViewportWindow::beginFrame()
+{
+    const auto now( std::chrono::steady_clock::now() );
+    m_skipFrame = (not m_pWidget->isVisible()) || (now - m_lastFrame < m_minFrameTime);
+    if ( not m_skipFrame ) m_lastFrame = now;
+    return not m_skipFrame;
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+bool ViewportWindow::makeCurrentImplementation()
+{
+    m_pWidget->makeCurrent();
+    return true;
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+bool ViewportWindow::releaseContextImplementation()
+{
+    m_pWidget->doneCurrent();
+    return true;
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void ViewportWindow::swapBuffersImplementation()
+{
+    m_pWidget->swapBuffers();
+};
+
 /////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////
 QOSGWidget::QOSGWidget(QWidget* pp) :
     QGLWidget(pp),
-    m_pGraphicsWindow(new osgViewer::GraphicsWindowEmbedded(0, 0, width(), height())),
+    m_pPrimary(nullptr),
+    m_viewportIndex(0),
+    m_pGraphicsWindow(createWindow(this, nullptr)),
     m_pEventQueue(m_pGraphicsWindow->getEventQueue()),
-    m_pOsgViewer(new osgViewer::Viewer()),
+    m_pCompositeViewer(new osgViewer::CompositeViewer()),
+    m_pOsgView(new osgViewer::View()),
 
     m_availableManipulators(),
     m_currentManipulator(),
@@ -43,10 +101,65 @@ QOSGWidget::QOSGWidget(QWidget* pp) :
     m_currentClearColor(),
 
     m_pRoot(new osg::Group()),
-    m_osgLock(),
+    m_pOsgLock(new std::recursive_mutex()),
+
+    m_pScreenshotCallback(new ScreenshotCallback(GL_BACK)),
+    m_pPostQueue(new PostQueue())
+{
+    setup();
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+QOSGWidget::QOSGWidget(QOSGWidget* primary,
+                       QWidget* pp) :
+    QGLWidget(pp, primary),
+    m_pPrimary(primary),
+    m_viewportIndex(primary->m_pCompositeViewer->getNumViews()),
+    m_pGraphicsWindow(createWindow(this, primary)),
+    m_pEventQueue(m_pGraphicsWindow->getEventQueue()),
+    m_pCompositeViewer(primary->m_pCompositeViewer),
+    m_pOsgView(new osgViewer::View()),
+
+    m_availableManipulators(),
+    m_currentManipulator(),
+
+    // the handlers are shared, so the keys and clicks work in every viewport
+    m_pMotionEventHandler(primary->m_pMotionEventHandler),
+    m_pKeypressEventHandler(primary->m_pKeypressEventHandler),
+    m_pClickEventHandler(primary->m_pClickEventHandler),
+
+    m_currentClearColor(),
+
+    m_pRoot(primary->getRootGroup()),
+    m_pOsgLock(primary->m_pOsgLock),
+
+    m_pScreenshotCallback(new ScreenshotCallback(GL_BACK)),
+    m_pPostQueue(primary->m_pPostQueue)
+{
+    setup();
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+QOSGWidget::~QOSGWidget()
+{
+    // stop rendering this viewport
+    if ( m_pPrimary )
+    {
+        lock();
+        m_pCompositeViewer->removeView(m_pOsgView);
+        unlock();
+    }
+};
 
-    m_pScreenshotCallback(new ScreenshotCallback(GL_BACK))
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void QOSGWidget::setup()
 {
+    // the graphics window swaps the buffers after the composite viewer draws
+    setAutoBufferSwap(false);
+
     // Allow this widget to get click focus (for setting focus on key events and
     // such)
     setFocusPolicy(Qt::ClickFocus);
@@ -63,12 +176,6 @@ QOSGWidget::QOSGWidget(QWidget* pp) :
     m_availableManipulators[SupportedManipulator::CUSTOM] = new osgGA::TrackballManipulator();
 };
 
-/////////////////////////////////////////////////////////////////
-/////////////////////////////////////////////////////////////////
-QOSGWidget::~QOSGWidget()
-{
-};
-
 /////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////
 void QOSGWidget::initialize()
@@ -77,14 +184,23 @@ void QOSGWidget::initialize()
     lock();
 
     // set the root
-    m_pOsgViewer->setSceneData( m_pRoot );
+    m_pOsgView->setSceneData( getRootGroup() );
 
     // set the SceneRoot to normalise normals when scaling is applied to objects.
-    m_pRoot->getOrCreateStateSet()->setMode(GL_NORMALIZE, osg::StateAttribute::ON);
+    if ( not m_pPrimary )
+        m_pRoot->getOrCreateStateSet()->setMode(GL_NORMALIZE, osg::StateAttribute::ON);
 
     // here is a simple camera
-    m_pOsgViewer->getCamera()->setViewport(new osg::Viewport(0,0,width(),height()));
-    m_pOsgViewer->getCamera()->setGraphicsContext(m_pGraphicsWindow);
+    m_pOsgView->getCamera()->setViewport(new osg::Viewport(0,0,width(),height()));
+    m_pOsgView->getCamera()->setGraphicsContext(m_pGraphicsWindow);
+
+    // draw everything but the nodes hidden in this viewport (which have only
+    // the bits of the viewports they're drawn in)
+    m_pOsgView->getCamera()->setCullMask(~viewBits | viewMask(m_viewportIndex));
+
+    // the other viewports start looking straight down
+    const osg::Vec3d homeEye( m_pPrimary ? osg::Vec3d(0,0,60) : osg::Vec3d(20,20,40) );
+    const osg::Vec3d homeUp( m_pPrimary ? osg::Vec3d(0,1,0) : osg::Vec3d(0,0,1) );
     
     // The trackball is the best!
     osg::ref_ptr<osgGA::TrackballManipulator>
@@ -92,9 +208,9 @@ void QOSGWidget::initialize()
                              (m_availableManipulators[SupportedManipulator::TRACKBALL].get()));
     if ( trackballManipulator )
     {
-        trackballManipulator->setHomePosition(osg::Vec3d(20,20,40),
+        trackballManipulator->setHomePosition(homeEye,
                                               osg::Vec3d(0,0,0),
-                                              osg::Vec3d(0,0,1));
+                                              homeUp);
         trackballManipulator->setWheelZoomFactor(-2.0 * trackballManipulator->getWheelZoomFactor());
         trackballManipulator->setMinimumDistance(0.01);
         trackballManipulator->setTrackballSize(0.75);
@@ -132,16 +248,26 @@ void QOSGWidget::initialize()
     setClearColor();
 
     // set the camera's culling mode
-    m_pOsgViewer->getCamera()->setCullingMode(m_pOsgViewer->getCamera()->getCullingMode() &
+    m_pOsgView->getCamera()->setCullingMode(m_pOsgView->getCamera()->getCullingMode() &
                                               ~osg::CullSettings::SMALL_FEATURE_CULLING);
 
     // set the screencapture callback
-    m_pOsgViewer->getCamera()->setFinalDrawCallback(m_pScreenshotCallback);
+    if ( not m_pPrimary )
+        m_pOsgView->getCamera()->setFinalDrawCallback(m_pScreenshotCallback);
 
     // add the key press event handler
-    m_pOsgViewer->getEventHandlers().push_front(m_pKeypressEventHandler);
-    m_pOsgViewer->getEventHandlers().push_front(m_pClickEventHandler);
-    m_pOsgViewer->getEventHandlers().push_front(m_pMotionEventHandler);
+    m_pOsgView->getEventHandlers().push_front(m_pKeypressEventHandler);
+    m_pOsgView->getEventHandlers().push_front(m_pClickEventHandler);
+    m_pOsgView->getEventHandlers().push_front(m_pMotionEventHandler);
+
+    // all the viewports are rendered on this thread, in one frame
+    if ( not m_pPrimary )
+        m_pCompositeViewer->setThreadingModel(osgViewer::ViewerBase::SingleThreaded);
+
+    // what the handlers (and anyone else) post runs in the update traversal
+    if ( not m_pPrimary )
+        m_pCompositeViewer->addUpdateOperation(m_pPostQueue);
+    m_pCompositeViewer->addView(m_pOsgView);
 
     // done with init, so unlock things
     unlock();
@@ -153,7 +279,7 @@ void QOSGWidget::setManipulator(const SupportedManipulator& manipSelection)
 {
     lock();
     m_currentManipulator = m_availableManipulators[manipSelection];
-    m_pOsgViewer->setCameraManipulator(m_availableManipulators[manipSelection]);
+    m_pOsgView->setCameraManipulator(m_availableManipulators[manipSelection]);
     unlock();
 };
 
@@ -172,7 +298,7 @@ void QOSGWidget::setClearColor(const osg::Vec4& color)
 {
     // set this as the clear color
     lock();
-    m_pOsgViewer->getCamera()->setClearColor(color);
+    m_pOsgView->getCamera()->setClearColor(color);
     unlock();
 
     // store the current clear color for external access
@@ -228,16 +354,72 @@ void QOSGWidget::getNormalizedWorldRay(osg::Vec3& startPoint,
     rayDirection.normalize();
 };
 
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void QOSGWidget::setRootGroup(osg::ref_ptr<osg::Group> group)
+{
+    if ( m_pPrimary )
+    {
+        m_pPrimary->setRootGroup(group);
+        return;
+    }
+
+    lock();
+    m_pRoot = group;
+    for ( unsigned int ii(0) ; ii<m_pCompositeViewer->getNumViews() ; ++ii )
+        m_pCompositeViewer->getView(ii)->setSceneData( m_pRoot );
+    unlock();
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void QOSGWidget::addUpdateOperation(osg::ref_ptr<osg::Operation> operation)
+{
+    lock();
+    m_pCompositeViewer->addUpdateOperation(operation.get());
+    unlock();
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void QOSGWidget::removeUpdateOperation(osg::ref_ptr<osg::Operation> operation)
+{
+    lock();
+    m_pCompositeViewer->removeUpdateOperation(operation.get());
+    unlock();
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void QOSGWidget::setMaxFrameRate(const double& hz)
+{
+    lock();
+    m_pGraphicsWindow->setMaxFrameRate(hz);
+    unlock();
+};
+
 /////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////
 void QOSGWidget::updateGL()
 {
+    // the widget with the scene renders all the viewports
+    if ( m_pPrimary ) return;
+
     // do the frame and update
-    if ( m_pOsgViewer && try_lock() )
+    if ( m_pCompositeViewer && try_lock() )
     {
-        makeCurrent();
-        m_pOsgViewer->frame();
-        QGLWidget::updateGL();
+        StallWatchdog::ScopedPhase phase(StallWatchdog::Phase::RENDER);
+
+        // see which viewports are due
+        bool anyDue(false);
+        for ( unsigned int ii(0) ; ii<m_pCompositeViewer->getNumViews() ; ++ii )
+        {
+            ViewportWindow* window( dynamic_cast<ViewportWindow*>
+                                    (m_pCompositeViewer->getView(ii)->getCamera()->getGraphicsContext()) );
+            if ( window && window->beginFrame() ) anyDue = true;
+        }
+
+        if ( anyDue ) m_pCompositeViewer->frame();
         unlock();
     }
 };
@@ -246,6 +428,34 @@ void QOSGWidget::updateGL()
 //////// PRIVATES //////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////
 
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void QOSGWidget::resizeGL( int ww, int hh )
+{
+    m_pEventQueue->windowResize(0, 0, ww, hh );
+    m_pGraphicsWindow->resized(0, 0, ww, hh);
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+osg::ref_ptr<ViewportWindow> QOSGWidget::createWindow(QOSGWidget* widget,
+                                                      QOSGWidget* primary)
+{
+    osg::ref_ptr<osg::GraphicsContext::Traits> traits( new osg::GraphicsContext::Traits() );
+    traits->x = 0;
+    traits->y = 0;
+    traits->width = widget->width();
+    traits->height = widget->height();
+    traits->doubleBuffer = true;
+
+    // sharing the primary's context gives us its osg context id, so the GL
+    // objects are only compiled once
+    if ( primary )
+        traits->sharedContext = primary->m_pGraphicsWindow.get();
+
+    return new ViewportWindow(traits, widget);
+};
+
 /////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////
 void QOSGWidget::mousePressEvent(QMouseEvent* qEvent)
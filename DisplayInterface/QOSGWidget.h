@@ -13,6 +13,7 @@
 #include "MotionEventHandler.h"
 #include "KeypressEventHandler.h"
 #include "ClickEventHandler.h"
+#include "HandlerExecution.h"
 
 #include <QtCore/QTimer>
 #include <QtGui/QKeyEvent>
@@ -21,19 +22,79 @@
 
 #include <osgGA/CameraManipulator>
 
-#include <osgViewer/Viewer>
+#include <osgViewer/CompositeViewer>
+#include <osgViewer/GraphicsWindow>
 #include <osg/Group>
 #include <osg/ClipPlane>
 #include <osg/ClipNode>
 #include <osgText/Text>
 
+#include <chrono>
 #include <functional>
+#include <memory>
 #include <mutex>
 
 namespace d3
 {
 
+/////////////////////////////////////////////////////////////////
+/// @brief   The graphics window for a viewport - it makes the widget's GL
+///          context current and swaps its buffers, so a composite viewer can
+///          render all the viewports in one frame
+/////////////////////////////////////////////////////////////////
+class ViewportWindow : public osgViewer::GraphicsWindowEmbedded
+{
+  public:
+
+    /// @brief   Constructor
+    /// @param   traits The traits (with the shared context, if any)
+    /// @param   widget The widget with the GL context
+    ViewportWindow(osg::GraphicsContext::Traits* traits,
+                   QGLWidget* widget);
+
+    /// @brief   Limit how often this viewport is rendered
+    /// @param   hz The most frames per second (0 for no limit)
+    void setMaxFrameRate(const double& hz);
+
+    /// @brief   Decide if this viewport gets rendered in the coming frame
+    /// @return  boolean True if it does
+    bool beginFrame();
+
+    /// @brief   Throttled viewports are invalid for a frame, which keeps the
+    ///          composite viewer from culling, drawing or swapping them
+    virtual bool valid() const { return not m_skipFrame; };
+
+    /// @{
+    /// @name    Make the widget's context current and swap its buffers
+    virtual bool makeCurrentImplementation();
+    virtual bool releaseContextImplementation();
+    virtual void swapBuffersImplementation();
+    /// @}
+
+  private:
+
+    /// The widget with the GL context
+    QGLWidget*                               m_pWidget;
+
+    /// The least time between frames
+    std::chrono::steady_clock::duration      m_minFrameTime;
+
+    /// When we last rendered
+    std::chrono::steady_clock::time_point    m_lastFrame;
+
+    /// Skip the coming frame
+    bool                                     m_skipFrame;
+};
+
 /// @brief   The osg widget to hold the scenegraph
+///
+/// The first widget owns the scene and a composite viewer. More viewports can
+/// be made from it, which share its scene, its GL objects (their GL contexts
+/// are shared, and they use the same osg context id so everything is uploaded
+/// once) and its composite viewer (so every viewport is culled on its own, but
+/// all are rendered in the same frame). Each viewport has its own camera
+/// manipulator, render rate and a bit in the node masks for hiding items in
+/// just that viewport.
 class QOSGWidget : public QGLWidget
 {
     /// Do the qt macro stuff
@@ -50,9 +111,18 @@ class QOSGWidget : public QGLWidget
         CUSTOM
     };
 
+    /// The most viewports sharing a scene - each takes a bit of the node masks
+    static const unsigned int maxViewports = 8;
+
     /// @brief   Constructor
     explicit QOSGWidget(QWidget* pp = nullptr);
 
+    /// @brief   Construct another viewport on the scene of a widget
+    /// @param   primary The widget with the scene (and the composite viewer)
+    /// @param   pp The qt parent
+    explicit QOSGWidget(QOSGWidget* primary,
+                        QWidget* pp = nullptr);
+
     /// @brief   Destructor
     virtual ~QOSGWidget();
 
@@ -83,10 +153,32 @@ class QOSGWidget : public QGLWidget
                    const osg::Vec3d up);
 
     /// @brief   Get the root osg node
-    osg::ref_ptr<osg::Group> getRootGroup() const { return m_pRoot; };
+    osg::ref_ptr<osg::Group> getRootGroup() const { return m_pPrimary ? m_pPrimary->getRootGroup() : m_pRoot; };
 
     /// @brief   Provide access to the underlying camera
-    osg::ref_ptr<osg::Camera> getCamera() const { return m_pOsgViewer->getCamera(); };
+    osg::ref_ptr<osg::Camera> getCamera() const { return m_pOsgView->getCamera(); };
+
+    /// @brief   The index of this viewport (0 for the widget with the scene)
+    const unsigned int& getViewportIndex() const { return m_viewportIndex; };
+
+    /// The node mask bits reserved for the viewports (the top maxViewports
+    /// bits). Every viewport draws the nodes with any of the other bits set,
+    /// so the node masks from setNodeMask() still work as they always have,
+    /// as long as they leave these alone.
+    static const osg::Node::NodeMask viewBits = ~0u << (32 - maxViewports);
+
+    /// @brief   The node mask bit for a viewport - a node with none of the
+    ///          bits outside viewBits is only drawn in the viewports whose
+    ///          bits are set in its node mask
+    /// @param   viewportIndex The index of the viewport
+    static osg::Node::NodeMask viewMask(const unsigned int& viewportIndex)
+    {
+        return 1u << (31 - viewportIndex);
+    };
+
+    /// @brief   Limit how often this viewport is rendered
+    /// @param   hz The most frames per second (0 for no limit)
+    void setMaxFrameRate(const double& hz);
 
     /// @brief   Get a normalized ray in world coordinates for a point clicked
     ///          in the scene.
@@ -121,12 +213,15 @@ class QOSGWidget : public QGLWidget
     void setNodeMask(osg::Node::NodeMask msk) { getCamera()->setNodeMask(msk); };
     /// @}
 
-    /// @brief   Allow to set the root group
-    inline void setRootGroup(osg::ref_ptr<osg::Group> group)
-    {
-        m_pRoot = group;
-        m_pOsgViewer->setSceneData( m_pRoot );
-    };
+    /// @brief   Allow to set the root group (for all the viewports)
+    void setRootGroup(osg::ref_ptr<osg::Group> group);
+
+    /// @brief   Run an operation in every update traversal (for all the
+    ///          viewports, before any of them are culled)
+    void addUpdateOperation(osg::ref_ptr<osg::Operation> operation);
+
+    /// @brief   Stop running an update operation
+    void removeUpdateOperation(osg::ref_ptr<osg::Operation> operation);
 
     /// @brief   Add a motion event handler
     /// @param   func The func to call for motion
@@ -159,6 +254,9 @@ class QOSGWidget : public QGLWidget
         return m_pClickEventHandler->add(button, func, description);
     };
 
+    /// @brief   Run a function in the next update traversal (from any thread)
+    inline void post(std::function<void()>&& func) { m_pPostQueue->post(std::move(func)); };
+
     /// @brief   non-const access to the manipulator
     inline osg::ref_ptr<osgGA::CameraManipulator> getManipulator() { return m_currentManipulator; };
 
@@ -169,14 +267,15 @@ class QOSGWidget : public QGLWidget
     /// @param   capture Flag to turn on/off capturing
     inline void setCapture(const bool& capture) { m_pScreenshotCallback->setCapture(capture); };
     
-    /// @brief   Update the GL for the widget
+    /// @brief   Update the GL for the widget - this renders every viewport of
+    ///          the scene (the other viewports don't need to be updated)
     virtual void updateGL();
 
     /// @{
-    /// @name    Locking and unlocking mechanisms
-    void lock()     { m_osgLock.lock();            };
-    bool try_lock() { return m_osgLock.try_lock(); };
-    void unlock()   { m_osgLock.unlock();          };
+    /// @name    Locking and unlocking mechanisms (shared by the viewports)
+    void lock()     { m_pOsgLock->lock();            };
+    bool try_lock() { return m_pOsgLock->try_lock(); };
+    void unlock()   { m_pOsgLock->unlock();          };
     /// @}
 
   private Q_SLOTS:
@@ -197,24 +296,38 @@ class QOSGWidget : public QGLWidget
     virtual void wheelEvent( QWheelEvent* theEvent );
 
     ///
-    inline virtual void resizeGL( int ww, int hh )
-    {
-        m_pEventQueue->windowResize(0, 0, ww, hh );
-        m_pGraphicsWindow->resized(0, 0, ww, hh);
-    };
+    virtual void resizeGL( int ww, int hh );
     /// @}
 
+    /// @brief   The setup shared by both constructors
+    void setup();
+
+    /// @brief   Create the graphics window for a viewport
+    /// @param   widget The viewport
+    /// @param   primary The widget with the scene (to share the context of)
+    static osg::ref_ptr<ViewportWindow> createWindow(QOSGWidget* widget,
+                                                     QOSGWidget* primary);
+
     /// @brief   Get the osg key symbol
     osgGA::GUIEventAdapter::KeySymbol toOsg(QKeyEvent *event);
 
+    /// The widget with the scene, nullptr if this is it
+    QOSGWidget*                                                         m_pPrimary;
+
+    /// The index of this viewport
+    unsigned int                                                        m_viewportIndex;
+
     /// The graphics window
-    osg::ref_ptr<osgViewer::GraphicsWindowEmbedded>                     m_pGraphicsWindow;
+    osg::ref_ptr<ViewportWindow>                                        m_pGraphicsWindow;
 
     /// Keep a pointer to the event queue
     osg::ref_ptr<osgGA::EventQueue>                                     m_pEventQueue;
 
-    /// The osg viewer
-    osg::ref_ptr<osgViewer::Viewer>                                     m_pOsgViewer;
+    /// The osg viewer for all the viewports
+    osg::ref_ptr<osgViewer::CompositeViewer>                            m_pCompositeViewer;
+
+    /// The view for this viewport
+    osg::ref_ptr<osgViewer::View>                                       m_pOsgView;
 
     /// The list of currently available manipulators
     std::map<SupportedManipulator, osg::ref_ptr<osgGA::CameraManipulator>> m_availableManipulators;
@@ -238,10 +351,13 @@ class QOSGWidget : public QGLWidget
     osg::ref_ptr<osg::Group>                                            m_pRoot;
 
     /// The mutex to allow for external locking of the osg stuff
-    std::recursive_mutex                                                m_osgLock;
+    std::shared_ptr<std::recursive_mutex>                               m_pOsgLock;
 
     /// The screencapture
     osg::ref_ptr<ScreenshotCallback>                                    m_pScreenshotCallback;
+
+    /// The functions posted to the update traversal (shared by the viewports)
+    osg::ref_ptr<PostQueue>                                             m_pPostQueue;
 };
 
 } // namespace d3
@@ -0,0 +1,218 @@
+/////////////////////////////////////////////////////////////////
+/// @file      Reclaimer.cpp
+/// @author    Chris L Baker (clb) <chris@chimail.net>
+/// @date      2026.10.18
+/// @brief     Tear down replaced and removed nodes without a hitch
+///
+/// @attention Copyright (C) 2026
+/// @attention All rights reserved
+/////////////////////////////////////////////////////////////////
+
+#include "Reclaimer.h"
+
+#include <osg/Geode>
+#include <osg/NodeVisitor>
+#include <osg/Version>
+#if      OSG_MIN_VERSION_REQUIRED(3,4,0)
+#include <osg/GLObjects>
+#endif   // OSG_MIN_VERSION_REQUIRED(3,4,0)
+
+#include <algorithm>
+#include <chrono>
+
+#include <pthread.h>
+#include <sched.h>
+
+namespace d3
+{
+
+namespace
+{
+
+/// How long without a frame before the thread takes the nodes itself
+const int64_t stale_ns( int64_t(2) * 1000000000 );
+
+/// @brief   The steady clock in ns
+inline int64_t now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+};
+
+/////////////////////////////////////////////////////////////////
+/// @brief   Collect everything with GL objects in a subgraph
+/////////////////////////////////////////////////////////////////
+class GLObjectCollector : public osg::NodeVisitor
+{
+  public:
+
+    explicit GLObjectCollector(std::vector<osg::ref_ptr<osg::Object>>& objects) :
+        osg::NodeVisitor(osg::NodeVisitor::TRAVERSE_ALL_CHILDREN),
+        m_objects(objects)
+    {
+        setNodeMaskOverride(~0u);
+    };
+
+    virtual void apply(osg::Node& node)
+    {
+        if ( node.getStateSet() ) m_objects.push_back(node.getStateSet());
+        traverse(node);
+    };
+
+    virtual void apply(osg::Geode& geode)
+    {
+        if ( geode.getStateSet() ) m_objects.push_back(geode.getStateSet());
+        for ( unsigned int ii(0) ; ii<geode.getNumDrawables() ; ++ii )
+            m_objects.push_back(geode.getDrawable(ii));
+    };
+
+  private:
+
+    std::vector<osg::ref_ptr<osg::Object>>&    m_objects;
+};
+
+} // namespace
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+Reclaimer::Reclaimer(const double& budget_ms /* = 1.0 */) :
+    osg::Camera::DrawCallback(),
+    m_budget_ns(static_cast<int64_t>(budget_ms * 1e6)),
+    m_reclaimed(),
+    m_releasing(),
+    m_lastDraw(0),
+    m_mutex(),
+    m_notify(),
+    m_free(),
+    m_thread(),
+    m_threadShouldRun(true)
+{
+    m_thread = std::thread([&]() { run(); });
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+Reclaimer::~Reclaimer()
+{
+    stop();
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void Reclaimer::reclaim(const osg::ref_ptr<osg::Node>& node)
+{
+    if ( node ) m_reclaimed.push(osg::ref_ptr<osg::Node>(node));
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void Reclaimer::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_threadShouldRun = false;
+    }
+    m_notify.notify_all();
+    if ( m_thread.joinable() )
+        m_thread.join();
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void Reclaimer::operator()(osg::RenderInfo& renderInfo) const
+{
+    const int64_t begin( now_ns() );
+    m_lastDraw.store(begin, std::memory_order_relaxed);
+
+    m_reclaimed.drain([&](osg::ref_ptr<osg::Node>& node)
+                      {
+                          m_releasing.push_back(Releasing{node, {}, 0, false});
+                      });
+
+    const int64_t deadline( begin + m_budget_ns );
+    while ( not m_releasing.empty() && (now_ns() < deadline) )
+    {
+        Releasing& releasing( m_releasing.front() );
+        if ( not releasing.collected )
+        {
+            // it's been put back in a scene, so it's not ours to tear down
+            if ( releasing.node->getNumParents() )
+            {
+                m_releasing.pop_front();
+                continue;
+            }
+
+            GLObjectCollector collector(releasing.objects);
+            releasing.node->accept(collector);
+            releasing.collected = true;
+        }
+
+        // a few objects at a time, so one huge node is spread over the frames
+        while ( (releasing.next < releasing.objects.size()) && (now_ns() < deadline) )
+            releasing.objects[releasing.next++]->releaseGLObjects(renderInfo.getState());
+
+        if ( releasing.next < releasing.objects.size() ) break;
+
+        drop(std::move(releasing));
+        m_releasing.pop_front();
+    }
+
+#if      OSG_MIN_VERSION_REQUIRED(3,4,0)
+    // delete what was released with whatever time is left
+    double available_s( std::max<int64_t>(0, deadline - now_ns()) / 1e9 );
+    if ( available_s > 0.0 )
+        osg::flushDeletedGLObjects(renderInfo.getContextID(), begin / 1e9, available_s);
+#endif   // OSG_MIN_VERSION_REQUIRED(3,4,0)
+};
+
+/////////////////////////////////////////////////////////////////
+///////////////////// PRIVATES /////////////////////////////////
+///////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void Reclaimer::drop(Releasing&& releasing) const
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_free.push_back(std::move(releasing));
+    }
+    m_notify.notify_one();
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void Reclaimer::run()
+{
+    // only free memory when nothing else wants the cpu
+#ifdef SCHED_IDLE
+    sched_param param;
+    param.sched_priority = 0;
+    pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
+#endif
+
+    while ( m_threadShouldRun )
+    {
+        std::vector<Releasing> dropping;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_notify.wait_for(lock, std::chrono::seconds(1),
+                              [&]() { return not m_free.empty() || not m_threadShouldRun; });
+            dropping.swap(m_free);
+        }
+
+        // the arrays are freed here, as the last references go
+        dropping.clear();
+
+        // nothing is being drawn, so don't wait on the render thread - the GL
+        // objects are orphaned and deleted by osg's next flush
+        if ( now_ns() - m_lastDraw.load(std::memory_order_relaxed) > stale_ns )
+            m_reclaimed.drain([](osg::ref_ptr<osg::Node>& node)
+                              {
+                                  if ( 0 == node->getNumParents() )
+                                      node->releaseGLObjects();
+                              });
+    }
+};
+
+} // namespace d3
@@ -0,0 +1,112 @@
+/////////////////////////////////////////////////////////////////
+/// @file      Reclaimer.h
+/// @author    Chris L Baker (clb) <chris@chimail.net>
+/// @date      2026.10.18
+/// @brief     Tear down replaced and removed nodes without a hitch
+///
+/// @attention Copyright (C) 2026
+/// @attention All rights reserved
+/////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "FrameQueue.h"
+
+#include <osg/Camera>
+#include <osg/Node>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace d3
+{
+
+/////////////////////////////////////////////////////////////////
+/// @brief   Release the GL objects and the memory of dropped nodes in the
+///          background
+///
+/// Dropping the last reference to a multi-million vertex node frees its
+/// arrays (and orphans its GL objects) right there, which is usually under the
+/// osg lock on the thread replacing it, and shows up as a hitch. Instead, the
+/// dropped nodes are handed here. As the initial draw callback of the main
+/// camera (where the context is current), this releases their GL objects a few
+/// drawables at a time within a budget each frame. The nodes then go to a
+/// thread at idle priority, which drops them and so frees the arrays. If no
+/// frames are being drawn (i.e. the window is hidden), that thread takes the
+/// nodes itself and leaves the GL objects to osg's next flush. A node which is
+/// back in a scene by the time its turn comes is left alone.
+/////////////////////////////////////////////////////////////////
+class Reclaimer : public osg::Camera::DrawCallback
+{
+  public:
+
+    /// @brief   Constructor - starts the thread
+    /// @param   budget_ms The time per frame to spend releasing GL objects
+    explicit Reclaimer(const double& budget_ms = 1.0);
+
+    /// @brief   Hand over a node which is no longer displayed (any thread)
+    /// @param   node The node - the caller should drop its own references
+    void reclaim(const osg::ref_ptr<osg::Node>& node);
+
+    /// @brief   Stop the thread, anything not reclaimed yet is dropped
+    void stop();
+
+    /// @brief   Release the GL objects, within the budget (render thread)
+    virtual void operator()(osg::RenderInfo& renderInfo) const;
+
+  protected:
+
+    /// @brief   Destructor
+    virtual ~Reclaimer();
+
+  private:
+
+    /// A node having its GL objects released
+    struct Releasing
+    {
+        osg::ref_ptr<osg::Node>                   node;
+        std::vector<osg::ref_ptr<osg::Object>>    objects;
+        size_t                                    next;
+        bool                                      collected;
+    };
+
+    /// @brief   Hand a node over to be dropped on the thread
+    void drop(Releasing&& releasing) const;
+
+    /// @brief   The thread dropping the nodes
+    void run();
+
+    /// The time per frame to spend releasing GL objects (ns)
+    int64_t                                 m_budget_ns;
+
+    /// The nodes handed over
+    mutable FrameQueue<osg::ref_ptr<osg::Node>> m_reclaimed;
+
+    /// The nodes having their GL objects released (render thread)
+    mutable std::deque<Releasing>           m_releasing;
+
+    /// When the last frame was drawn (steady clock ns)
+    mutable std::atomic<int64_t>            m_lastDraw;
+
+    /// Protect the nodes to drop
+    mutable std::mutex                      m_mutex;
+
+    /// Wake the thread up
+    mutable std::condition_variable         m_notify;
+
+    /// The nodes to drop
+    mutable std::vector<Releasing>          m_free;
+
+    /// The thread
+    std::thread                             m_thread;
+
+    /// Flag for the thread
+    std::atomic<bool>                       m_threadShouldRun;
+};
+
+} // namespace d3
@@ -0,0 +1,251 @@
+/////////////////////////////////////////////////////////////////
+/// @file      SceneAnalyzer.cpp
+/// @author    Chris L Baker (clb) <chris@chimail.net>
+/// @date      2026.10.18
+/// @brief     Look for the usual ways a scene gets slow
+///
+/// @attention Copyright (C) 2026
+/// @attention All rights reserved
+/////////////////////////////////////////////////////////////////
+
+#include "SceneAnalyzer.h"
+
+#include <osg/Geode>
+#include <osg/Geometry>
+#include <osg/NodeVisitor>
+
+#include <algorithm>
+#include <sstream>
+
+namespace d3
+{
+
+namespace
+{
+
+/// @{
+/// @name    Rough costs for the estimates (ms)
+const double drawCall_ms(0.005);
+const double primitiveSet_ms(0.001);
+const double depthSort_ms(0.002);
+const double cullNode_ms(0.0005);
+const double compileVertex_ms(0.00005);
+/// @}
+
+/// @{
+/// @name    When something is worth mentioning
+const size_t tinyVertices(4);
+const size_t tinyDrawablesFound(100);
+const size_t tinyIndices(6);
+const size_t fragmentedSets(64);
+const size_t fragmentedSetsFound(256);
+const size_t transparentFound(64);
+const size_t chainFound(6);
+const size_t namespaceChainFound(4);
+/// @}
+
+/////////////////////////////////////////////////////////////////
+/// @brief   Count the anti-patterns in a subgraph (read only)
+/////////////////////////////////////////////////////////////////
+class PatternVisitor : public osg::NodeVisitor
+{
+  public:
+
+    PatternVisitor() :
+        osg::NodeVisitor(osg::NodeVisitor::TRAVERSE_ALL_CHILDREN),
+        patterns{0, 0, 0, 0, 0, 0, 0, 0, 0},
+        m_transparent(false),
+        m_chain(0)
+    {
+        // hidden parts are still worth knowing about
+        setNodeMaskOverride(~0u);
+    };
+
+    virtual void apply(osg::Node& node)
+    {
+        const bool transparent( m_transparent );
+        m_transparent = m_transparent || isTransparent(node.getStateSet());
+        traverse(node);
+        m_transparent = transparent;
+    };
+
+    virtual void apply(osg::Group& group)
+    {
+        const bool transparent( m_transparent );
+        m_transparent = m_transparent || isTransparent(group.getStateSet());
+
+        // count the chain of single child groups we are in
+        const size_t chain( m_chain );
+        m_chain = (1 == group.getNumChildren()) ? m_chain + 1 : 0;
+        patterns.longestChain = std::max(patterns.longestChain, m_chain);
+
+        traverse(group);
+
+        m_chain = chain;
+        m_transparent = transparent;
+    };
+
+    virtual void apply(osg::Geode& geode)
+    {
+        const bool transparent( m_transparent || isTransparent(geode.getStateSet()) );
+        for ( unsigned int ii(0) ; ii<geode.getNumDrawables() ; ++ii )
+            check(geode.getDrawable(ii), transparent);
+    };
+
+    /// What was counted
+    ScenePatterns    patterns;
+
+  private:
+
+    /// @brief   Does a state set put things in the depth sorted bin
+    static bool isTransparent(const osg::StateSet* stateSet)
+    {
+        return stateSet &&
+            ( (osg::StateSet::TRANSPARENT_BIN == stateSet->getRenderingHint()) ||
+              ("DepthSortedBin" == stateSet->getBinName()) );
+    };
+
+    /// @brief   Look at a drawable
+    void check(const osg::Drawable* drawable,
+               bool transparent)
+    {
+        if ( nullptr == drawable ) return;
+        if ( transparent || isTransparent(drawable->getStateSet()) )
+            ++patterns.transparentDrawables;
+
+        const osg::Geometry* geometry( dynamic_cast<const osg::Geometry*>(drawable) );
+        if ( nullptr == geometry ) return;
+
+        const osg::Array* vertices( geometry->getVertexArray() );
+        const size_t numVertices( vertices ? vertices->getNumElements() : 0 );
+
+        // tiny drawables - the draw call is the cost, not the vertices
+        if ( numVertices <= tinyVertices )
+        {
+            GLenum mode( GL_POINTS );
+            if ( geometry->getNumPrimitiveSets() )
+                mode = geometry->getPrimitiveSet(0)->getMode();
+            if ( GL_POINTS == mode )
+                ++patterns.tinyPoints;
+            else if ( (GL_LINES == mode) || (GL_LINE_STRIP == mode) || (GL_LINE_LOOP == mode) )
+                ++patterns.tinyLines;
+            else
+                ++patterns.tinyOther;
+        }
+
+        // lots of tiny primitive sets
+        const size_t numSets( geometry->getNumPrimitiveSets() );
+        if ( numSets > fragmentedSets )
+        {
+            size_t indices(0);
+            for ( size_t ii(0) ; ii<numSets ; ++ii )
+                indices += geometry->getPrimitiveSet(ii)->getNumIndices();
+            if ( indices <= numSets * tinyIndices )
+            {
+                ++patterns.fragmentedGeometries;
+                patterns.fragmentedPrimitiveSets += numSets;
+            }
+        }
+
+        // display lists on changing data are recompiled on every change
+        const bool changes( (osg::Object::DYNAMIC == geometry->getDataVariance()) ||
+                            geometry->getUpdateCallback() ||
+                            (vertices && (vertices->getModifiedCount() > 1)) );
+        if ( geometry->getUseDisplayList() && changes )
+        {
+            ++patterns.dynamicDisplayLists;
+            patterns.dynamicVertices += numVertices;
+        }
+    };
+
+    /// Are we under a transparent state set
+    bool      m_transparent;
+
+    /// The chain of single child groups we are in
+    size_t    m_chain;
+};
+
+/// @brief   Make a finding
+SceneFinding finding(const std::string& item,
+                     const std::string& problem,
+                     const size_t& count,
+                     const double& cost_ms,
+                     const std::string& suggestion)
+{
+    std::ostringstream text;
+    text << count << " " << problem;
+    return SceneFinding{item, text.str(), count, cost_ms, suggestion};
+};
+
+} // namespace
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+ScenePatterns countPatterns(osg::Node* node)
+{
+    PatternVisitor visitor;
+    if ( node ) node->accept(visitor);
+    return visitor.patterns;
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+std::vector<SceneFinding> analyzeItem(const std::string& item,
+                                      const ScenePatterns& patterns)
+{
+    std::vector<SceneFinding> findings;
+
+    const size_t tiny( patterns.tinyPoints + patterns.tinyLines + patterns.tinyOther );
+    if ( tiny >= tinyDrawablesFound )
+    {
+        std::string suggestion("merge them into one osg::Geometry");
+        if ( patterns.tinyPoints >= std::max(patterns.tinyLines, patterns.tinyOther) )
+            suggestion = "add them all at once with d3::get(const PointVec_t&) instead of a get(const Point&) each";
+        else if ( patterns.tinyLines >= patterns.tinyOther )
+            suggestion = "add them all at once with d3::get(const LineVec_t&) instead of a get(const Line&) each";
+        findings.push_back(finding(item, "drawables with 4 vertices or less (a draw call each)",
+                                   tiny, tiny * drawCall_ms, suggestion));
+    }
+
+    if ( patterns.fragmentedPrimitiveSets >= fragmentedSetsFound )
+        findings.push_back(finding(item, "tiny primitive sets (i.e. one per quad)",
+                                   patterns.fragmentedPrimitiveSets,
+                                   patterns.fragmentedPrimitiveSets * primitiveSet_ms,
+                                   "use one DrawArrays or DrawElements per geometry, d3::MeshGrid and d3::HeightGrid build one"));
+
+    if ( patterns.transparentDrawables >= transparentFound )
+        findings.push_back(finding(item, "drawables in the transparent bin (depth sorted every frame)",
+                                   patterns.transparentDrawables,
+                                   patterns.transparentDrawables * (depthSort_ms + drawCall_ms),
+                                   "only put the translucent parts in the transparent bin, and merge them"));
+
+    if ( patterns.dynamicDisplayLists )
+        findings.push_back(finding(item, "display listed geometries which change (recompiled on every change)",
+                                   patterns.dynamicDisplayLists,
+                                   patterns.dynamicVertices * compileVertex_ms,
+                                   "setUseDisplayList(false) and setUseVertexBufferObjects(true) on them, or re-add with a d3 builder"));
+
+    if ( patterns.longestChain >= chainFound )
+        findings.push_back(finding(item, "nested groups with a single child each",
+                                   patterns.longestChain,
+                                   patterns.longestChain * cullNode_ms,
+                                   "add the drawables closer to the top of the item"));
+
+    return findings;
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+bool namespaceChain(const std::string& item,
+                    const size_t& levels,
+                    SceneFinding& found)
+{
+    if ( levels < namespaceChainFound ) return false;
+
+    found = finding(item, "nested namespaces holding a single item each (a group each)",
+                    levels, levels * cullNode_ms,
+                    "use fewer \"::\" levels in the name");
+    return true;
+};
+
+} // namespace d3
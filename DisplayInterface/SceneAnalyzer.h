@@ -0,0 +1,103 @@
+/////////////////////////////////////////////////////////////////
+/// @file      SceneAnalyzer.h
+/// @author    Chris L Baker (clb) <chris@chimail.net>
+/// @date      2026.10.18
+/// @brief     Look for the usual ways a scene gets slow
+///
+/// @attention Copyright (C) 2026
+/// @attention All rights reserved
+/////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <osg/Node>
+
+#include <string>
+#include <vector>
+
+namespace d3
+{
+
+/////////////////////////////////////////////////////////////////
+/// @brief   A performance problem found in a displayed item
+/////////////////////////////////////////////////////////////////
+struct SceneFinding
+{
+    /// The full name of the item (i.e. "AA::BB::CC")
+    std::string     item;
+
+    /// What was found
+    std::string     problem;
+
+    /// How many times it was found (drawables, primitive sets, levels...)
+    size_t          count;
+
+    /// A rough estimate of what it costs per frame (ms)
+    double          cost_ms;
+
+    /// What to do about it
+    std::string     suggestion;
+};
+
+/////////////////////////////////////////////////////////////////
+/// @brief   The counts of the anti-patterns in the subgraph of an item
+/////////////////////////////////////////////////////////////////
+struct ScenePatterns
+{
+    /// The drawables with only a few vertices, by what they draw
+    size_t    tinyPoints;
+    size_t    tinyLines;
+    size_t    tinyOther;
+
+    /// The geometries split into lots of tiny primitive sets
+    size_t    fragmentedGeometries;
+    size_t    fragmentedPrimitiveSets;
+
+    /// The drawables in the depth sorted bin
+    size_t    transparentDrawables;
+
+    /// The display listed geometries which change, and their vertices
+    size_t    dynamicDisplayLists;
+    size_t    dynamicVertices;
+
+    /// The longest chain of single child groups
+    size_t    longestChain;
+};
+
+/// @brief   Count the anti-patterns in the subgraph of an item
+/// @param   node The subgraph
+/// @return  ScenePatterns The counts
+///
+/// This walks the live subgraph (update callbacks, pose and style transforms
+/// and the profiler all change it), so call it with the renderer locked out,
+/// and keep the lock short by counting one item at a time.
+ScenePatterns countPatterns(osg::Node* node);
+
+/// @brief   Turn the anti-patterns of an item into findings
+/// @param   item The full name of the item
+/// @param   patterns The counts from countPatterns() - this only looks at
+///          them, so it can run on any thread
+/// @return  std::vector<SceneFinding> What was found, if anything
+///
+/// This looks for
+///  - lots of tiny drawables (i.e. a get(const Point&) per point), where the
+///    draw calls cost far more than the vertices
+///  - geometry split into lots of tiny primitive sets (i.e. one per quad)
+///  - lots of drawables in the depth sorted transparent bin
+///  - display lists on geometry which changes, so they get recompiled
+///  - deep chains of groups with a single child
+/// The costs are estimates from typical per draw call, per primitive set and
+/// per node costs, so they are for ranking the findings, not for budgeting.
+std::vector<SceneFinding> analyzeItem(const std::string& item,
+                                      const ScenePatterns& patterns);
+
+/// @brief   Look at a chain of namespaces which each hold a single item
+/// @param   item The full name of the top of the chain
+/// @param   levels The number of levels in the chain
+/// @param   finding The finding, if the chain is long enough to matter
+/// @return  boolean True if the chain is long enough to matter
+bool namespaceChain(const std::string& item,
+                    const size_t& levels,
+                    SceneFinding& finding);
+
+} // namespace d3
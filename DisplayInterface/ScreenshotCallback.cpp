@@ -8,6 +8,7 @@
 /////////////////////////////////////////////////////////////////
 
 #include "ScreenshotCallback.h"
+#include "StallWatchdog.h"
 
 #include <osgDB/WriteFile>
 
@@ -87,6 +88,7 @@ void ScreenshotCallback::operator()(osg::RenderInfo& renderInfo) const
                << frameCount++ << ".ppm";
 
             std::cout << "Saving frame to file: " << ss.str() << std::endl;
+            StallWatchdog::ScopedPhase phase(StallWatchdog::Phase::CAPTURE_WRITE);
             osgDB::writeImageFile(*m_image, ss.str());
         }
     }
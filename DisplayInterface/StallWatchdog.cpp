@@ -0,0 +1,206 @@
+/////////////////////////////////////////////////////////////////
+/// @file      StallWatchdog.cpp
+/// @author    Chris L Baker (clb) <chris@chimail.net>
+/// @date      2026.10.18
+/// @brief     Watch the display thread for stalls and report what it was
+///            doing at the time
+///
+/// @attention Copyright (C) 2026
+/// @attention All rights reserved
+/////////////////////////////////////////////////////////////////
+
+#include "StallWatchdog.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+
+namespace d3
+{
+
+namespace
+{
+
+/// @brief   The steady clock in ns
+inline int64_t now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+};
+
+} // namespace
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+StallWatchdog& watchdog()
+{
+    static StallWatchdog theWatchdog;
+    return theWatchdog;
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+const char* StallWatchdog::toString(const Phase& phase)
+{
+    switch ( phase )
+    {
+    case Phase::IDLE:           return "idle";
+    case Phase::PROCESS_EVENTS: return "processing events";
+    case Phase::RENDER:         return "rendering";
+    case Phase::TREE_ADD:       return "adding to the tree";
+    case Phase::TREE_RESIZE:    return "resizing the tree";
+    case Phase::MEMORY_BUDGET:  return "enforcing the memory budget";
+    case Phase::CAPTURE_WRITE:  return "writing a capture";
+    }
+    return "unknown";
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+StallWatchdog::ScopedPhase::ScopedPhase(const Phase& phase,
+                                        const std::string& item /* = "" */) :
+    m_prior(Phase::IDLE),
+    m_isDisplayThread(watchdog().setPhase(phase, m_prior))
+{
+    if ( not item.empty() ) watchdog().setItem(item);
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+StallWatchdog::ScopedPhase::~ScopedPhase()
+{
+    Phase ignored;
+    if ( m_isDisplayThread ) watchdog().setPhase(m_prior, ignored);
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+StallWatchdog::StallWatchdog() :
+    m_threshold_ms(250),
+    m_lastBeat(0),
+    m_phase(static_cast<int>(Phase::IDLE)),
+    m_displayThread(std::thread::id()),
+    m_itemMutex(),
+    m_item(),
+    m_thread(),
+    m_threadShouldRun(false)
+{
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+StallWatchdog::~StallWatchdog()
+{
+    stop();
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void StallWatchdog::start(const unsigned int& threshold_ms /* = 250 */)
+{
+    m_threshold_ms = std::max(1u, threshold_ms);
+    if ( m_threadShouldRun ) return;
+
+    m_threadShouldRun = true;
+    m_thread = std::thread([&]() { run(); });
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void StallWatchdog::stop()
+{
+    m_threadShouldRun = false;
+    if ( m_thread.joinable() )
+        m_thread.join();
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void StallWatchdog::beat()
+{
+    if ( std::thread::id() == m_displayThread.load(std::memory_order_relaxed) )
+        m_displayThread = std::this_thread::get_id();
+
+    m_lastBeat.store(now_ns(), std::memory_order_release);
+};
+
+/////////////////////////////////////////////////////////////////
+///////////////////// PRIVATES /////////////////////////////////
+///////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+bool StallWatchdog::setPhase(const Phase& phase,
+                             Phase& prior)
+{
+    if ( std::this_thread::get_id() != m_displayThread.load(std::memory_order_relaxed) )
+        return false;
+
+    prior = static_cast<Phase>(m_phase.exchange(static_cast<int>(phase), std::memory_order_relaxed));
+    return true;
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void StallWatchdog::setItem(const std::string& item)
+{
+    std::lock_guard<std::mutex> lock(m_itemMutex);
+    m_item = item;
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void StallWatchdog::run()
+{
+    bool stalled(false);
+    int64_t stalledBeat(0);
+    Phase lastPhase(Phase::IDLE);
+    std::ostringstream phases;
+
+    while ( m_threadShouldRun )
+    {
+        const int64_t threshold_ns( int64_t(m_threshold_ms) * 1000000 );
+        std::this_thread::sleep_for(std::chrono::nanoseconds(std::max<int64_t>(threshold_ns / 4, 1000000)));
+
+        const int64_t lastBeat( m_lastBeat.load(std::memory_order_acquire) );
+        if ( 0 == lastBeat ) continue;
+
+        const Phase phase( static_cast<Phase>(m_phase.load(std::memory_order_relaxed)) );
+        if ( not stalled )
+        {
+            if ( now_ns() - lastBeat < threshold_ns ) continue;
+
+            // we just found a stall
+            stalled = true;
+            stalledBeat = lastBeat;
+            lastPhase = phase;
+            phases.str("");
+            phases << toString(phase);
+
+            std::lock_guard<std::mutex> lock(m_itemMutex);
+            std::cerr << "BUMMER: The display has stalled for "
+                      << (now_ns() - lastBeat) / 1000000 << " ms so far, "
+                      << toString(phase) << " (last item applied: '" << m_item << "')"
+                      << std::endl;
+        }
+        else if ( lastBeat != stalledBeat )
+        {
+            // the stall is over
+            stalled = false;
+            std::lock_guard<std::mutex> lock(m_itemMutex);
+            std::cerr << "BUMMER: The display stalled for "
+                      << (lastBeat - stalledBeat) / 1000000 << " ms, "
+                      << phases.str() << " (last item applied: '" << m_item << "')"
+                      << std::endl;
+        }
+        else if ( phase != lastPhase )
+        {
+            // still stalled, but it moved on to something else
+            lastPhase = phase;
+            phases << ", then " << toString(phase);
+        }
+    }
+};
+
+} // namespace d3
@@ -0,0 +1,148 @@
+/////////////////////////////////////////////////////////////////
+/// @file      StallWatchdog.h
+/// @author    Chris L Baker (clb) <chris@chimail.net>
+/// @date      2026.10.18
+/// @brief     Watch the display thread for stalls and report what it was
+///            doing at the time
+///
+/// @attention Copyright (C) 2026
+/// @attention All rights reserved
+/////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace d3
+{
+
+class StallWatchdog;
+
+/// Provide easy access to the static singleton by way of
+/// @code
+/// d3::watchdog()
+/// @endcode
+StallWatchdog& watchdog();
+
+/////////////////////////////////////////////////////////////////
+/// @brief   A thread which watches the display thread's heartbeat
+///
+/// The display thread beats once per loop. When the beats stop for longer than
+/// the threshold, the watchdog reports which phase the display thread is in
+/// (the phases are marked with ScopedPhase) and which item was being applied,
+/// then reports the total duration once the beats start again. Marking a
+/// phase is just a couple of atomic stores, so the markers are always on.
+/////////////////////////////////////////////////////////////////
+class StallWatchdog
+{
+  public:
+
+    /// @brief   What the display thread is doing
+    enum class Phase
+    {
+        IDLE = 0,
+        PROCESS_EVENTS,
+        RENDER,
+        TREE_ADD,
+        TREE_RESIZE,
+        MEMORY_BUDGET,
+        CAPTURE_WRITE
+    };
+
+    /// @brief   A readable name for a phase
+    static const char* toString(const Phase& phase);
+
+    /////////////////////////////////////////////////////////////////
+    /// @brief   Mark a phase for the life of this object, the prior phase is
+    ///          restored when it goes out of scope
+    /////////////////////////////////////////////////////////////////
+    class ScopedPhase
+    {
+      public:
+
+        /// @brief   Constructor
+        /// @param   phase The phase we are entering
+        /// @param   item The item being applied (if any)
+        ScopedPhase(const Phase& phase,
+                    const std::string& item = "");
+
+        /// @brief   Destructor
+        ~ScopedPhase();
+
+      private:
+
+        /// The phase to put back
+        Phase        m_prior;
+
+        /// Did we set the phase (only the display thread does)
+        bool         m_isDisplayThread;
+    };
+
+    /// @{
+    /// @name Noncopyable
+    StallWatchdog(const StallWatchdog&) = delete;
+    StallWatchdog& operator=(const StallWatchdog&) = delete;
+    /// @}
+
+    /// @brief   Constructor
+    StallWatchdog();
+
+    /// @brief   Destructor
+    ~StallWatchdog();
+
+    /// @brief   Start watching
+    /// @param   threshold_ms How long the display thread can go without a
+    ///          beat before it's a stall
+    void start(const unsigned int& threshold_ms = 250);
+
+    /// @brief   Stop watching
+    void stop();
+
+    /// @brief   The heartbeat - the thread that calls this is the display thread
+    void beat();
+
+  private:
+
+    /// @brief   Set the phase, if called from the display thread
+    /// @return  boolean True if this is the display thread
+    bool setPhase(const Phase& phase,
+                  Phase& prior);
+
+    /// @brief   Set the item being applied (from any thread) - it's kept until
+    ///          the next one, since a stall in the next frame is usually the
+    ///          first draw of the last item
+    void setItem(const std::string& item);
+
+    /// @brief   The watchdog loop
+    void run();
+
+    /// How long before it's a stall
+    std::atomic<unsigned int>    m_threshold_ms;
+
+    /// The time of the last beat (steady clock ns)
+    std::atomic<int64_t>         m_lastBeat;
+
+    /// The phase the display thread is in
+    std::atomic<int>             m_phase;
+
+    /// The display thread
+    std::atomic<std::thread::id> m_displayThread;
+
+    /// Protect the item
+    std::mutex                   m_itemMutex;
+
+    /// The last item applied
+    std::string                  m_item;
+
+    /// The watchdog thread
+    std::thread                  m_thread;
+
+    /// Flag for the thread
+    std::atomic<bool>            m_threadShouldRun;
+};
+
+} // namespace d3
@@ -0,0 +1,193 @@
+/////////////////////////////////////////////////////////////////
+/// @file      Style.cpp
+/// @author    Chris L Baker (clb) <chris@chimail.net>
+/// @date      2026.10.18
+/// @brief     Restyle displayed items without rebuilding them
+///
+/// @attention Copyright (C) 2026
+/// @attention All rights reserved
+/////////////////////////////////////////////////////////////////
+
+#include "Style.h"
+
+#include <osg/AlphaFunc>
+#include <osg/BlendColor>
+#include <osg/BlendFunc>
+#include <osg/Geode>
+#include <osg/LineWidth>
+#include <osg/NodeVisitor>
+#include <osg/Point>
+#include <osg/Shader>
+#include <osg/Texture>
+#include <osg/Uniform>
+
+namespace d3
+{
+
+namespace
+{
+
+/// The tint - the fixed function color (lit or not), modulated by the
+/// texture on unit 0 if the item has one, mixed toward the tint. There's no
+/// vertex shader, so the lighting and the texture coordinates are still the
+/// fixed function ones.
+const char* tintSource =
+    "uniform vec4 d3_tint;\n"
+    "uniform float d3_alpha;\n"
+    "uniform bool d3_textured;\n"
+    "uniform sampler2D d3_texture;\n"
+    "void main()\n"
+    "{\n"
+    "    vec4 color = gl_Color;\n"
+    "    if ( d3_textured )\n"
+    "        color *= texture2D(d3_texture, gl_TexCoord[0].st);\n"
+    "    gl_FragColor = vec4(mix(color.rgb, d3_tint.rgb, d3_tint.a),\n"
+    "                        color.a * d3_alpha);\n"
+    "}\n";
+
+/////////////////////////////////////////////////////////////////
+/// @brief   Visitor to look for a texture on unit 0 anywhere in a subgraph
+/////////////////////////////////////////////////////////////////
+class TextureVisitor : public osg::NodeVisitor
+{
+  public:
+
+    TextureVisitor() :
+        osg::NodeVisitor(osg::NodeVisitor::TRAVERSE_ALL_CHILDREN),
+        m_textured(false)
+    {};
+
+    virtual void apply(osg::Node& node)
+    {
+        if ( m_textured ) return;
+        check(node.getStateSet());
+        traverse(node);
+    };
+
+    virtual void apply(osg::Geode& geode)
+    {
+        if ( m_textured ) return;
+        check(geode.getStateSet());
+        for ( unsigned int ii(0) ; ii<geode.getNumDrawables() ; ++ii )
+            if ( geode.getDrawable(ii) ) check(geode.getDrawable(ii)->getStateSet());
+        traverse(geode);
+    };
+
+    bool textured() const { return m_textured; };
+
+  private:
+
+    void check(const osg::StateSet* stateSet)
+    {
+        if ( stateSet && stateSet->getTextureAttribute(0, osg::StateAttribute::TEXTURE) )
+            m_textured = true;
+    };
+
+    /// Did we find one
+    bool      m_textured;
+};
+
+} // namespace
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+StyleQueue::StyleQueue() :
+    osg::Operation("StyleQueue", true),
+    m_queue(),
+    m_applied(),
+    m_pTint(new osg::Program())
+{
+    m_pTint->setName("d3 style tint");
+    m_pTint->addShader(new osg::Shader(osg::Shader::FRAGMENT, tintSource));
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void StyleQueue::push(osg::MatrixTransform* transform,
+                      const Style& style)
+{
+    m_queue.push(Update{transform, style});
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void StyleQueue::operator()(osg::Object*)
+{
+    if ( m_queue.empty() ) return;
+
+    // newest first, so the first style we see for a transform is the one to use
+    m_queue.drain([&](Update& update)
+                  {
+                      if ( m_applied.insert(update.transform.get()).second )
+                          apply(*update.transform, update.style);
+                  });
+    m_applied.clear();
+};
+
+/////////////////////////////////////////////////////////////////
+///////////// PRIVATES /////////////////////////////////////////
+///////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void StyleQueue::apply(osg::MatrixTransform& transform,
+                       const Style& style) const
+{
+    // the managed transform has no state of its own, so the style owns it
+    if ( style.isNone() )
+    {
+        transform.setStateSet(nullptr);
+        return;
+    }
+
+    // the state set changes under the draw of the last frame, so the viewer
+    // has to wait for that draw before the next update
+    osg::StateSet* stateSet( transform.getOrCreateStateSet() );
+    stateSet->setDataVariance(osg::Object::DYNAMIC);
+    stateSet->clear();
+
+    const osg::StateAttribute::GLModeValue forced( osg::StateAttribute::ON | osg::StateAttribute::OVERRIDE );
+
+    if ( style.color.a() > 0.0 )
+    {
+        // the shader only samples the texture if there is one to sample
+        TextureVisitor textures;
+        for ( unsigned int ii(0) ; ii<transform.getNumChildren() ; ++ii )
+            transform.getChild(ii)->accept(textures);
+
+        stateSet->setAttributeAndModes(m_pTint.get(), forced);
+        stateSet->addUniform(new osg::Uniform("d3_tint", style.color), forced);
+        stateSet->addUniform(new osg::Uniform("d3_alpha", style.alpha), forced);
+        stateSet->addUniform(new osg::Uniform("d3_textured", textures.textured()), forced);
+        stateSet->addUniform(new osg::Uniform("d3_texture", 0), forced);
+
+        if ( style.alpha < 1.0 )
+        {
+            stateSet->setAttributeAndModes(new osg::BlendFunc(osg::BlendFunc::SRC_ALPHA,
+                                                              osg::BlendFunc::ONE_MINUS_SRC_ALPHA),
+                                           forced);
+            stateSet->setRenderingHint(osg::StateSet::TRANSPARENT_BIN);
+        }
+    }
+    else if ( style.alpha < 1.0 )
+    {
+        // a fade alone needs no shader, so the item keeps its textures (and
+        // shaders). The blend can't also scale the item's own alpha, so the
+        // texels it leaves out (i.e. around the glyphs of a label) are
+        // dropped instead
+        stateSet->setAttributeAndModes(new osg::BlendColor(osg::Vec4(1.0, 1.0, 1.0, style.alpha)), forced);
+        stateSet->setAttributeAndModes(new osg::BlendFunc(osg::BlendFunc::CONSTANT_ALPHA,
+                                                          osg::BlendFunc::ONE_MINUS_CONSTANT_ALPHA),
+                                       forced);
+        stateSet->setAttributeAndModes(new osg::AlphaFunc(osg::AlphaFunc::GREATER, 0.0), forced);
+        stateSet->setRenderingHint(osg::StateSet::TRANSPARENT_BIN);
+    }
+
+    if ( style.pointSize > 0.0 )
+        stateSet->setAttribute(new osg::Point(style.pointSize), forced);
+
+    if ( style.lineWidth > 0.0 )
+        stateSet->setAttribute(new osg::LineWidth(style.lineWidth), forced);
+};
+
+} // namespace d3
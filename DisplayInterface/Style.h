@@ -0,0 +1,110 @@
+/////////////////////////////////////////////////////////////////
+/// @file      Style.h
+/// @author    Chris L Baker (clb) <chris@chimail.net>
+/// @date      2026.10.18
+/// @brief     Restyle displayed items without rebuilding them
+///
+/// @attention Copyright (C) 2026
+/// @attention All rights reserved
+/////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "FrameQueue.h"
+
+#include <osg/MatrixTransform>
+#include <osg/OperationThread>
+#include <osg/Program>
+#include <osg/Vec4>
+
+#include <unordered_set>
+
+namespace d3
+{
+
+/////////////////////////////////////////////////////////////////
+/// @brief   A style override for a displayed item
+///
+/// The color is a tint - its alpha is how much of it to mix in (0 keeps the
+/// item's own colors, 1 paints it all the one color). The alpha scales the
+/// item's own alpha. A point size or line width of 0 keeps the item's own.
+/// So d3::di().setStyle("AA::BB", {d3::red(), 1.0, 0, 0}) paints the item
+/// red, and {{0,0,0,0}, 0.3, 0, 0} fades it out.
+/////////////////////////////////////////////////////////////////
+struct Style
+{
+    /// The tint (its alpha is the amount of tint)
+    osg::Vec4   color;
+
+    /// The opacity of the item
+    float       alpha;
+
+    /// The size of the points (pixels), 0 to keep the item's own
+    float       pointSize;
+
+    /// The width of the lines (pixels), 0 to keep the item's own
+    float       lineWidth;
+
+    /// @brief   The style which changes nothing
+    static Style none() { return Style{osg::Vec4(0.0, 0.0, 0.0, 0.0), 1.0, 0.0, 0.0}; };
+
+    /// @brief   Does this style change nothing
+    bool isNone() const
+    {
+        return (color.a() <= 0.0) && (alpha >= 1.0) && (pointSize <= 0.0) && (lineWidth <= 0.0);
+    };
+};
+
+/////////////////////////////////////////////////////////////////
+/// @brief   The style changes for the next frame
+///
+/// Like the poses, this runs as an update operation of the viewer, and only
+/// the newest style for each item is applied. A style is a few state
+/// overrides and two uniforms on the transform above the item, so it costs
+/// the same however big the geometry is, and nothing under the transform is
+/// touched (a tint does look through the subgraph once, for a texture). The
+/// tint is a fragment shader which modulates by the texture on unit 0, like
+/// the default texture environment, so it takes the place of any other
+/// textures (and shaders) in the item while the color is tinting. A fade
+/// alone is only blending, so it keeps everything.
+/////////////////////////////////////////////////////////////////
+class StyleQueue : public osg::Operation
+{
+  public:
+
+    /// @brief   Constructor
+    StyleQueue();
+
+    /// @brief   Queue a style (from any thread)
+    /// @param   transform The transform above the item
+    /// @param   style The new style for the item
+    void push(osg::MatrixTransform* transform,
+              const Style& style);
+
+    /// @brief   Apply the queued styles (the update traversal calls this)
+    virtual void operator()(osg::Object*);
+
+  private:
+
+    /// @brief   Set the state of a transform for a style
+    void apply(osg::MatrixTransform& transform,
+               const Style& style) const;
+
+    /// A queued style
+    struct Update
+    {
+        osg::ref_ptr<osg::MatrixTransform>    transform;
+        Style                                 style;
+    };
+
+    /// The queued styles
+    FrameQueue<Update>                          m_queue;
+
+    /// The transforms styled this frame (kept to reuse the buckets)
+    std::unordered_set<osg::MatrixTransform*>   m_applied;
+
+    /// The tint shader, shared by every styled item
+    osg::ref_ptr<osg::Program>                  m_pTint;
+};
+
+} // namespace d3
@@ -0,0 +1,160 @@
+/////////////////////////////////////////////////////////////////
+/// @file      Subscriptions.cpp
+/// @author    Chris L Baker (clb) <chris@chimail.net>
+/// @date      2026.10.18
+/// @brief     Publish which namespaces are being looked at, for the
+///            producers to check without locking
+///
+/// @attention Copyright (C) 2026
+/// @attention All rights reserved
+/////////////////////////////////////////////////////////////////
+
+#include "Subscriptions.h"
+
+#include <iostream>
+
+namespace d3
+{
+
+namespace
+{
+
+/// The most namespaces of a name which are checked (the deeper ones are
+/// skipped)
+const size_t maxDepth(32);
+
+/// @brief   Add a character to a hash (FNV-1a)
+inline uint64_t hashed(const uint64_t& hash,
+                       const char& cc)
+{
+    return (hash ^ static_cast<unsigned char>(cc)) * 1099511628211ull;
+};
+
+/// The hash of an empty name
+const uint64_t emptyHash(14695981039346656037ull);
+
+/// @brief   Finish a hash - zero marks an empty slot
+inline uint64_t finished(const uint64_t& hash)
+{
+    return (0 == hash) ? 1 : hash;
+};
+
+} // namespace
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+Subscriptions& Subscriptions::get()
+{
+    static Subscriptions* pSubscriptions( new Subscriptions() );
+    return *pSubscriptions;
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+bool Subscriptions::isWanted(const std::string& name) const
+{
+    // hash the name, keeping the hash of each namespace along the way
+    uint64_t prefixes[maxDepth];
+    size_t depth(0);
+    uint64_t hash(emptyHash);
+    for ( size_t ii(0) ; ii<name.size() ; ++ii )
+    {
+        if ( (depth < maxDepth) && (':' == name[ii]) && (ii+1 < name.size()) && (':' == name[ii+1]) )
+            prefixes[depth++] = finished(hash);
+        hash = hashed(hash, name[ii]);
+    }
+
+    // the name itself, then the nearest namespace we know about
+    State state( lookup(finished(hash)) );
+    while ( (State::UNKNOWN == state) && (0 != depth) )
+        state = lookup(prefixes[--depth]);
+    return State::HIDDEN != state;
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void Subscriptions::publish(const std::string& path,
+                            const State& state)
+{
+    uint64_t hash(emptyHash);
+    for ( const char& cc : path )
+        hash = hashed(hash, cc);
+    hash = finished(hash);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for ( size_t ii(hash & (numSlots-1)), probes(0) ; probes<numSlots ; ii = (ii+1) & (numSlots-1), ++probes )
+    {
+        Slot& slot( m_slots[ii] );
+        const uint64_t slotHash( slot.hash.load(std::memory_order_relaxed) );
+        if ( slotHash == hash )
+        {
+            slot.state.store(static_cast<uint8_t>(state), std::memory_order_release);
+            return;
+        }
+        if ( 0 != slotHash ) continue;
+
+        // a new name - nothing to take a slot for if it's not there anyway
+        if ( State::UNKNOWN == state ) return;
+        if ( 2*m_used >= numSlots )
+        {
+            static bool reported(false);
+            if ( not reported )
+                std::cerr << "BUMMER: Too many namespaces to publish, the rest are always wanted" << std::endl;
+            reported = true;
+            return;
+        }
+
+        // the state goes in before the hash, so nobody finds the name without it
+        slot.state.store(static_cast<uint8_t>(state), std::memory_order_relaxed);
+        slot.hash.store(hash, std::memory_order_release);
+        ++m_used;
+        return;
+    }
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void Subscriptions::clear()
+{
+    // the hashes stay, so a lookup running now still ends, the names are just
+    // unknown again
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for ( Slot& slot : m_slots )
+        slot.state.store(static_cast<uint8_t>(State::UNKNOWN), std::memory_order_release);
+};
+
+/////////////////////////////////////////////////////////////////
+///////////////////// PRIVATES /////////////////////////////////
+///////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+Subscriptions::Subscriptions() :
+    m_mutex(),
+    m_used(0),
+    m_slots()
+{
+    for ( Slot& slot : m_slots )
+    {
+        slot.hash.store(0, std::memory_order_relaxed);
+        slot.state.store(static_cast<uint8_t>(State::UNKNOWN), std::memory_order_relaxed);
+    }
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+Subscriptions::State Subscriptions::lookup(const uint64_t& hash) const
+{
+    // the table is never more than half full, so there's always an empty
+    // slot to stop at
+    for ( size_t ii(hash & (numSlots-1)) ; ; ii = (ii+1) & (numSlots-1) )
+    {
+        const Slot& slot( m_slots[ii] );
+        const uint64_t slotHash( slot.hash.load(std::memory_order_acquire) );
+        if ( 0 == slotHash ) return State::UNKNOWN;
+        if ( slotHash == hash )
+            return static_cast<State>(slot.state.load(std::memory_order_acquire));
+    }
+};
+
+} // namespace d3
@@ -0,0 +1,98 @@
+/////////////////////////////////////////////////////////////////
+/// @file      Subscriptions.h
+/// @author    Chris L Baker (clb) <chris@chimail.net>
+/// @date      2026.10.18
+/// @brief     Publish which namespaces are being looked at, for the
+///            producers to check without locking
+///
+/// @attention Copyright (C) 2026
+/// @attention All rights reserved
+/////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+namespace d3
+{
+
+/////////////////////////////////////////////////////////////////
+/// @brief   The visibility of every namespace in the tree view
+///
+/// The tree view publishes each item's visibility (checked, and not under an
+/// unchecked parent) by its full name. The producers check it from any thread
+/// with a few atomic loads - no locks, no allocation - so they can skip
+/// building what nobody is looking at. A name is wanted unless its item, or
+/// the nearest ancestor namespace the tree view knows about, is hidden, so a
+/// name which has never been added is always wanted.
+///
+/// The names are kept as 64 bit hashes in a fixed open addressed table. If
+/// the table ever fills up, the names which don't fit are simply wanted.
+/////////////////////////////////////////////////////////////////
+class Subscriptions
+{
+  public:
+
+    /// @brief   The visibility of a name
+    enum class State : uint8_t
+    {
+        UNKNOWN = 0, ///< Not in the tree view (wanted)
+        SHOWN,       ///< Being looked at
+        HIDDEN       ///< Unchecked, or under an unchecked namespace
+    };
+
+    /// @{
+    /// @name Noncopyable
+    Subscriptions(const Subscriptions&) = delete;
+    Subscriptions& operator=(const Subscriptions&) = delete;
+    /// @}
+
+    /// @brief   The table for the display - never destroyed, the producers can
+    ///          check it up to the end
+    static Subscriptions& get();
+
+    /// @brief   Is anyone looking at this name (from any thread, lock free)
+    /// @param   name The full name (i.e. "AA::BB::CC"), or a namespace of it
+    bool isWanted(const std::string& name) const;
+
+    /// @brief   Publish the visibility of an item
+    /// @param   path The full name of the item
+    /// @param   state Its visibility
+    void publish(const std::string& path,
+                 const State& state);
+
+    /// @brief   Forget every name (i.e. the tree view has gone)
+    void clear();
+
+  private:
+
+    /// @brief   Constructor
+    Subscriptions();
+
+    /// @brief   Look up the state of a hash
+    State lookup(const uint64_t& hash) const;
+
+    /// The number of slots (a power of two)
+    static const size_t numSlots = 1 << 14;
+
+    /// A name and its visibility
+    struct Slot
+    {
+        std::atomic<uint64_t>   hash;
+        std::atomic<uint8_t>    state;
+    };
+
+    /// Protect the publishing (the looking up doesn't lock)
+    std::mutex    m_mutex;
+
+    /// The number of slots taken
+    size_t        m_used;
+
+    /// The names
+    Slot          m_slots[numSlots];
+};
+
+} // namespace d3
@@ -9,12 +9,21 @@
 
 #include "TreeView.h"
 #include "QOSGWidget.h"
+#include "MemoryBudget.h"
+#include "StallWatchdog.h"
+
+#include <DDDisplayObjects/TaskScheduler.h>
 
 #include <QtGui/QTreeView>
 #include <QtGui/QActionGroup>
 #include <QtGui/QCheckBox>
+#include <QtCore/QFileInfo>
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <map>
+#include <memory>
 
 namespace d3
 {
@@ -25,8 +34,31 @@ TreeView::TreeView() :
     QTreeView(),
     m_pOsgWidget(nullptr),
     m_pModel(nullptr),
-    m_mutex()
+    m_mutex(),
+    m_pPoseQueue(new PoseQueue()),
+    m_pStyleQueue(new StyleQueue()),
+    m_pLatency(new LatencyTracker()),
+    m_pReclaimer(new Reclaimer()),
+    m_memoryBudget(0),
+    m_spillDirectory(),
+    m_residentMemory(0),
+    m_occlusionVertices(0),
+    m_hiddenPatterns(),
+    m_shownPaths(),
+    m_pProfiler(),
+    m_profileTimer(),
+    m_analysisMutex(),
+    m_analysis(),
+    m_findings(),
+    m_flagged()
 {
+    // the visibility profile from the last run
+    std::unique_ptr<QSettings> settings( visibilitySettings() );
+    for ( const QString& pattern : settings->value("hidden").toStringList() )
+        m_hiddenPatterns.push_back(QRegExp(pattern, Qt::CaseSensitive, QRegExp::WildcardUnix));
+    for ( const QString& path : settings->value("shown").toStringList() )
+        m_shownPaths.insert(path.toStdString());
+
     // connect for clicks to show/hide stuff
     QObject::connect(this,
                      SIGNAL(clicked(QModelIndex)),
@@ -45,6 +77,12 @@ TreeView::TreeView() :
                      this,
                      SLOT(collapsed(QModelIndex)));
 
+    // roll the profiled costs
+    QObject::connect(&m_profileTimer,
+                     SIGNAL(timeout()),
+                     this,
+                     SLOT(updateCosts()));
+
     // make the qmodel
     m_mutex.lock();
     m_pModel = new QStandardItemModel();
@@ -60,6 +98,13 @@ TreeView::TreeView() :
 /////////////////////////////////////////////////////////////////
 TreeView::~TreeView()
 {
+    // the analysis is looking at our items
+    if ( m_analysis.valid() ) m_analysis.wait();
+
+    m_profileTimer.stop();
+    m_pProfiler.reset();
+    m_pReclaimer->stop();
+    Subscriptions::get().clear();
     m_pModel->clear();
     reset();
 };
@@ -74,6 +119,19 @@ void TreeView::setOsgWidget(QOSGWidget* widget)
     // Hold the widget
     m_pOsgWidget = widget;
 
+    // the poses are applied in the update traversal
+    m_pOsgWidget->addUpdateOperation(m_pPoseQueue);
+
+    // so are the styles
+    m_pOsgWidget->addUpdateOperation(m_pStyleQueue);
+
+    // follow the added items through to the end of the frame that draws them
+    m_pOsgWidget->addUpdateOperation(m_pLatency);
+    m_pOsgWidget->getCamera()->setPostDrawCallback(m_pLatency->getDrawCallback());
+
+    // the replaced nodes are torn down a bit at a time, where the context is
+    m_pOsgWidget->getCamera()->setInitialDrawCallback(m_pReclaimer);
+
     // get the lock
     m_mutex.lock();
 
@@ -85,7 +143,10 @@ void TreeView::setOsgWidget(QOSGWidget* widget)
     m_pModel->appendRow(topEntry);
 
     // set to accomodate this width
-    resizeColumnToContents(0);
+    {
+        StallWatchdog::ScopedPhase resizePhase(StallWatchdog::Phase::TREE_RESIZE);
+        resizeColumnToContents(0);
+    }
 
     // expand the first depth
     expandToDepth(0);
@@ -106,6 +167,8 @@ bool TreeView::add(const std::string& name,
     // by default enable the node
     static const bool enableNode(true);
 
+    StallWatchdog::ScopedPhase phase(StallWatchdog::Phase::TREE_ADD, name);
+
     // make sure the osg widget has been set
     if ( (nullptr != m_pOsgWidget) )
     {
@@ -122,6 +185,10 @@ bool TreeView::add(const std::string& name,
                      showNode,
                      addToDisplay,
                      myItem) );
+
+        // adding stuff may have pushed us over the memory budget
+        StallWatchdog::ScopedPhase budgetPhase(StallWatchdog::Phase::MEMORY_BUDGET);
+        enforceMemoryBudget();
         m_mutex.unlock();
 
         // we're done
@@ -132,10 +199,191 @@ bool TreeView::add(const std::string& name,
     return false;
 };
 
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+bool TreeView::submit(const std::string& name,
+                      const osg::ref_ptr<osg::Node> node,
+                      const bool& showNode,
+                      const bool& addToDisplay,
+                      const int64_t& submitted_ns)
+{
+    const int64_t applying( LatencyTracker::now_ns() );
+
+    size_t occlusionVertices(0);
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_mutex);
+        occlusionVertices = m_occlusionVertices;
+    }
+
+    // the culled node is what gets drawn, so that's what the latency follows
+    const osg::ref_ptr<osg::Node> shown( occlusionCulled(node, occlusionVertices) );
+    if ( not add(name, shown, showNode, addToDisplay) )
+        return false;
+
+    m_pLatency->applied(name, shown.get(), submitted_ns, applying);
+    return true;
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+bool TreeView::addDeferred(const std::string& name,
+                           std::function<osg::ref_ptr<osg::Node>()>&& builder,
+                           const bool& showNode,
+                           const bool& addToDisplay /* = true */)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+
+    // add a placeholder, which gets built like an evicted item when it's shown
+    if ( not add(name, new Pooled<osg::Group>(), showNode, addToDisplay) )
+        return false;
+
+    d3DisplayItem* item( findItem(name) );
+    if ( nullptr == item ) return false;
+    item->setDeferred(std::move(builder));
+    item->setEvictable(false);
+
+    if ( (Qt::Checked == item->checkState()) && item->isEnabled() )
+        restore(item);
+    return true;
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void TreeView::setMemoryBudget(const size_t& bytes,
+                               const std::string& spillDirectory /* = "" */)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    m_memoryBudget = bytes;
+    m_spillDirectory = spillDirectory;
+    StallWatchdog::ScopedPhase budgetPhase(StallWatchdog::Phase::MEMORY_BUDGET);
+    enforceMemoryBudget();
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void TreeView::setOcclusionCulling(const size_t& minVertices)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    m_occlusionVertices = minVertices;
+};
+
 /////////////////////////////////////////////////////////////////
 /////////////// SLOTS //////////////////////////////////////////
 ///////////////////////////////////////////////////////////////
 
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+bool TreeView::setVisibleInView(const std::string& name,
+                                const osg::Node::NodeMask& viewMask,
+                                const bool& visible)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    d3DisplayItem* item( findItem(name) );
+    if ( (nullptr == item) || not item->getNode() ) return false;
+
+    // an unchecked item holds its mask in the prior node mask until it's
+    // checked again
+    m_pOsgWidget->lock();
+    osg::ref_ptr<osg::Node> node( item->getNode() );
+    const bool unchecked( 0 == node->getNodeMask() );
+
+    // keep the item's own mask, to put back once it's in every viewport
+    const osg::Node::NodeMask hidden( item->getHiddenViews() );
+    if ( 0 == hidden )
+        item->setViewedNodeMask(unchecked ? item->getPriorNodeMask() : node->getNodeMask());
+
+    const osg::Node::NodeMask nowHidden( visible ? (hidden & ~viewMask) : (hidden | viewMask) );
+    item->setHiddenViews(nowHidden);
+    const osg::Node::NodeMask mask( (0 == nowHidden) ? item->getViewedNodeMask() :
+                                    (QOSGWidget::viewBits & ~nowHidden) );
+    if ( unchecked )
+        item->setPriorNodeMask(mask);
+    else
+        node->setNodeMask(mask);
+    m_pOsgWidget->unlock();
+
+    return true;
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+PoseHandle TreeView::getPoseHandle(const std::string& name)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    d3DisplayItem* item( findItem(name) );
+    if ( (nullptr == item) || not item->getNode() ) return PoseHandle();
+
+    getManagedTransform(item);
+    return PoseHandle(item->getPoseSlot(), m_pPoseQueue);
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+bool TreeView::setStyle(const std::string& name,
+                        const Style& style)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    d3DisplayItem* item( findItem(name) );
+    if ( (nullptr == item) || not item->getNode() ) return false;
+
+    m_pStyleQueue->push(getManagedTransform(item).get(), style);
+    return true;
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+std::shared_future<std::vector<SceneFinding>> TreeView::analyze()
+{
+    std::lock_guard<std::mutex> analysisLock(m_analysisMutex);
+
+    // one at a time
+    if ( m_analysis.valid() &&
+         (std::future_status::ready != m_analysis.wait_for(std::chrono::seconds(0))) )
+        return m_analysis;
+
+    // the snapshot - holding on to the subgraphs keeps them around for the
+    // analysis, even if they are replaced in the mean time (they are still
+    // live, so they are only walked with the renderer locked out)
+    std::vector<std::pair<std::string, osg::ref_ptr<osg::Node>>> leaves;
+    std::vector<SceneFinding> findings;
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_mutex);
+        const d3DisplayItem* topItem( static_cast<d3DisplayItem*>(m_pModel->item(0)) );
+        if ( topItem )
+            for ( int ii(0) ; ii<topItem->rowCount() ; ++ii )
+                snapshot(static_cast<d3DisplayItem*>(topItem->child(ii)), leaves, findings);
+    }
+
+    m_analysis = scheduleAsync([this, leaves, findings]()
+                               {
+                                   std::vector<SceneFinding> all( findings );
+                                   for ( const auto& leaf : leaves )
+                                   {
+                                       // one item at a time, so the display keeps going
+                                       m_pOsgWidget->lock();
+                                       const ScenePatterns patterns( countPatterns(leaf.second.get()) );
+                                       m_pOsgWidget->unlock();
+
+                                       const std::vector<SceneFinding> found( analyzeItem(leaf.first, patterns) );
+                                       all.insert(all.end(), found.begin(), found.end());
+                                   }
+                                   std::sort(all.begin(), all.end(),
+                                             [](const SceneFinding& aa, const SceneFinding& bb)
+                                             { return aa.cost_ms > bb.cost_ms; });
+
+                                   // the tree view shows them once they're here, without
+                                   // waiting on this task
+                                   {
+                                       std::lock_guard<std::mutex> analysisLock(m_analysisMutex);
+                                       m_findings = all;
+                                   }
+                                   QMetaObject::invokeMethod(this, "showFindings", Qt::QueuedConnection);
+                                   return all;
+                               },
+                               Priority::BACKGROUND).share();
+    return m_analysis;
+};
+
 /////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////
 void TreeView::clicked(const QModelIndex& index)
@@ -146,13 +394,18 @@ void TreeView::clicked(const QModelIndex& index)
         // lock the model view
         m_mutex.lock();
 
-        // get the item from the menu index
-        d3DisplayItem* item = static_cast<d3DisplayItem*>(m_pModel->itemFromIndex(index));
+        // get the item from the menu index (the cost column is a plain item)
+        d3DisplayItem* item = static_cast<d3DisplayItem*>(m_pModel->itemFromIndex(index.sibling(index.row(), 0)));
 
         // make sure we have the item
         if ( not item )
             throw std::runtime_error("Item not retrieved");
 
+        // rebuild the node if it was evicted and is now being shown
+        item->touch();
+        if ( (Qt::Checked == item->checkState()) && item->isEnabled() )
+            restore(item);
+
         // lock osg and set the node mask based on the checked state
         m_pOsgWidget->lock();
         if ( Qt::Checked == item->checkState() )
@@ -169,6 +422,7 @@ void TreeView::clicked(const QModelIndex& index)
                 item->setPriorNodeMask(item->getNode()->getNodeMask());
             item->getNode()->setNodeMask(0);
         }
+        publish(item);
 
         // now we have to recursively process the children to have them match
         // this entry's checked state
@@ -176,8 +430,17 @@ void TreeView::clicked(const QModelIndex& index)
             updateChildren(static_cast<d3DisplayItem*>(item->child(ii)),
                            Qt::Checked == item->checkState());
 
-        // unlock osg and the model view
+        // unlock osg
         m_pOsgWidget->unlock();
+
+        // hiding things may let us get back under the memory budget
+        StallWatchdog::ScopedPhase budgetPhase(StallWatchdog::Phase::MEMORY_BUDGET);
+        enforceMemoryBudget();
+
+        // remember what the user hid for the next run
+        saveVisibility(item);
+
+        // unlock the model view
         m_mutex.unlock();
 
         // run any registered function
@@ -185,11 +448,43 @@ void TreeView::clicked(const QModelIndex& index)
     }
 };
 
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void TreeView::setProfiling(bool enable)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    if ( (nullptr == m_pOsgWidget) || (enable == static_cast<bool>(m_pProfiler)) )
+        return;
+
+    if ( enable )
+    {
+        m_pProfiler.reset(new DrawCostProfiler(m_pOsgWidget));
+        m_pModel->setColumnCount(2);
+        m_pModel->setHorizontalHeaderLabels(QStringList() << "Item" << "Cost (ms/frame)");
+        header()->show();
+        updateCost(static_cast<d3DisplayItem*>(m_pModel->item(0)));
+        setSortingEnabled(true);
+        sortByColumn(1, Qt::DescendingOrder);
+        m_profileTimer.start(500);
+    }
+    else
+    {
+        m_profileTimer.stop();
+        m_pProfiler.reset();
+        setSortingEnabled(false);
+        removeCostColumn(m_pModel->invisibleRootItem());
+        header()->hide();
+    }
+};
+
 /////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////
 void TreeView::expanded(const QModelIndex& index)
 {
-    resizeColumnToContents(0);
+    {
+        StallWatchdog::ScopedPhase resizePhase(StallWatchdog::Phase::TREE_RESIZE);
+        resizeColumnToContents(0);
+    }
     auto item( static_cast<d3DisplayItem*>(m_pModel->itemFromIndex(index)) );
     if ( item ) item->runClickCallback();
 };
@@ -198,11 +493,101 @@ void TreeView::expanded(const QModelIndex& index)
 /////////////////////////////////////////////////////////////////
 void TreeView::collapsed(const QModelIndex& index)
 {
-    resizeColumnToContents(0);
+    {
+        StallWatchdog::ScopedPhase resizePhase(StallWatchdog::Phase::TREE_RESIZE);
+        resizeColumnToContents(0);
+    }
     auto item( static_cast<d3DisplayItem*>(m_pModel->itemFromIndex(index)) );
     if ( item ) item->runClickCallback();
 };
 
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void TreeView::updateCosts()
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    if ( not m_pProfiler ) return;
+
+    m_pProfiler->roll();
+    updateCost(static_cast<d3DisplayItem*>(m_pModel->item(0)));
+
+    // keep it sorted as the costs change
+    if ( 1 == header()->sortIndicatorSection() )
+        m_pModel->sort(1, header()->sortIndicatorOrder());
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void TreeView::showFindings()
+{
+    std::vector<SceneFinding> findings;
+    {
+        std::lock_guard<std::mutex> analysisLock(m_analysisMutex);
+        findings = m_findings;
+    }
+
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+
+    // clear the last analysis
+    for ( const auto& path : m_flagged )
+    {
+        d3DisplayItem* item( findItem(path) );
+        if ( nullptr == item ) continue;
+        item->setIcon(QIcon());
+        item->setToolTip(QString());
+    }
+    m_flagged.clear();
+
+    // the findings are sorted by cost, so the tool tips are too
+    std::map<std::string, std::vector<const SceneFinding*>> byItem;
+    for ( const auto& finding : findings )
+        byItem[finding.item].push_back(&finding);
+
+    // the namespaces above the items add them up (the top item is the root)
+    const QStandardItem* topItem( m_pModel->item(0) );
+    std::map<std::string, std::pair<size_t, double>> byNamespace;
+
+    for ( const auto& found : byItem )
+    {
+        d3DisplayItem* item( findItem(found.first) );
+        if ( nullptr == item ) continue;
+
+        double cost_ms(0.0);
+        QString details;
+        for ( const SceneFinding* finding : found.second )
+        {
+            cost_ms += finding->cost_ms;
+            details += QString("\n%1 (~%2 ms): %3")
+                .arg(QString::fromStdString(finding->problem))
+                .arg(finding->cost_ms, 0, 'f', 2)
+                .arg(QString::fromStdString(finding->suggestion));
+        }
+        item->setIcon(style()->standardIcon(QStyle::SP_MessageBoxWarning));
+        item->setToolTip(QString("~%1 ms per frame could be saved").arg(cost_ms, 0, 'f', 2) + details);
+        m_flagged.push_back(found.first);
+
+        for ( QStandardItem* parent( item->parent() ) ; parent && (parent != topItem) ; parent = parent->parent() )
+        {
+            std::pair<size_t, double>& total( byNamespace[static_cast<d3DisplayItem*>(parent)->getPath()] );
+            ++total.first;
+            total.second += cost_ms;
+        }
+    }
+
+    for ( const auto& found : byNamespace )
+    {
+        // an item with its own findings keeps its own tool tip
+        d3DisplayItem* item( findItem(found.first) );
+        if ( (nullptr == item) || byItem.count(found.first) ) continue;
+
+        item->setIcon(style()->standardIcon(QStyle::SP_MessageBoxWarning));
+        item->setToolTip(QString("%1 items below with problems, ~%2 ms per frame could be saved")
+                         .arg(found.second.first)
+                         .arg(found.second.second, 0, 'f', 2));
+        m_flagged.push_back(found.first);
+    }
+};
+
 /////////////////////////////////////////////////////////////////
 ///////////// PRIVATES /////////////////////////////////////////
 ///////////////////////////////////////////////////////////////
@@ -286,13 +671,21 @@ bool TreeView::createNewEntry(const std::string& name,
                                             node,
                                             std::move(clickCallback)) );
     entry->setEnabled(enableNode);
+    entry->setAddedToDisplay(addToDisplay);
+
+    // hide it before it's ever drawn
+    hideNewEntry(entry, showNode, myParent);
 
     // add this entry to the item model
     m_mutex.lock();
     myParent->appendRow(entry);
+    publish(entry);
 
     // set to accomodate this width
-    resizeColumnToContents(0);
+    {
+        StallWatchdog::ScopedPhase resizePhase(StallWatchdog::Phase::TREE_RESIZE);
+        resizeColumnToContents(0);
+    }
 
     // conditionally add the node to the osg tree
     if ( addToDisplay )
@@ -300,13 +693,10 @@ bool TreeView::createNewEntry(const std::string& name,
         m_pOsgWidget->lock();
         myParent->getNode()->asGroup()->addChild(node);
         m_pOsgWidget->unlock();
-    }
 
-    // conditionally show the node
-    if ( not showNode )
-    {
-        entry->setCheckState(Qt::Unchecked);
-        clicked(m_pModel->indexFromItem(entry));
+        // keep track of the memory this item holds
+        entry->setMemory(estimateMemory(node));
+        m_residentMemory += entry->getMemory();
     }
 
     // call the creation callback
@@ -329,31 +719,52 @@ bool TreeView::replaceNode(d3DisplayItem* entry,
     // get the lock
     m_pOsgWidget->lock();
 
-    // set the new node mask to match the old one
-    node->setNodeMask(entry->getNode()->getNodeMask());
+    // a posed item keeps its transform, only the node under it is replaced
+    osg::ref_ptr<osg::MatrixTransform> pose( entry->getPose() );
+    osg::ref_ptr<osg::Node> replaced( pose ? pose->getChild(0) : entry->getNode().get() );
+    if ( pose )
+    {
+        node->setNodeMask(pose->getChild(0)->getNodeMask());
+        pose->replaceChild(pose->getChild(0), node);
+    }
+    else
+    {
+        // set the new node mask to match the old one
+        node->setNodeMask(entry->getNode()->getNodeMask());
 
-    // conditionally remove this entry child from the display
-    if ( addToDisplay )
-        myParent->getNode()->asGroup()->removeChild(entry->getNode());
+        // conditionally remove this entry child from the display
+        if ( addToDisplay )
+            myParent->getNode()->asGroup()->removeChild(entry->getNode());
+    }
 
     // now lock the model view
     m_mutex.lock();
 
-    // set the node and enabled flags
-    entry->setNode(node);
+    // set the node and enabled flags - a new node replaces any evicted copy
+    entry->takeDeferred();
+    m_residentMemory -= entry->getMemory();
+    entry->setNode(pose ? pose.get() : node.get());
     entry->setEnabled(enableNode);
+    entry->setAddedToDisplay(addToDisplay);
+    entry->setEvictable(not pose);
+    entry->setMemory(addToDisplay ? estimateMemory(node) : 0);
+    m_residentMemory += entry->getMemory();
 
     // unlock the model view
     m_mutex.unlock();
 
     // now the entry is ready, so conditinoally add it back as a child to my
     // parent 
-    if ( addToDisplay )
+    if ( addToDisplay && not pose )
         myParent->getNode()->asGroup()->addChild(entry->getNode());
 
     // unlock osg
     m_pOsgWidget->unlock();
 
+    // don't tear down the old node here, it could be huge
+    if ( replaced != node )
+        m_pReclaimer->reclaim(replaced);
+
     return true;
 };
 
@@ -370,6 +781,8 @@ bool TreeView::addParent(const std::string& parentName,
                          const bool& addToDisplay,
                          d3DisplayItem* myParent)
 {
+    static const std::string splitIndicator("::");
+
     // see if the parent we are about to add as an offspring already exists
     d3DisplayItem* entry(findChild(myParent, parentName));
 
@@ -378,10 +791,11 @@ bool TreeView::addParent(const std::string& parentName,
     {
         // here is the entry named by the firstPart as a group
         entry = new d3DisplayItem(parentName,
-                                  path,
-                                  new osg::Group(),
+                                  path.substr(0, path.size() - childName.size() - splitIndicator.size()),
+                                  new Pooled<osg::Group>(),
                                   std::move(clickCallback));
         entry->setEnabled(true);
+        hideNewEntry(entry, true, myParent);
 
         // lock
         m_mutex.lock();
@@ -393,9 +807,13 @@ bool TreeView::addParent(const std::string& parentName,
 
         // add this entry to the item model
         myParent->appendRow(entry);
+        publish(entry);
 
         // set to accomodate this width
-        resizeColumnToContents(0);
+        {
+            StallWatchdog::ScopedPhase resizePhase(StallWatchdog::Phase::TREE_RESIZE);
+            resizeColumnToContents(0);
+        }
 
         // call the creation callback as we have created this thing
         creationCallback(entry);
@@ -427,6 +845,41 @@ bool TreeView::addParent(const std::string& parentName,
     return false;
 };
 
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+osg::ref_ptr<osg::MatrixTransform> TreeView::getManagedTransform(d3DisplayItem* item)
+{
+    if ( not item->getPose() )
+    {
+        // the transform goes above the real node, not an evicted placeholder
+        restore(item);
+
+        d3DisplayItem* parent( static_cast<d3DisplayItem*>(item->parent()) );
+        osg::ref_ptr<osg::Node> node( item->getNode() );
+        osg::ref_ptr<osg::MatrixTransform> pose( new osg::MatrixTransform() );
+        pose->setName(item->getPath());
+        pose->setDataVariance(osg::Object::DYNAMIC);
+
+        // the transform takes over the item's mask (an unchecked item's
+        // visible mask is in the prior node mask)
+        m_pOsgWidget->lock();
+        const osg::Node::NodeMask mask( node->getNodeMask() );
+        pose->setNodeMask(mask);
+        node->setNodeMask(0 == mask ? item->getPriorNodeMask() : mask);
+        pose->addChild(node);
+        if ( item->isAddedToDisplay() && parent )
+            parent->getNode()->asGroup()->replaceChild(node, pose);
+        item->setNode(pose);
+        m_pOsgWidget->unlock();
+
+        item->setPose(pose);
+        item->setPoseSlot(new PoseSlot(pose));
+        item->setEvictable(false);
+    }
+
+    return item->getPose();
+};
+
 /////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////
 TreeView::d3DisplayItem* TreeView::findChild(const d3DisplayItem* myParent,
@@ -442,6 +895,24 @@ TreeView::d3DisplayItem* TreeView::findChild(const d3DisplayItem* myParent,
     return nullptr;
 };
 
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+TreeView::d3DisplayItem* TreeView::findItem(const std::string& name) const
+{
+    static const std::string splitIndicator("::");
+
+    d3DisplayItem* item( m_pModel ? static_cast<d3DisplayItem*>(m_pModel->item(0)) : nullptr );
+    size_t begin(0);
+    while ( item && (begin <= name.size()) )
+    {
+        size_t end( name.find(splitIndicator, begin) );
+        if ( std::string::npos == end ) end = name.size();
+        item = findChild(item, name.substr(begin, end - begin));
+        begin = end + splitIndicator.size();
+    }
+    return item;
+};
+
 /////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////
 void TreeView::updateChildren(d3DisplayItem* item,
@@ -461,8 +932,10 @@ void TreeView::updateChildren(d3DisplayItem* item,
         ++ii;
     }
 
+    item->touch();
     if ( checked && Qt::Checked == item->checkState() )
     {
+        restore(item);
         item->getNode()->setNodeMask(item->getPriorNodeMask());
     }
     else if ( Qt::Checked == item->checkState() )
@@ -474,6 +947,330 @@ void TreeView::updateChildren(d3DisplayItem* item,
     {
         item->getNode()->setNodeMask(0);
     }
+    publish(item);
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void TreeView::enforceMemoryBudget()
+{
+    if ( (0 == m_memoryBudget) || (m_residentMemory <= m_memoryBudget) )
+        return;
+
+    // gather everything that is hidden and resident
+    std::vector<d3DisplayItem*> evictable;
+    d3DisplayItem* topItem( static_cast<d3DisplayItem*>(m_pModel->item(0)) );
+    if ( topItem )
+        for ( int ii(0) ; ii<topItem->rowCount() ; ++ii )
+            collectEvictable(static_cast<d3DisplayItem*>(topItem->child(ii)), evictable);
+
+    // the least recently viewed go first
+    std::sort(evictable.begin(), evictable.end(),
+              [](const d3DisplayItem* item0, const d3DisplayItem* item1)
+              {
+                  return item0->getLastViewed() < item1->getLastViewed();
+              });
+
+    for ( d3DisplayItem* item : evictable )
+    {
+        if ( m_residentMemory <= m_memoryBudget ) break;
+        evict(item);
+    }
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+bool TreeView::evict(d3DisplayItem* item)
+{
+    d3DisplayItem* parent( static_cast<d3DisplayItem*>(item->parent()) );
+    if ( not parent ) return false;
+
+    // serialize the node with the renderer locked out - the node is hidden,
+    // but its update callbacks (or whoever else holds it) could still be
+    // changing it
+    osg::ref_ptr<osg::Node> node( item->getNode() );
+    m_pOsgWidget->lock();
+
+    // the item and this function hold on to the node, anything more and
+    // it's someone else's (and would stay frozen once rebuilt)
+    static const unsigned int ownRefs(2);
+    std::shared_ptr<EvictedNode> evicted;
+    if ( isEvictable(node.get(), ownRefs) )
+        evicted = EvictedNode::evict(node, m_spillDirectory);
+    if ( not evicted )
+    {
+        m_pOsgWidget->unlock();
+        item->setEvictable(false);
+        return false;
+    }
+
+    // swap in an empty placeholder
+    osg::ref_ptr<osg::Node> placeholder( new Pooled<osg::Group>() );
+    placeholder->setNodeMask(node->getNodeMask());
+    parent->getNode()->asGroup()->replaceChild(node, placeholder);
+    item->setNode(placeholder);
+    m_pOsgWidget->unlock();
+
+    // release the GL objects and the arrays in the background
+    m_pReclaimer->reclaim(node);
+    item->setDeferred([evicted]() { return evicted->restore(); });
+
+    std::cout << "Evicted " << item->getPath() << " (" << item->getMemory()
+              << " bytes -> " << evicted->size() << " bytes)" << std::endl;
+
+    m_residentMemory -= item->getMemory();
+    item->setMemory(0);
+    return true;
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+bool TreeView::restore(d3DisplayItem* item)
+{
+    if ( not item->hasDeferred() ) return false;
+    d3DisplayItem* parent( static_cast<d3DisplayItem*>(item->parent()) );
+    if ( not parent ) return false;
+
+    // rebuild the node and swap it in for the placeholder
+    osg::ref_ptr<osg::Node> placeholder( item->getNode() );
+    osg::ref_ptr<osg::Node> node( item->takeDeferred()() );
+    node->setNodeMask(placeholder->getNodeMask());
+
+    m_pOsgWidget->lock();
+    if ( item->getPose() )
+    {
+        // a posed item keeps its transform, the placeholder is under it
+        node->setNodeMask(item->getPose()->getChild(0)->getNodeMask());
+        item->getPose()->replaceChild(item->getPose()->getChild(0), node);
+    }
+    else
+    {
+        if ( item->isAddedToDisplay() )
+            parent->getNode()->asGroup()->replaceChild(placeholder, node);
+        item->setNode(node);
+    }
+    m_pOsgWidget->unlock();
+
+    m_residentMemory -= item->getMemory();
+    item->setMemory(item->isAddedToDisplay() ? estimateMemory(node) : 0);
+    m_residentMemory += item->getMemory();
+    return true;
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void TreeView::collectEvictable(d3DisplayItem* item,
+                                std::vector<d3DisplayItem*>& evictable)
+{
+    if ( not item ) return;
+
+    // only leaves hold geometry we manage
+    if ( 0 != item->rowCount() )
+    {
+        for ( int ii(0) ; ii<item->rowCount() ; ++ii )
+            collectEvictable(static_cast<d3DisplayItem*>(item->child(ii)), evictable);
+        return;
+    }
+
+    const bool shown( (Qt::Checked == item->checkState()) && item->isEnabled() );
+    if ( (not shown) &&
+         item->isAddedToDisplay() &&
+         item->isEvictable() &&
+         (not item->hasDeferred()) &&
+         (0 != item->getMemory()) )
+    {
+        evictable.push_back(item);
+    }
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void TreeView::hideNewEntry(d3DisplayItem* entry,
+                            const bool& showNode,
+                            const d3DisplayItem* myParent) const
+{
+    const bool unchecked( (not showNode) || isHiddenByProfile(entry->getPath()) );
+    const bool parentHidden( (Qt::Checked != myParent->checkState()) || not myParent->isEnabled() );
+    if ( not (unchecked || parentHidden) ) return;
+
+    // the same state clicked() and updateChildren() would leave it in
+    if ( unchecked ) entry->setCheckState(Qt::Unchecked);
+    if ( parentHidden ) entry->setEnabled(false);
+    entry->setPriorNodeMask(entry->getNode()->getNodeMask());
+    entry->getNode()->setNodeMask(0);
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void TreeView::publish(const d3DisplayItem* item)
+{
+    // the top item isn't a namespace anyone adds to
+    if ( nullptr == item->parent() ) return;
+
+    const bool shown( (Qt::Checked == item->checkState()) && item->isEnabled() );
+    Subscriptions::get().publish(item->getPath(),
+                                 shown ? Subscriptions::State::SHOWN : Subscriptions::State::HIDDEN);
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+bool TreeView::isHiddenByProfile(const std::string& path) const
+{
+    if ( m_hiddenPatterns.empty() ) return false;
+
+    // shown again after a broader pattern hid it
+    if ( m_shownPaths.count(path) ) return false;
+
+    const QString qpath( QString::fromStdString(path) );
+    return std::any_of(m_hiddenPatterns.begin(), m_hiddenPatterns.end(),
+                       [&](const QRegExp& pattern) { return pattern.exactMatch(qpath); });
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void TreeView::saveVisibility(const d3DisplayItem* item)
+{
+    // hiding everything isn't worth remembering
+    if ( item == m_pModel->item(0) ) return;
+
+    // forget the exact path, hidden or shown - the path is escaped, so the
+    // wildcard characters in item names match only themselves
+    const QString path( escapedPath(item->getPath()) );
+    const size_t before( m_hiddenPatterns.size() + m_shownPaths.size() );
+    m_hiddenPatterns.erase(std::remove_if(m_hiddenPatterns.begin(), m_hiddenPatterns.end(),
+                                          [&](const QRegExp& pattern) { return pattern.pattern() == path; }),
+                           m_hiddenPatterns.end());
+    m_shownPaths.erase(item->getPath());
+    bool changed( before != m_hiddenPatterns.size() + m_shownPaths.size() );
+
+    // then remember it again if it's hidden and not already covered by a
+    // pattern, or if it's shown and a broader pattern still covers it
+    const bool hidden( Qt::Checked != item->checkState() );
+    if ( hidden != isHiddenByProfile(item->getPath()) )
+    {
+        if ( hidden )
+            m_hiddenPatterns.push_back(QRegExp(path, Qt::CaseSensitive, QRegExp::WildcardUnix));
+        else
+            m_shownPaths.insert(item->getPath());
+        changed = true;
+    }
+    if ( not changed ) return;
+
+    QStringList patterns;
+    for ( const QRegExp& pattern : m_hiddenPatterns )
+        patterns << pattern.pattern();
+    QStringList shown;
+    for ( const std::string& shownPath : m_shownPaths )
+        shown << QString::fromStdString(shownPath);
+    std::unique_ptr<QSettings> settings( visibilitySettings() );
+    settings->setValue("hidden", patterns);
+    settings->setValue("shown", shown);
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+QString TreeView::escapedPath(const std::string& path)
+{
+    QString escaped;
+    for ( const char& cc : path )
+    {
+        if ( ('\\' == cc) || ('*' == cc) || ('?' == cc) || ('[' == cc) )
+            escaped += '\\';
+        escaped += cc;
+    }
+    return escaped;
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+QSettings* TreeView::visibilitySettings()
+{
+    // one profile per application
+    QString application( QFileInfo(QCoreApplication::applicationFilePath()).fileName() );
+    if ( application.isEmpty() ) application = "d3";
+    return new QSettings("d3", "visibility_" + application);
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+DrawCostProfiler::Cost TreeView::updateCost(d3DisplayItem* item)
+{
+    DrawCostProfiler::Cost cost{0.0, 0.0, false};
+    if ( nullptr == item ) return cost;
+
+    // only the leaves are measured, the namespaces add them up
+    if ( 0 == item->rowCount() )
+    {
+        if ( item->getNode() )
+            cost = m_pProfiler->measure(item, item->getNode());
+    }
+    else
+    {
+        for ( int ii(0) ; ii<item->rowCount() ; ++ii )
+        {
+            const DrawCostProfiler::Cost child( updateCost(static_cast<d3DisplayItem*>(item->child(ii))) );
+            cost.cull_ms += child.cull_ms;
+            cost.draw_ms += child.draw_ms;
+            cost.gpu = cost.gpu || child.gpu;
+        }
+    }
+
+    // the cost column holds a number, so it sorts as one
+    QStandardItem* parent( item->parent() ? item->parent() : m_pModel->invisibleRootItem() );
+    QStandardItem* column( parent->child(item->row(), 1) );
+    if ( nullptr == column )
+    {
+        column = new QStandardItem();
+        column->setEditable(false);
+        parent->setChild(item->row(), 1, column);
+    }
+    column->setData(std::round(cost.total_ms() * 100.0) / 100.0, Qt::DisplayRole);
+    column->setToolTip(QString("cull %1 ms, draw %2 ms (%3 timed)")
+                       .arg(cost.cull_ms, 0, 'f', 3)
+                       .arg(cost.draw_ms, 0, 'f', 3)
+                       .arg(cost.gpu ? "GPU" : "CPU"));
+    return cost;
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void TreeView::removeCostColumn(QStandardItem* item)
+{
+    for ( int ii(0) ; ii<item->rowCount() ; ++ii )
+        removeCostColumn(item->child(ii));
+    item->setColumnCount(1);
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void TreeView::snapshot(const d3DisplayItem* item,
+                        std::vector<std::pair<std::string, osg::ref_ptr<osg::Node>>>& leaves,
+                        std::vector<SceneFinding>& findings) const
+{
+    if ( nullptr == item ) return;
+
+    if ( 0 == item->rowCount() )
+    {
+        if ( item->getNode() )
+            leaves.push_back(std::make_pair(item->getPath(), item->getNode()));
+        return;
+    }
+
+    // a chain of namespaces with a single item each (reported at its top)
+    const QStandardItem* parent( item->parent() );
+    if ( (nullptr == parent) || (nullptr == parent->parent()) || (1 != parent->rowCount()) )
+    {
+        size_t levels(0);
+        for ( const QStandardItem* link(item) ; 1 == link->rowCount() ; link = link->child(0) )
+            ++levels;
+
+        SceneFinding finding;
+        if ( namespaceChain(item->getPath(), levels, finding) )
+            findings.push_back(finding);
+    }
+
+    for ( int ii(0) ; ii<item->rowCount() ; ++ii )
+        snapshot(static_cast<d3DisplayItem*>(item->child(ii)), leaves, findings);
 };
 
 } // namespace d3
@@ -15,10 +15,29 @@
 #include <QtGui/QApplication>
 #include <QtGui/QtGui>
 #include <QtGui/QSplitter>
+#include <QtCore/QRegExp>
+#include <QtCore/QSettings>
 
+#include "DrawCostProfiler.h"
+#include "LatencyTracker.h"
+#include "OcclusionCulling.h"
+#include "PoseHandle.h"
+#include "Reclaimer.h"
+#include "SceneAnalyzer.h"
+#include "Style.h"
+#include "Subscriptions.h"
+
+#include <DDDisplayObjects/Pool.h>
+
+#include <osg/MatrixTransform>
 #include <osg/Node>
+#include <chrono>
 #include <mutex>
 #include <functional>
+#include <future>
+#include <memory>
+#include <set>
+#include <vector>
 
 namespace d3
 {
@@ -40,9 +59,11 @@ class TreeView : public QTreeView
 
     /////////////////////////////////////////////////////////////////
     /// @brief   Override the standard qitem for the tree view so we can hold an
-    ///          osg node and name of the item
+    ///          osg node and name of the item - the items come and go with
+    ///          every add(), so they come from the pool and their name and path
+    ///          are interned
     /////////////////////////////////////////////////////////////////
-    class d3DisplayItem : public QStandardItem
+    class d3DisplayItem : public QStandardItem, public PoolAllocated
     {
       public:
         /// @brief   Construct with a name and node
@@ -56,11 +77,20 @@ class TreeView : public QTreeView
                       const osg::ref_ptr<osg::Node> node,
                       std::function<void(d3DisplayItem*)>&& clickCallback) :
             QStandardItem(QString(name.c_str())),
-            m_name(name),
-            m_path(path),
+            m_name(&intern(name)),
+            m_path(&intern(path)),
             m_node(node),
             m_priorNodeMask(node->getNodeMask()),
-            m_clickCallback(clickCallback)
+            m_hiddenViews(0),
+            m_viewedNodeMask(node->getNodeMask()),
+            m_clickCallback(clickCallback),
+            m_addedToDisplay(false),
+            m_memory(0),
+            m_evictable(true),
+            m_lastViewed(std::chrono::steady_clock::now()),
+            m_deferred(),
+            m_pose(),
+            m_poseSlot()
         {
             setEditable(true);
             setCheckable(true);
@@ -72,12 +102,41 @@ class TreeView : public QTreeView
 
         /// @{
         /// @brief   Accessors
-        const std::string& getName() const { return m_name; };
-        const std::string& getPath() const { return m_path; };
-        const osg::ref_ptr<osg::Node> getNode()  { return m_node; };
+        const std::string& getName() const { return *m_name; };
+        const std::string& getPath() const { return *m_path; };
+        const osg::ref_ptr<osg::Node> getNode() const { return m_node; };
         void setNode(osg::ref_ptr<osg::Node> node) { m_node = node; };
         void setPriorNodeMask(const osg::Node::NodeMask& mask) { m_priorNodeMask = mask; };
         const osg::Node::NodeMask& getPriorNodeMask() const { return m_priorNodeMask; };
+        void setHiddenViews(const osg::Node::NodeMask& views) { m_hiddenViews = views; };
+        const osg::Node::NodeMask& getHiddenViews() const { return m_hiddenViews; };
+        void setViewedNodeMask(const osg::Node::NodeMask& mask) { m_viewedNodeMask = mask; };
+        const osg::Node::NodeMask& getViewedNodeMask() const { return m_viewedNodeMask; };
+        void setAddedToDisplay(const bool& added) { m_addedToDisplay = added; };
+        const bool& isAddedToDisplay() const { return m_addedToDisplay; };
+        void setMemory(const size_t& bytes) { m_memory = bytes; };
+        const size_t& getMemory() const { return m_memory; };
+        void setEvictable(const bool& evictable) { m_evictable = evictable; };
+        const bool& isEvictable() const { return m_evictable; };
+        void touch() { m_lastViewed = std::chrono::steady_clock::now(); };
+        const std::chrono::steady_clock::time_point& getLastViewed() const { return m_lastViewed; };
+        void setPose(osg::ref_ptr<osg::MatrixTransform> pose) { m_pose = pose; };
+        const osg::ref_ptr<osg::MatrixTransform>& getPose() const { return m_pose; };
+        void setPoseSlot(osg::ref_ptr<PoseSlot> slot) { m_poseSlot = slot; };
+        const osg::ref_ptr<PoseSlot>& getPoseSlot() const { return m_poseSlot; };
+        /// @}
+
+        /// @{
+        /// @name    A deferred node is built the next time this item is shown
+        ///          (i.e. an item whose geometry has been evicted)
+        void setDeferred(std::function<osg::ref_ptr<osg::Node>()>&& deferred) { m_deferred = std::move(deferred); };
+        bool hasDeferred() const { return static_cast<bool>(m_deferred); };
+        std::function<osg::ref_ptr<osg::Node>()> takeDeferred()
+        {
+            std::function<osg::ref_ptr<osg::Node>()> deferred;
+            std::swap(deferred, m_deferred);
+            return deferred;
+        };
         /// @}
 
         /// Method to run the click callback
@@ -86,11 +145,11 @@ class TreeView : public QTreeView
         
       private:
 
-        /// The name
-        std::string                                 m_name;
+        /// The name (interned)
+        const std::string*                          m_name;
 
-        /// The path (i.e. the full grandparent::parent::child name)
-        std::string                                 m_path;
+        /// The path (i.e. the full grandparent::parent::child name, interned)
+        const std::string*                          m_path;
 
         /// The node
         osg::ref_ptr<osg::Node>                     m_node;
@@ -98,8 +157,36 @@ class TreeView : public QTreeView
         /// The old node mask
         osg::Node::NodeMask                         m_priorNodeMask;
 
+        /// The bits of the viewports the node is hidden in
+        osg::Node::NodeMask                         m_hiddenViews;
+
+        /// The node mask from before it was hidden in any viewport
+        osg::Node::NodeMask                         m_viewedNodeMask;
+
         /// A registered function to run on click
         std::function<void(d3DisplayItem*)>         m_clickCallback;
+
+        /// Did the tree view add the node to the osg display graph
+        bool                                        m_addedToDisplay;
+
+        /// The estimated memory held by the node
+        size_t                                      m_memory;
+
+        /// Can the node be serialized for eviction
+        bool                                        m_evictable;
+
+        /// The last time the item was shown or hidden
+        std::chrono::steady_clock::time_point       m_lastViewed;
+
+        /// The builder for the node when it is not resident
+        std::function<osg::ref_ptr<osg::Node>()>    m_deferred;
+
+        /// The managed transform above the node (the item's node), once the
+        /// item has been posed
+        osg::ref_ptr<osg::MatrixTransform>          m_pose;
+
+        /// The poses for the managed transform, shared by its handles
+        osg::ref_ptr<PoseSlot>                      m_poseSlot;
     };
 
     /// @brief   Constructor
@@ -136,19 +223,146 @@ class TreeView : public QTreeView
              const bool& addToDisplay = true,
              std::function<void(d3DisplayItem*)>&& clickCallback = [](d3DisplayItem*){},
              std::function<void(d3DisplayItem*)>&& creationCallback = [](d3DisplayItem*){});
-             
+
+    /// @brief   Method to add an object submitted through the display interface
+    /// @param   name The name associated with the node
+    /// @param   node The node
+    /// @param   showNode A flag to indicate if the node should be shown
+    ///          initially or not
+    /// @param   addToDisplay A flag to indicate if we should add this node to
+    ///          the display graph
+    /// @param   submitted_ns When the add was submitted, for the latency
+    ///
+    /// This is add() with the occlusion culling applied to the node, and the
+    /// node followed to the screen by the latency tracker.
+    bool submit(const std::string& name,
+                const osg::ref_ptr<osg::Node> node,
+                const bool& showNode,
+                const bool& addToDisplay,
+                const int64_t& submitted_ns);
+
+    /// @brief   Method to add an object which is only built once it is shown
+    /// @param   name The name associated with the node
+    /// @param   builder The function which builds the node
+    /// @param   showNode A flag to indicate if the node should be shown
+    ///          initially or not
+    /// @param   addToDisplay A flag to indicate if we should add this node to
+    ///          the display graph
+    ///
+    /// If the item starts out hidden (by showNode, the visibility profile or
+    /// a hidden parent), the builder isn't run until the item is checked.
+    bool addDeferred(const std::string& name,
+                     std::function<osg::ref_ptr<osg::Node>()>&& builder,
+                     const bool& showNode,
+                     const bool& addToDisplay = true);
+
+    /// @brief   Set the memory budget for the displayed items
+    /// @param   bytes The number of bytes the displayed items may hold before
+    ///          hidden items are evicted (0 means no limit)
+    /// @param   spillDirectory Where evicted items are written, leave empty to
+    ///          keep the (compressed) evicted items in RAM
+    ///
+    /// When over budget, hidden items are evicted least recently viewed first:
+    /// their GL objects and arrays are released and a compressed serialized
+    /// copy is kept. The item is rebuilt from this copy when it is shown again.
+    void setMemoryBudget(const size_t& bytes,
+                         const std::string& spillDirectory = "");
+
+    /// @brief   Put the heavy parts of the submitted items behind occlusion
+    ///          queries
+    /// @param   minVertices How many vertices a geode needs before it's worth
+    ///          a query (0 turns it off)
+    ///
+    /// This applies to the items submitted from here on.
+    void setOcclusionCulling(const size_t& minVertices);
+
+    /// @brief   Get the estimated memory held by the resident displayed items
+    size_t getResidentMemory() const { return m_residentMemory; };
+
+    /// @brief   Show or hide an item in one viewport only
+    /// @param   name The full name of the item (i.e. "AA::BB::CC")
+    /// @param   viewMask The node mask bit of the viewport
+    /// @param   visible Should the item be drawn in that viewport
+    /// @return  boolean True if the item was found
+    ///
+    /// This is on top of the check box - an unchecked item is hidden in every
+    /// viewport, and keeps its per-viewport visibility for when it's checked.
+    /// While it's hidden in any viewport, its node mask is only the bits of
+    /// the viewports it's drawn in, and its own mask comes back once it's
+    /// shown in all of them again.
+    bool setVisibleInView(const std::string& name,
+                          const osg::Node::NodeMask& viewMask,
+                          const bool& visible);
+
+    /// @brief   Get a handle to set the pose of an item
+    /// @param   name The full name of the item (i.e. "AA::BB::CC")
+    /// @return  PoseHandle The handle, invalid if there is no such item
+    ///
+    /// The first time, the item is wrapped in a managed transform. After that
+    /// its node is the transform, so the check box and the viewport masks
+    /// apply to it, and re-adding the item replaces what's under it (keeping
+    /// the pose). The children of the item move with it. Posed items are not
+    /// evicted, since the handles hold on to the transform.
+    PoseHandle getPoseHandle(const std::string& name);
+
+    /// @brief   Restyle an item (its color, opacity, point size and line width)
+    /// @param   name The full name of the item (i.e. "AA::BB::CC")
+    /// @param   style The style, Style::none() to take it back off
+    /// @return  boolean True if the item was found
+    ///
+    /// The style goes on the same managed transform as the pose, so it lasts
+    /// through re-adding the item, and applies to the children of the item.
+    /// It's applied in the next update traversal (only the newest one, if
+    /// it's set more than once a frame), and nothing is rebuilt.
+    bool setStyle(const std::string& name,
+                  const Style& style);
+
+    /// @brief   Look for the usual performance problems in the displayed items
+    /// @return  std::shared_future<std::vector<SceneFinding>> The findings,
+    ///          most expensive first, once the analysis is done
+    ///
+    /// The items are snapshotted (their subgraphs are held on to) and analyzed
+    /// on the shared workers. The subgraphs are live, so each one is walked
+    /// with the renderer locked out, one item at a time, and the display keeps
+    /// rendering in between. When it's done, the items with problems get a
+    /// warning icon, with the details and suggestions in their tool tip, and
+    /// so do the namespaces above them (with the total), so the problems show
+    /// even when the tree is collapsed. If an analysis is already running,
+    /// this returns that one.
+    std::shared_future<std::vector<SceneFinding>> analyze();
+
+    /// @brief   Get the add-to-display latency tracker
+    const osg::ref_ptr<LatencyTracker>& getLatencyTracker() const { return m_pLatency; };
 
   public Q_SLOTS:
 
     /// @brief   Method to call when the frame is clicked
     void clicked(const QModelIndex& index);
 
+    /// @brief   Turn the draw cost profiling on or off
+    /// @param   enable Should the items be profiled
+    ///
+    /// While profiling, every item's subgraph has its cull and draw timed (on
+    /// the GPU if we can), and a sortable column shows the cost per frame
+    /// averaged over the last few seconds. The namespaces show the sum of
+    /// their items. The column is sorted by cost, so the items worth hiding
+    /// or decimating are at the top.
+    void setProfiling(bool enable);
+
     /// @brief   Method to reset the column width when something is expanded
     void expanded(const QModelIndex& index);
     
     /// @brief   Method to reset the column width when something is collapsed
     void collapsed(const QModelIndex& index);
 
+  private Q_SLOTS:
+
+    /// @brief   Roll the profiled costs and update the cost column
+    void updateCosts();
+
+    /// @brief   Flag the items with findings from the last analysis
+    void showFindings();
+
   private:
 
     /// @brief   Internal ethod to add an object to the osg display
@@ -223,13 +437,79 @@ class TreeView : public QTreeView
                    const bool& addToDisplay,
                    d3DisplayItem* myParent);
 
+    /// @brief   Get the managed transform above an item, wrapping the item in
+    ///          one the first time (with the lock)
+    /// @return  osg::ref_ptr<osg::MatrixTransform> The transform
+    osg::ref_ptr<osg::MatrixTransform> getManagedTransform(d3DisplayItem* item);
+
     /// @brief   Method to find and return a pointer to the child of parent with name
     static d3DisplayItem* findChild(const d3DisplayItem* myParent,
                                     const std::string& name);
 
-    /// @brief
-    static void updateChildren(d3DisplayItem* item,
-                               const bool& checked);
+    /// @brief   Find an item by its full name (i.e. "AA::BB::CC")
+    d3DisplayItem* findItem(const std::string& name) const;
+
+    /// @brief   Recursively update the enabled state and node masks of the
+    ///          children of an item whose check state changed
+    void updateChildren(d3DisplayItem* item,
+                        const bool& checked);
+
+    /// @brief   Evict hidden items (least recently viewed first) until we
+    ///          are within the memory budget
+    void enforceMemoryBudget();
+
+    /// @brief   Release the node of an item, keeping a serialized copy
+    /// @return  boolean True if the item was evicted
+    bool evict(d3DisplayItem* item);
+
+    /// @brief   Rebuild the node of an item if it is not resident
+    /// @return  boolean True if the item was rebuilt
+    bool restore(d3DisplayItem* item);
+
+    /// @brief   Gather the hidden, resident leaves which could be evicted
+    static void collectEvictable(d3DisplayItem* item,
+                                 std::vector<d3DisplayItem*>& evictable);
+
+    /// @brief   Hide a new item before its node goes into the display, if it
+    ///          should start out hidden
+    /// @param   entry The new item
+    /// @param   showNode Was the item added to be shown
+    /// @param   myParent The parent of the new item
+    void hideNewEntry(d3DisplayItem* entry,
+                      const bool& showNode,
+                      const d3DisplayItem* myParent) const;
+
+    /// @brief   Publish whether an item is being looked at, for the producers
+    ///          (see Subscriptions)
+    static void publish(const d3DisplayItem* item);
+
+    /// @brief   Is a path hidden by the visibility profile
+    bool isHiddenByProfile(const std::string& path) const;
+
+    /// @brief   Remember (or forget) an item the user hid in the visibility
+    ///          profile and save the profile
+    void saveVisibility(const d3DisplayItem* item);
+
+    /// @brief   Escape a path to match only itself as a wildcard pattern
+    static QString escapedPath(const std::string& path);
+
+    /// @brief   The settings holding the visibility profile of this
+    ///          application
+    static QSettings* visibilitySettings();
+
+    /// @brief   Measure an item (or sum its children) and show the cost
+    DrawCostProfiler::Cost updateCost(d3DisplayItem* item);
+
+    /// @brief   Take the cost column back out of an item and its children
+    static void removeCostColumn(QStandardItem* item);
+
+    /// @brief   Snapshot the items for the analysis
+    /// @param   item The item to start from
+    /// @param   leaves The leaf items and their subgraphs, to analyze
+    /// @param   findings Where to put the findings from the tree itself
+    void snapshot(const d3DisplayItem* item,
+                  std::vector<std::pair<std::string, osg::ref_ptr<osg::Node>>>& leaves,
+                  std::vector<SceneFinding>& findings) const;
 
     /// The osg widget
     QOSGWidget*               m_pOsgWidget;
@@ -239,6 +519,57 @@ class TreeView : public QTreeView
 
     /// The model protection
     std::recursive_mutex      m_mutex;
+
+    /// The pose updates for the next frame
+    osg::ref_ptr<PoseQueue>   m_pPoseQueue;
+
+    /// The style updates for the next frame
+    osg::ref_ptr<StyleQueue>  m_pStyleQueue;
+
+    /// Follows the added items to the screen
+    osg::ref_ptr<LatencyTracker> m_pLatency;
+
+    /// Tears down the replaced nodes
+    osg::ref_ptr<Reclaimer>   m_pReclaimer;
+
+    /// The memory budget in bytes (0 means no limit)
+    size_t                    m_memoryBudget;
+
+    /// Where to spill evicted items (empty means keep them in RAM)
+    std::string               m_spillDirectory;
+
+    /// The estimated memory held by the resident items
+    size_t                    m_residentMemory;
+
+    /// The vertices a geode needs to go behind an occlusion query (0 is off)
+    size_t                    m_occlusionVertices;
+
+    /// The visibility profile - wildcard patterns of the paths of the hidden
+    /// items (the escaped exact paths of the items the user unchecked, and
+    /// any patterns written into the settings by hand)
+    std::vector<QRegExp>      m_hiddenPatterns;
+
+    /// The paths the user checked again while a broader pattern still hides
+    /// them (these win over the patterns)
+    std::set<std::string>     m_shownPaths;
+
+    /// The draw cost profiler, while profiling
+    std::unique_ptr<DrawCostProfiler> m_pProfiler;
+
+    /// The timer to roll the profiled costs
+    QTimer                    m_profileTimer;
+
+    /// Protect the analysis
+    std::mutex                m_analysisMutex;
+
+    /// The last (or running) analysis
+    std::shared_future<std::vector<SceneFinding>> m_analysis;
+
+    /// The findings of the last analysis to finish, for showFindings()
+    std::vector<SceneFinding> m_findings;
+
+    /// The items flagged by the last analysis
+    std::vector<std::string>  m_flagged;
 };
 
 } // namespace d3
@@ -0,0 +1,287 @@
+/////////////////////////////////////////////////////////////////
+/// @file      AccumulatedCloud.cpp
+/// @author    Chris L Baker (clb) <chris@chimail.net>
+/// @date      2026.10.18
+/// @brief     Incrementally build a map from scans, one point per voxel
+///
+/// @attention Copyright (C) 2026
+/// @attention All rights reserved
+/////////////////////////////////////////////////////////////////
+
+#include "AccumulatedCloud.h"
+#include "Parallel.h"
+#include "VoxelHash.h"
+
+#include <osg/Geode>
+#include <osg/Geometry>
+#include <osg/Point>
+#include <osg/Version>
+
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <unordered_set>
+
+namespace d3
+{
+
+namespace
+{
+
+/// The number of points in a chunk of geometry
+const size_t chunkSize(1 << 16);
+
+/// The rough cost of a point - the vertex, color, voxel key and hash node, and
+/// the copy on the graphics card
+const size_t bytesPerPoint( 2 * (sizeof(osg::Vec3) + sizeof(osg::Vec4)) + 2 * sizeof(VoxelKey) );
+
+} // namespace
+
+/////////////////////////////////////////////////////////////////
+/// @brief   The voxels and the geometry chunks - an update callback on the
+///          display root so the new points get appended in the update traversal
+/////////////////////////////////////////////////////////////////
+class AccumulatedCloud::Chunks : public osg::NodeCallback
+{
+  public:
+
+    Chunks(const double& leafSize,
+           const size_t& memoryBudget,
+           const float& pointSize) :
+        m_leafSize(leafSize),
+        m_maxPoints(std::max(chunkSize, memoryBudget / bytesPerPoint)),
+        m_mutex(),
+        m_voxels(),
+        m_pendingPoints(),
+        m_pendingKeys(),
+        m_chunks(),
+        m_clear(false),
+        m_geode(new osg::Geode())
+    {
+        osg::ref_ptr<osg::StateSet> stateSet( m_geode->getOrCreateStateSet() );
+        stateSet->setAttribute(new osg::Point(pointSize), osg::StateAttribute::ON);
+        stateSet->setMode(GL_LIGHTING, osg::StateAttribute::OFF);
+    };
+
+    osg::ref_ptr<osg::Geode> getGeode() const { return m_geode; };
+
+    size_t add(const PointVec_t& scan)
+    {
+        // the hashing doesn't need the lock
+        std::vector<VoxelKey> keys( scan.size() );
+        parallelFor(scan.size(), 1 << 15,
+                    [&](size_t begin, size_t end, size_t)
+                    {
+                        for ( size_t ii(begin) ; ii<end ; ++ii )
+                            keys[ii] = toVoxelKey(scan[ii].location, m_leafSize);
+                    });
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const size_t before( m_pendingPoints.size() );
+        for ( size_t ii(0) ; ii<scan.size() ; ++ii )
+        {
+            if ( not m_voxels.insert(keys[ii]).second ) continue;
+            m_pendingPoints.push_back(scan[ii]);
+            m_pendingKeys.push_back(keys[ii]);
+        }
+        const size_t added( m_pendingPoints.size() - before );
+
+        // the update traversal doesn't run while the layer is hidden, so the
+        // pending points have to be held to the budget here - the oldest go
+        if ( m_pendingPoints.size() > m_maxPoints )
+        {
+            const size_t excess( m_pendingPoints.size() - m_maxPoints );
+            for ( size_t ii(0) ; ii<excess ; ++ii )
+                m_voxels.erase(m_pendingKeys[ii]);
+            m_pendingPoints.erase(m_pendingPoints.begin(), m_pendingPoints.begin() + excess);
+            m_pendingKeys.erase(m_pendingKeys.begin(), m_pendingKeys.begin() + excess);
+        }
+        return added;
+    };
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_voxels.clear();
+        m_pendingPoints.clear();
+        m_pendingKeys.clear();
+        m_clear = true;
+    };
+
+    size_t size()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_voxels.size();
+    };
+
+    /// @brief   Append the new points, drop the old ones, then carry on
+    virtual void operator()(osg::Node* node, osg::NodeVisitor* nv)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if ( m_clear )
+            {
+                m_geode->removeDrawables(0, m_geode->getNumDrawables());
+                m_chunks.clear();
+                m_clear = false;
+            }
+
+            if ( not m_pendingPoints.empty() )
+            {
+                append();
+                dropOldest();
+            }
+        }
+        traverse(node, nv);
+    };
+
+  private:
+
+    /// @brief   A chunk of the map
+    struct Chunk
+    {
+        /// The voxels in this chunk, so they can be freed when it's dropped
+        std::vector<VoxelKey>        keys;
+
+        /// The geometry
+        osg::ref_ptr<osg::Geometry>  geometry;
+    };
+
+    /// @brief   Start a new chunk
+    void newChunk()
+    {
+        osg::ref_ptr<osg::Vec3Array> verts( new osg::Vec3Array() );
+        verts->reserve(chunkSize);
+        osg::ref_ptr<osg::Vec4Array> colors( new osg::Vec4Array() );
+        colors->reserve(chunkSize);
+
+        Chunk chunk;
+        chunk.keys.reserve(chunkSize);
+        chunk.geometry = new osg::Geometry();
+        chunk.geometry->setDataVariance(osg::Object::DYNAMIC);
+        chunk.geometry->setUseDisplayList(false);
+        chunk.geometry->setUseVertexBufferObjects(true);
+        chunk.geometry->setVertexArray(verts);
+#if      OSG_MIN_VERSION_REQUIRED(3,2,0)
+        chunk.geometry->setColorArray(colors, osg::Array::Binding::BIND_PER_VERTEX);
+#else    // OSG_MIN_VERSION_REQUIRED(3,2,0)
+        chunk.geometry->setColorArray(colors);
+        chunk.geometry->setColorBinding(osg::Geometry::BIND_PER_VERTEX);
+#endif   // OSG_MIN_VERSION_REQUIRED(3,2,0)
+        chunk.geometry->addPrimitiveSet(new osg::DrawArrays(osg::PrimitiveSet::POINTS, 0, 0));
+
+        m_geode->addDrawable(chunk.geometry);
+        m_chunks.push_back(std::move(chunk));
+    };
+
+    /// @brief   Append the pending points to the newest chunks - only the
+    ///          chunks which changed get uploaded again
+    void append()
+    {
+        size_t next(0);
+        while ( next < m_pendingPoints.size() )
+        {
+            if ( m_chunks.empty() || (m_chunks.back().keys.size() >= chunkSize) )
+                newChunk();
+
+            Chunk& chunk( m_chunks.back() );
+            osg::Vec3Array* verts( static_cast<osg::Vec3Array*>(chunk.geometry->getVertexArray()) );
+            osg::Vec4Array* colors( static_cast<osg::Vec4Array*>(chunk.geometry->getColorArray()) );
+
+            const size_t end( std::min(m_pendingPoints.size(), next + chunkSize - chunk.keys.size()) );
+            for ( ; next<end ; ++next )
+            {
+                verts->push_back(m_pendingPoints[next].location);
+                colors->push_back(m_pendingPoints[next].color);
+                chunk.keys.push_back(m_pendingKeys[next]);
+            }
+
+            static_cast<osg::DrawArrays*>(chunk.geometry->getPrimitiveSet(0))->setCount(verts->size());
+            chunk.geometry->getPrimitiveSet(0)->dirty();
+            verts->dirty();
+            colors->dirty();
+            chunk.geometry->dirtyBound();
+        }
+
+        m_pendingPoints.clear();
+        m_pendingKeys.clear();
+    };
+
+    /// @brief   Drop the oldest chunks while we're over budget
+    void dropOldest()
+    {
+        while ( (m_voxels.size() > m_maxPoints) && (m_chunks.size() > 1) )
+        {
+            for ( const VoxelKey& key : m_chunks.front().keys )
+                m_voxels.erase(key);
+            m_geode->removeDrawable(m_chunks.front().geometry);
+            m_chunks.pop_front();
+        }
+    };
+
+    /// The size of the voxels
+    double                                          m_leafSize;
+
+    /// The most points (occupied voxels) we keep
+    size_t                                          m_maxPoints;
+
+    /// Protect everything below
+    std::mutex                                      m_mutex;
+
+    /// The occupied voxels
+    std::unordered_set<VoxelKey, VoxelKeyHash>      m_voxels;
+
+    /// The points in newly occupied voxels, waiting for the update traversal
+    PointVec_t                                      m_pendingPoints;
+    std::vector<VoxelKey>                           m_pendingKeys;
+
+    /// The chunks, oldest first
+    std::deque<Chunk>                               m_chunks;
+
+    /// Should the chunks be thrown away
+    bool                                            m_clear;
+
+    /// The geode holding the chunks
+    osg::ref_ptr<osg::Geode>                        m_geode;
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+AccumulatedCloud::AccumulatedCloud(const double& leafSize,
+                                   const size_t& memoryBudget /* = 512*1024*1024 */,
+                                   const float& pointSize /* = 3.0 */) :
+    m_chunks(new Chunks(leafSize, memoryBudget, pointSize)),
+    m_root(new osg::Group())
+{
+    m_root->addChild(m_chunks->getGeode());
+    m_root->setUpdateCallback(m_chunks);
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+AccumulatedCloud::~AccumulatedCloud()
+{
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+size_t AccumulatedCloud::add(const PointVec_t& scan)
+{
+    return m_chunks->add(scan);
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void AccumulatedCloud::clear()
+{
+    m_chunks->clear();
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+size_t AccumulatedCloud::size() const
+{
+    return m_chunks->size();
+};
+
+} // namespace d3
@@ -0,0 +1,95 @@
+/////////////////////////////////////////////////////////////////
+/// @file      AccumulatedCloud.h
+/// @author    Chris L Baker (clb) <chris@chimail.net>
+/// @date      2026.10.18
+/// @brief     Incrementally build a map from scans, one point per voxel
+///
+/// @attention Copyright (C) 2026
+/// @attention All rights reserved
+/////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Points.h"
+
+#include <osg/Group>
+
+namespace d3
+{
+
+/////////////////////////////////////////////////////////////////
+/// @brief   Integrate scans into a map made of one point per occupied voxel
+///
+/// Re-adding the union of all the scans so far rebuilds everything each time,
+/// and the union grows without bound. This keeps a spatial hash of the
+/// occupied voxels instead, so a scan only appends the points in newly
+/// occupied voxels. Those get appended to fixed size chunks of vertex buffers,
+/// so the cost of a scan is proportional to the scan and not the map. Once the
+/// map goes over its memory budget, the oldest chunks are dropped (and their
+/// voxels can be filled again).
+///
+/// @code
+/// static d3::AccumulatedCloud map(0.05);
+/// map.add(scan);
+/// d3::di().add( "slam::map", map.get() );
+/// @endcode
+/////////////////////////////////////////////////////////////////
+class AccumulatedCloud
+{
+  public:
+
+    /// @{
+    /// @name Noncopyable
+    AccumulatedCloud(const AccumulatedCloud&) = delete;
+    AccumulatedCloud& operator=(const AccumulatedCloud&) = delete;
+    /// @}
+
+    /// @brief   Constructor
+    /// @param   leafSize The size of the voxels
+    /// @param   memoryBudget The most memory (in bytes) the map should use
+    /// @param   pointSize The size of the points
+    AccumulatedCloud(const double& leafSize,
+                     const size_t& memoryBudget = 512*1024*1024,
+                     const float& pointSize = 3.0);
+
+    /// @brief   Destructor
+    ~AccumulatedCloud();
+
+    /// @brief   Integrate a scan into the map
+    /// @param   scan The points in the scan
+    /// @return  size_t The number of newly occupied voxels
+    ///
+    /// While the map is hidden (so it isn't updated), the points waiting to be
+    /// drawn are held to the budget too, dropping the oldest of them.
+    size_t add(const PointVec_t& scan);
+
+    /// @brief   Throw away the whole map
+    void clear();
+
+    /// @brief   The number of occupied voxels in the map
+    size_t size() const;
+
+    /// @brief   Access to the display root
+    osg::ref_ptr<osg::Group> get() const { return m_root; };
+
+  private:
+
+    /// The voxels and the chunks of geometry (defined in the .cpp)
+    class Chunks;
+
+    /// The voxels, also the update callback on the root
+    osg::ref_ptr<Chunks>      m_chunks;
+
+    /// The root of the display
+    osg::ref_ptr<osg::Group>  m_root;
+};
+
+/// @brief   get an osg node from an accumulated cloud
+/// @param   cloud The map to display
+/// @return  osg::ref_ptr<osg::Node> The node for the di().add() call
+inline osg::ref_ptr<osg::Node> get(const AccumulatedCloud& cloud)
+{
+    return cloud.get();
+};
+
+} // namespace d3
@@ -9,6 +9,7 @@
 /////////////////////////////////////////////////////////////////
 
 #include "CameraImages.h"
+#include "ImageCache.h"
 
 #include <osg/Geometry>
 #include <osg/Texture2D>
@@ -18,6 +19,32 @@
 namespace d3
 {
 
+namespace
+{
+
+/// The size of the placeholder frame, until the image is decoded
+const int placeholderWidth(640), placeholderHeight(480);
+
+/// @brief   Size the quad for an image of s x t pixels
+void setQuad(osg::Vec3Array& quad,
+             const CameraImage& image,
+             const int& ss,
+             const int& tt)
+{
+    // compute the new image width and height
+    double ww( static_cast<double>(ss) * image.scale/image.focalLengthX_pix );
+    double hh( static_cast<double>(tt) * image.scale/image.focalLengthY_pix );
+
+    quad.resize(4);
+    quad[0].set( -ww/2.0, -hh/2.0, image.scale );
+    quad[1].set(  ww/2.0, -hh/2.0, image.scale );
+    quad[2].set(  ww/2.0,  hh/2.0, image.scale );
+    quad[3].set( -ww/2.0,  hh/2.0, image.scale );
+    quad.dirty();
+};
+
+} // namespace
+
 /////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////
 osg::ref_ptr<osg::Node> get(const CameraImageVec_t& images)
@@ -26,16 +53,12 @@ osg::ref_ptr<osg::Node> get(const CameraImageVec_t& images)
 
     for ( const auto& image : images )
     {
-        // compute the new image width and height
-        double ww( static_cast<double>(image.image->s()) * image.scale/image.focalLengthX_pix );
-        double hh( static_cast<double>(image.image->t()) * image.scale/image.focalLengthY_pix );
-
         // here we create a quad that will be texture mapped with the image
         osg::ref_ptr<osg::Vec3Array> quad( new osg::Vec3Array() );
-        quad->push_back( osg::Vec3( -ww/2.0, -hh/2.0, image.scale ) );
-        quad->push_back( osg::Vec3(  ww/2.0, -hh/2.0, image.scale ) );
-        quad->push_back( osg::Vec3(  ww/2.0,  hh/2.0, image.scale ) );
-        quad->push_back( osg::Vec3( -ww/2.0,  hh/2.0, image.scale ) );
+        if ( image.image )
+            setQuad( *quad, image, image.image->s(), image.image->t() );
+        else
+            setQuad( *quad, image, placeholderWidth, placeholderHeight );
         osg::ref_ptr<osg::Geometry> geo( new osg::Geometry() );
         geo->setVertexArray( quad );
 
@@ -63,7 +86,6 @@ osg::ref_ptr<osg::Node> get(const CameraImageVec_t& images)
         // create the texture for the image
         osg::ref_ptr<osg::Texture2D> texture( new osg::Texture2D() );
         texture->setDataVariance(osg::Object::DYNAMIC);
-        texture->setImage( image.image );
 
         // put this in decal mode
         osg::ref_ptr<osg::TexEnv> decalTexEnv( new osg::TexEnv() );
@@ -84,6 +106,19 @@ osg::ref_ptr<osg::Node> get(const CameraImageVec_t& images)
         xform->setMatrix(image.cameraPose);
         xform->addChild(geode);
 
+        // the image is shown now, or once it's decoded (and the quad is sized
+        // to it then)
+        if ( image.image )
+            texture->setImage( image.image );
+        else
+            loadTexture( *xform, *texture, image.path,
+                         [quad, geo, image](const osg::Image& loaded)
+                         {
+                             setQuad( *quad, image, loaded.s(), loaded.t() );
+                             geo->dirtyDisplayList();
+                             geo->dirtyBound();
+                         });
+
         // add this image and continue
         rv->addChild(xform);
     }
@@ -13,6 +13,8 @@
 #include <osg/MatrixTransform>
 #include <osg/Image>
 
+#include <string>
+
 namespace d3
 {
 
@@ -33,6 +35,11 @@ struct CameraImage
     double focalLengthX_pix;
     double focalLengthY_pix;
     double scale;
+
+    /// The file to read the image from, when there's no image - it's decoded
+    /// in the background (see loadImage()) and a placeholder is shown until
+    /// then, so adding it doesn't wait on the decoding
+    std::string path;
 };
 
 /// The standard "lots of these things"
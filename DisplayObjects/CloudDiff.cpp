@@ -0,0 +1,397 @@
+/////////////////////////////////////////////////////////////////
+/// @file      CloudDiff.cpp
+/// @author    Chris L Baker (clb) <chris@chimail.net>
+/// @date      2026.10.18
+/// @brief     Color a point cloud by the distance to the nearest point in a
+///            reference cloud
+///
+/// @attention Copyright (C) 2026
+/// @attention All rights reserved
+/////////////////////////////////////////////////////////////////
+
+#include "CloudDiff.h"
+#include "Colors.h"
+#include "Parallel.h"
+#include "TaskScheduler.h"
+
+#include <osg/BoundingBox>
+#include <osg/Geode>
+#include <osg/Geometry>
+#include <osg/Point>
+#include <osg/Version>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <mutex>
+
+namespace d3
+{
+
+namespace
+{
+
+/// The most points in a leaf of the tree
+const size_t leafSize(8);
+
+/// The smallest subtree worth building as a task of its own
+const size_t minPointsPerThread(1 << 14);
+
+/// The smallest chunk of queries worth handing to a thread
+const size_t queriesPerChunk(1 << 12);
+
+/////////////////////////////////////////////////////////////////
+/// @brief   A kd-tree stored in place - the points of a subtree are the range
+///          [begin,end) of the array, with the splitting point in the middle
+/////////////////////////////////////////////////////////////////
+class KdTree
+{
+  public:
+
+    explicit KdTree(std::vector<osg::Vec3d>&& points) :
+        m_points(std::move(points)),
+        m_axes(m_points.size(), 0)
+    {
+        // split the top levels across the workers
+        const size_t numThreads( getWorkerThreads() + 1 );
+        unsigned int threadDepth(0);
+        while ( (size_t(1) << threadDepth) < numThreads ) ++threadDepth;
+        build(0, m_points.size(), threadDepth);
+    };
+
+    /// @brief   The squared distance to the nearest point, if it's closer than
+    ///          best2 (otherwise best2)
+    double nearest2(const osg::Vec3d& query,
+                    double best2) const
+    {
+        search(query, 0, m_points.size(), best2);
+        return best2;
+    };
+
+  private:
+
+    void build(const size_t& begin,
+               const size_t& end,
+               const unsigned int& threadDepth)
+    {
+        if ( end - begin <= leafSize ) return;
+
+        // split on the widest axis
+        osg::BoundingBoxd box;
+        for ( size_t ii(begin) ; ii<end ; ++ii )
+            box.expandBy(m_points[ii]);
+        const osg::Vec3d extent( box._max - box._min );
+        const unsigned char axis( extent.x() >= extent.y() ?
+                                  (extent.x() >= extent.z() ? 0 : 2) :
+                                  (extent.y() >= extent.z() ? 1 : 2) );
+
+        const size_t mid( begin + (end - begin) / 2 );
+        std::nth_element(m_points.begin() + begin, m_points.begin() + mid, m_points.begin() + end,
+                         [axis](const osg::Vec3d& aa, const osg::Vec3d& bb) { return aa[axis] < bb[axis]; });
+        m_axes[mid] = axis;
+
+        if ( threadDepth && (end - begin >= minPointsPerThread) )
+        {
+            TaskGroup left(Priority::STREAMING);
+            left.run([&]() { build(begin, mid, threadDepth - 1); });
+            build(mid + 1, end, threadDepth - 1);
+            left.wait();
+        }
+        else
+        {
+            build(begin, mid, 0);
+            build(mid + 1, end, 0);
+        }
+    };
+
+    void search(const osg::Vec3d& query,
+                const size_t& begin,
+                const size_t& end,
+                double& best2) const
+    {
+        if ( end - begin <= leafSize )
+        {
+            for ( size_t ii(begin) ; ii<end ; ++ii )
+                best2 = std::min(best2, (m_points[ii] - query).length2());
+            return;
+        }
+
+        const size_t mid( begin + (end - begin) / 2 );
+        best2 = std::min(best2, (m_points[mid] - query).length2());
+
+        // the side the query is on first, then the other side if it's close
+        // enough to the splitting plane
+        const double diff( query[m_axes[mid]] - m_points[mid][m_axes[mid]] );
+        if ( diff < 0.0 )
+        {
+            search(query, begin, mid, best2);
+            if ( diff*diff < best2 ) search(query, mid + 1, end, best2);
+        }
+        else
+        {
+            search(query, mid + 1, end, best2);
+            if ( diff*diff < best2 ) search(query, begin, mid, best2);
+        }
+    };
+
+    /// The points, in tree order
+    std::vector<osg::Vec3d>       m_points;
+
+    /// The splitting axis of each subtree (at its middle point)
+    std::vector<unsigned char>    m_axes;
+};
+
+/// @brief   Pull the locations out of some points
+inline std::vector<osg::Vec3d> locations(const PointVec_t& points)
+{
+    std::vector<osg::Vec3d> out;
+    out.reserve(points.size());
+    for ( const auto& point : points )
+        out.push_back(point.location);
+    return out;
+};
+
+} // namespace
+
+/////////////////////////////////////////////////////////////////
+/// @brief   The comparison - an update callback on the display root so the
+///          display gets rebuilt from the distances in the update traversal
+/////////////////////////////////////////////////////////////////
+class CloudDiff::Comparison : public osg::NodeCallback
+{
+  public:
+
+    Comparison(const double& maxDistance) :
+        m_maxDistance(maxDistance),
+        m_mutex(),
+        m_tree(),
+        m_query(),
+        m_distances(),
+        m_distancesQuery(),
+        m_shownQuery(),
+        m_dirty(false),
+        m_geometry()
+    {
+    };
+
+    /// @brief   Build the tree for a new reference (slow, but it doesn't hold
+    ///          the lock while building)
+    void setReference(std::vector<osg::Vec3d>&& points)
+    {
+        std::shared_ptr<const KdTree> tree( std::make_shared<KdTree>(std::move(points)) );
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tree = tree;
+    };
+
+    void setQuery(std::vector<osg::Vec3d>&& points)
+    {
+        std::shared_ptr<const std::vector<osg::Vec3d>> query( std::make_shared<std::vector<osg::Vec3d>>(std::move(points)) );
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_query = query;
+    };
+
+    /// @brief   Compare the current query against the current tree
+    void compare()
+    {
+        std::shared_ptr<const KdTree> tree;
+        std::shared_ptr<const std::vector<osg::Vec3d>> query;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            tree = m_tree;
+            query = m_query;
+        }
+        if ( not query ) return;
+
+        const double max2( m_maxDistance * m_maxDistance );
+        std::vector<double> distances( query->size(), m_maxDistance );
+        if ( tree )
+        {
+            parallelFor(query->size(), queriesPerChunk,
+                        [&](size_t begin, size_t end, size_t)
+                        {
+                            for ( size_t ii(begin) ; ii<end ; ++ii )
+                                distances[ii] = std::sqrt(tree->nearest2((*query)[ii], max2));
+                        });
+        }
+
+        // a newer reference or query may have come in while we were at it, in
+        // which case the comparison against it wins
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if ( (tree != m_tree) || (query != m_query) ) return;
+        m_distances.swap(distances);
+        m_distancesQuery = query;
+        m_dirty = true;
+    };
+
+    std::vector<double> getDistances()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_distances;
+    };
+
+    /// @brief   Build the (empty) display
+    osg::ref_ptr<osg::Node> build(const float& pointSize)
+    {
+        m_geometry = new osg::Geometry();
+        m_geometry->setDataVariance(osg::Object::DYNAMIC);
+        m_geometry->setUseDisplayList(false);
+        m_geometry->setUseVertexBufferObjects(true);
+        m_geometry->setVertexArray(new osg::Vec3Array());
+#if      OSG_MIN_VERSION_REQUIRED(3,2,0)
+        m_geometry->setColorArray(new osg::Vec4Array(), osg::Array::Binding::BIND_PER_VERTEX);
+#else    // OSG_MIN_VERSION_REQUIRED(3,2,0)
+        m_geometry->setColorArray(new osg::Vec4Array());
+        m_geometry->setColorBinding(osg::Geometry::BIND_PER_VERTEX);
+#endif   // OSG_MIN_VERSION_REQUIRED(3,2,0)
+        m_geometry->addPrimitiveSet(new osg::DrawArrays(osg::PrimitiveSet::POINTS, 0, 0));
+
+        osg::ref_ptr<osg::StateSet> stateSet( m_geometry->getOrCreateStateSet() );
+        stateSet->setAttribute(new osg::Point(pointSize), osg::StateAttribute::ON);
+        stateSet->setMode(GL_LIGHTING, osg::StateAttribute::OFF);
+
+        osg::ref_ptr<osg::Geode> geode( new osg::Geode() );
+        geode->addDrawable( m_geometry );
+        return geode;
+    };
+
+    /// @brief   Rebuild the display if the distances changed, then carry on
+    virtual void operator()(osg::Node* node, osg::NodeVisitor* nv)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if ( m_dirty )
+            {
+                update();
+                m_dirty = false;
+            }
+        }
+        traverse(node, nv);
+    };
+
+  private:
+
+    void update()
+    {
+        osg::Vec3Array* verts( static_cast<osg::Vec3Array*>(m_geometry->getVertexArray()) );
+        osg::Vec4Array* colors( static_cast<osg::Vec4Array*>(m_geometry->getColorArray()) );
+
+        // the points only change with the query
+        if ( m_shownQuery != m_distancesQuery )
+        {
+            verts->assign(m_distancesQuery->begin(), m_distancesQuery->end());
+            verts->dirty();
+            m_geometry->dirtyBound();
+            m_shownQuery = m_distancesQuery;
+        }
+
+        colors->resize(m_distances.size());
+        for ( size_t ii(0) ; ii<m_distances.size() ; ++ii )
+            (*colors)[ii] = colorMap(m_distances[ii], 0.0, m_maxDistance);
+        colors->dirty();
+
+        static_cast<osg::DrawArrays*>(m_geometry->getPrimitiveSet(0))->setCount(verts->size());
+        m_geometry->getPrimitiveSet(0)->dirty();
+    };
+
+    /// The top of the colormap
+    double                                            m_maxDistance;
+
+    /// Protect everything below
+    std::mutex                                        m_mutex;
+
+    /// The tree over the reference
+    std::shared_ptr<const KdTree>                     m_tree;
+
+    /// The query points
+    std::shared_ptr<const std::vector<osg::Vec3d>>    m_query;
+
+    /// The latest distances
+    std::vector<double>                               m_distances;
+
+    /// The query the distances are for
+    std::shared_ptr<const std::vector<osg::Vec3d>>    m_distancesQuery;
+
+    /// The query in the display
+    std::shared_ptr<const std::vector<osg::Vec3d>>    m_shownQuery;
+
+    /// Do we need to rebuild the display
+    bool                                              m_dirty;
+
+    /// The geometry
+    osg::ref_ptr<osg::Geometry>                       m_geometry;
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+CloudDiff::CloudDiff(const double& maxDistance,
+                     const float& pointSize /* = 3.0 */) :
+    m_comparison(new Comparison(maxDistance)),
+    m_root(new osg::Group()),
+    m_build()
+{
+    m_root->addChild(m_comparison->build(pointSize));
+    m_root->setUpdateCallback(m_comparison);
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+CloudDiff::~CloudDiff()
+{
+    wait();
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void CloudDiff::setReference(const std::vector<osg::Vec3d>& points)
+{
+    // one tree at a time
+    wait();
+
+    osg::ref_ptr<Comparison> comparison( m_comparison );
+    std::shared_ptr<std::vector<osg::Vec3d>> reference( std::make_shared<std::vector<osg::Vec3d>>(points) );
+    m_build = scheduleAsync([comparison, reference]()
+                            {
+                                comparison->setReference(std::move(*reference));
+                                comparison->compare();
+                            },
+                            Priority::STREAMING);
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void CloudDiff::setReference(const PointVec_t& points)
+{
+    setReference(locations(points));
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void CloudDiff::setQuery(const std::vector<osg::Vec3d>& points)
+{
+    m_comparison->setQuery(std::vector<osg::Vec3d>(points));
+    m_comparison->compare();
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void CloudDiff::setQuery(const PointVec_t& points)
+{
+    m_comparison->setQuery(locations(points));
+    m_comparison->compare();
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void CloudDiff::wait()
+{
+    if ( m_build.valid() ) m_build.wait();
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+std::vector<double> CloudDiff::getDistances() const
+{
+    return m_comparison->getDistances();
+};
+
+} // namespace d3
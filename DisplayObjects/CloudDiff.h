@@ -0,0 +1,116 @@
+/////////////////////////////////////////////////////////////////
+/// @file      CloudDiff.h
+/// @author    Chris L Baker (clb) <chris@chimail.net>
+/// @date      2026.10.18
+/// @brief     Color a point cloud by the distance to the nearest point in a
+///            reference cloud
+///
+/// @attention Copyright (C) 2026
+/// @attention All rights reserved
+/////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Points.h"
+
+#include <osg/Group>
+#include <osg/Vec3d>
+
+#include <future>
+#include <vector>
+
+namespace d3
+{
+
+/////////////////////////////////////////////////////////////////
+/// @brief   Compare a query cloud (i.e. the current scan) against a reference
+///          cloud (i.e. the map)
+///
+/// The query points are drawn colored by the distance to their nearest
+/// neighbor in the reference, from blue (on the reference) to red (maxDistance
+/// or more away). A kd-tree over the reference is built in the background
+/// (the top of the tree is split across threads), and the nearest neighbor
+/// queries are split across threads too. The tree is kept, so a new query
+/// cloud only costs the queries. The display is rebuilt in the next update
+/// traversal.
+///
+/// @code
+/// static d3::CloudDiff diff(0.5);
+/// diff.setReference(map);       // once, or whenever the map changes
+/// diff.setQuery(scan);          // every scan
+/// d3::di().add( "slam::diff", diff.get() );
+/// @endcode
+/////////////////////////////////////////////////////////////////
+class CloudDiff
+{
+  public:
+
+    /// @{
+    /// @name Noncopyable
+    CloudDiff(const CloudDiff&) = delete;
+    CloudDiff& operator=(const CloudDiff&) = delete;
+    /// @}
+
+    /// @brief   Constructor
+    /// @param   maxDistance The distance that maps to the top of the colormap
+    ///          - the search stops looking past this, so farther points are
+    ///          just reported at this distance
+    /// @param   pointSize The size of the points
+    explicit CloudDiff(const double& maxDistance,
+                       const float& pointSize = 3.0);
+
+    /// @brief   Destructor - waits for the tree being built
+    ~CloudDiff();
+
+    /// @brief   Set the reference cloud, the tree is built in the background
+    ///          and the query is compared against it once it's done
+    /// @param   points The reference points
+    void setReference(const std::vector<osg::Vec3d>& points);
+
+    /// @brief   Set the reference cloud (the colors are ignored)
+    void setReference(const PointVec_t& points);
+
+    /// @brief   Set the query cloud, which is compared against the current
+    ///          reference right away (using all the threads)
+    /// @param   points The query points
+    void setQuery(const std::vector<osg::Vec3d>& points);
+
+    /// @brief   Set the query cloud (the colors are ignored)
+    void setQuery(const PointVec_t& points);
+
+    /// @brief   Wait for the reference tree being built (and the comparison
+    ///          against it)
+    void wait();
+
+    /// @brief   The distance from each query point to the reference, in the
+    ///          order of the query points (capped at maxDistance)
+    std::vector<double> getDistances() const;
+
+    /// @brief   Access to the display root
+    osg::ref_ptr<osg::Group> get() const { return m_root; };
+
+  private:
+
+    /// The tree, the distances and the display built from them (defined in
+    /// the .cpp)
+    class Comparison;
+
+    /// The comparison, also the update callback on the root
+    osg::ref_ptr<Comparison>  m_comparison;
+
+    /// The root of the display
+    osg::ref_ptr<osg::Group>  m_root;
+
+    /// The tree being built
+    std::future<void>         m_build;
+};
+
+/// @brief   get an osg node from a cloud diff
+/// @param   cloudDiff The cloud diff to display
+/// @return  osg::ref_ptr<osg::Node> The node for the di().add() call
+inline osg::ref_ptr<osg::Node> get(const CloudDiff& cloudDiff)
+{
+    return cloudDiff.get();
+};
+
+} // namespace d3
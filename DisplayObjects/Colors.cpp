@@ -10,6 +10,9 @@
 
 #include "Colors.h"
 
+#include <algorithm>
+#include <cmath>
+
 namespace d3
 {
 
@@ -103,6 +106,22 @@ const osg::Vec4& cyan()
     return cc;
 };
 
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+osg::Vec4 colorMap(const double& value,
+                   const double& minValue /* = 0.0 */,
+                   const double& maxValue /* = 1.0 */,
+                   const float& alpha /* = 1.0 */)
+{
+    // normalize to [0, 1]
+    const double range( maxValue - minValue );
+    const double tt( range > 0.0 ? std::min(1.0, std::max(0.0, (value - minValue) / range)) : 0.0 );
+
+    // each channel is a clamped "tent"
+    auto tent = [](const double& xx) { return static_cast<float>(std::min(1.0, std::max(0.0, 1.5 - std::fabs(xx)))); };
+    return osg::Vec4(tent(4.0*tt - 3.0), tent(4.0*tt - 2.0), tent(4.0*tt - 1.0), alpha);
+};
+
 /////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////
 void Colors::SetupColorMap(const double& transparency)
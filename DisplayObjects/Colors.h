@@ -75,6 +75,18 @@ const osg::Vec4& magenta();
 const osg::Vec4& cyan();
 /// @}
 
+/// @brief   Map a scalar value onto a color (blue -> cyan -> green -> yellow
+///          -> red, like the matlab "jet" map)
+/// @param   value The value to map
+/// @param   minValue The value that maps to blue
+/// @param   maxValue The value that maps to red
+/// @param   alpha The transparency of the color
+/// @return  osg::Vec4 The color - values outside [min, max] are clamped
+osg::Vec4 colorMap(const double& value,
+                   const double& minValue = 0.0,
+                   const double& maxValue = 1.0,
+                   const float& alpha = 1.0);
+
 /// @brief    change an rgb color to an index
 unsigned int toIndex(const double rr,
                      const double gg,
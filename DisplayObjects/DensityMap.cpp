@@ -0,0 +1,348 @@
+/////////////////////////////////////////////////////////////////
+/// @file      DensityMap.cpp
+/// @author    Chris L Baker (clb) <chris@chimail.net>
+/// @date      2026.10.18
+/// @brief     Display the density of a massive set of points as a
+///            colormapped 2D texture or 3D voxel layer
+///
+/// @attention Copyright (C) 2026
+/// @attention All rights reserved
+/////////////////////////////////////////////////////////////////
+
+#include "DensityMap.h"
+#include "Colors.h"
+#include "Parallel.h"
+
+#include <osg/Geode>
+#include <osg/Geometry>
+#include <osg/Point>
+#include <osg/TexEnv>
+#include <osg/Texture2D>
+#include <osg/Version>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+
+namespace d3
+{
+
+/////////////////////////////////////////////////////////////////
+/// @brief   The histogram - an update callback on the display root so the
+///          display gets rebuilt from the counts in the update traversal
+/////////////////////////////////////////////////////////////////
+class DensityMap::Histogram : public osg::NodeCallback
+{
+  public:
+
+    Histogram(const osg::Vec3d& minCorner,
+              const osg::Vec3d& maxCorner,
+              const double& cellSize,
+              const Layer& layer) :
+        m_minCorner(minCorner),
+        m_cellSize(cellSize),
+        m_layer(layer),
+        m_nx(std::max(1, static_cast<int>(std::ceil((maxCorner.x() - minCorner.x()) / cellSize)))),
+        m_ny(std::max(1, static_cast<int>(std::ceil((maxCorner.y() - minCorner.y()) / cellSize)))),
+        m_nz(Layer::TEXTURE == layer ? 1 :
+             std::max(1, static_cast<int>(std::ceil((maxCorner.z() - minCorner.z()) / cellSize)))),
+        m_mutex(),
+        m_counts(static_cast<size_t>(m_nx) * m_ny * m_nz, 0),
+        m_maxCount(0),
+        m_dirty(false),
+        m_image(),
+        m_geometry()
+    {
+    };
+
+    /// @brief   The linear index of the cell holding a point, -1 if outside
+    inline long cellIndex(const osg::Vec3d& point) const
+    {
+        const osg::Vec3d offset( point - m_minCorner );
+        const long ix( static_cast<long>(std::floor(offset.x() / m_cellSize)) );
+        const long iy( static_cast<long>(std::floor(offset.y() / m_cellSize)) );
+        const long iz( Layer::TEXTURE == m_layer ? 0 : static_cast<long>(std::floor(offset.z() / m_cellSize)) );
+        if ( (ix < 0) || (iy < 0) || (iz < 0) || (ix >= m_nx) || (iy >= m_ny) || (iz >= m_nz) )
+            return -1;
+        return ix + m_nx * (iy + m_ny * iz);
+    };
+
+    /// @brief   Bin some points
+    template<typename Accessor>
+    void add(const size_t& count, const Accessor& accessor)
+    {
+        static const size_t pointsPerChunk(1 << 16);
+        const size_t numCells( m_counts.size() );
+
+        // each chunk of points gets its own partial histogram, so there's no
+        // contention while binning
+        std::vector<std::vector<unsigned int>> partials( parallelChunks(count, pointsPerChunk) );
+        parallelFor(count, pointsPerChunk,
+                    [&](size_t begin, size_t end, size_t chunk)
+                    {
+                        std::vector<unsigned int>& partial( partials[chunk] );
+                        partial.assign(numCells, 0);
+                        for ( size_t ii(begin) ; ii<end ; ++ii )
+                        {
+                            const long index( cellIndex(accessor(ii)) );
+                            if ( index >= 0 ) ++partial[index];
+                        }
+                    });
+
+        // merge the partials into the histogram, splitting up the cells this
+        // time so each thread owns a range of the histogram
+        static const size_t cellsPerChunk(1 << 14);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::vector<unsigned int> maxCounts( parallelChunks(numCells, cellsPerChunk), 0 );
+        parallelFor(numCells, cellsPerChunk,
+                    [&](size_t begin, size_t end, size_t chunk)
+                    {
+                        unsigned int& maxCount( maxCounts[chunk] );
+                        for ( size_t cc(begin) ; cc<end ; ++cc )
+                        {
+                            for ( const auto& partial : partials )
+                                m_counts[cc] += partial[cc];
+                            maxCount = std::max(maxCount, m_counts[cc]);
+                        }
+                    });
+        m_maxCount = std::max(m_maxCount, *std::max_element(maxCounts.begin(), maxCounts.end()));
+        m_dirty = true;
+    };
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::fill(m_counts.begin(), m_counts.end(), 0);
+        m_maxCount = 0;
+        m_dirty = true;
+    };
+
+    unsigned int getMaxCount()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_maxCount;
+    };
+
+    /// @brief   Build the texture layer
+    osg::ref_ptr<osg::Node> buildTexture()
+    {
+        m_image = new osg::Image();
+        m_image->allocateImage(m_nx, m_ny, 1, GL_RGBA, GL_UNSIGNED_BYTE);
+        std::memset(m_image->data(), 0, m_image->getTotalSizeInBytes());
+        m_image->setDataVariance(osg::Object::DYNAMIC);
+
+        // the quad covering the grid
+        const double zz( m_minCorner.z() );
+        const double maxX( m_minCorner.x() + m_nx * m_cellSize );
+        const double maxY( m_minCorner.y() + m_ny * m_cellSize );
+        osg::ref_ptr<osg::Vec3Array> quad( new osg::Vec3Array() );
+        quad->push_back( osg::Vec3(m_minCorner.x(), m_minCorner.y(), zz) );
+        quad->push_back( osg::Vec3(maxX,            m_minCorner.y(), zz) );
+        quad->push_back( osg::Vec3(maxX,            maxY,            zz) );
+        quad->push_back( osg::Vec3(m_minCorner.x(), maxY,            zz) );
+
+        osg::ref_ptr<osg::Vec2Array> texCoords( new osg::Vec2Array() );
+        texCoords->push_back( osg::Vec2(0.0f, 0.0f) );
+        texCoords->push_back( osg::Vec2(1.0f, 0.0f) );
+        texCoords->push_back( osg::Vec2(1.0f, 1.0f) );
+        texCoords->push_back( osg::Vec2(0.0f, 1.0f) );
+
+        osg::ref_ptr<osg::Geometry> geo( new osg::Geometry() );
+        geo->setVertexArray( quad );
+        geo->setTexCoordArray( 0, texCoords );
+        geo->addPrimitiveSet( new osg::DrawArrays(osg::PrimitiveSet::QUADS, 0, 4) );
+
+        // the texture gets subloaded when the image changes
+        osg::ref_ptr<osg::Texture2D> texture( new osg::Texture2D() );
+        texture->setResizeNonPowerOfTwoHint(false);
+        texture->setDataVariance(osg::Object::DYNAMIC);
+        texture->setImage( m_image );
+        texture->setFilter(osg::Texture::MIN_FILTER, osg::Texture::NEAREST);
+        texture->setFilter(osg::Texture::MAG_FILTER, osg::Texture::NEAREST);
+
+        // replace, so the empty cells are see-through
+        osg::ref_ptr<osg::TexEnv> texEnv( new osg::TexEnv() );
+        texEnv->setMode(osg::TexEnv::REPLACE);
+
+        osg::ref_ptr<osg::StateSet> stateSet( geo->getOrCreateStateSet() );
+        stateSet->setTextureAttributeAndModes(0, texture, osg::StateAttribute::ON);
+        stateSet->setTextureAttribute(0, texEnv);
+        stateSet->setMode(GL_LIGHTING, osg::StateAttribute::OFF);
+        stateSet->setMode(GL_BLEND, osg::StateAttribute::ON);
+        stateSet->setRenderingHint(osg::StateSet::TRANSPARENT_BIN);
+
+        osg::ref_ptr<osg::Geode> geode( new osg::Geode() );
+        geode->addDrawable( geo );
+        return geode;
+    };
+
+    /// @brief   Build the voxel layer
+    osg::ref_ptr<osg::Node> buildVoxels(const float& pointSize)
+    {
+        m_geometry = new osg::Geometry();
+        m_geometry->setDataVariance(osg::Object::DYNAMIC);
+        m_geometry->setUseDisplayList(false);
+        m_geometry->setUseVertexBufferObjects(true);
+        m_geometry->setVertexArray(new osg::Vec3Array());
+#if      OSG_MIN_VERSION_REQUIRED(3,2,0)
+        m_geometry->setColorArray(new osg::Vec4Array(), osg::Array::Binding::BIND_PER_VERTEX);
+#else    // OSG_MIN_VERSION_REQUIRED(3,2,0)
+        m_geometry->setColorArray(new osg::Vec4Array());
+        m_geometry->setColorBinding(osg::Geometry::BIND_PER_VERTEX);
+#endif   // OSG_MIN_VERSION_REQUIRED(3,2,0)
+        m_geometry->addPrimitiveSet(new osg::DrawArrays(osg::PrimitiveSet::POINTS, 0, 0));
+
+        osg::ref_ptr<osg::StateSet> stateSet( m_geometry->getOrCreateStateSet() );
+        stateSet->setAttribute(new osg::Point(pointSize), osg::StateAttribute::ON);
+        stateSet->setMode(GL_LIGHTING, osg::StateAttribute::OFF);
+
+        osg::ref_ptr<osg::Geode> geode( new osg::Geode() );
+        geode->addDrawable( m_geometry );
+        return geode;
+    };
+
+    /// @brief   Rebuild the display if the counts changed, then carry on
+    virtual void operator()(osg::Node* node, osg::NodeVisitor* nv)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if ( m_dirty )
+            {
+                if ( Layer::TEXTURE == m_layer ) updateTexture();
+                else                             updateVoxels();
+                m_dirty = false;
+            }
+        }
+        traverse(node, nv);
+    };
+
+  private:
+
+    /// @brief   The normalized (log scale) density of a count
+    inline double density(const unsigned int& count) const
+    {
+        return std::log1p(count) / std::log1p(std::max(1u, m_maxCount));
+    };
+
+    void updateTexture()
+    {
+        for ( int iy(0) ; iy<m_ny ; ++iy )
+        {
+            unsigned char* row( m_image->data(0, iy) );
+            for ( int ix(0) ; ix<m_nx ; ++ix )
+            {
+                const unsigned int count( m_counts[ix + m_nx * iy] );
+                const osg::Vec4 color( count ? colorMap(density(count)) : osg::Vec4(0,0,0,0) );
+                for ( int cc(0) ; cc<4 ; ++cc )
+                    row[4*ix + cc] = static_cast<unsigned char>(255.0f * color[cc]);
+            }
+        }
+        m_image->dirty();
+    };
+
+    void updateVoxels()
+    {
+        osg::Vec3Array* verts( static_cast<osg::Vec3Array*>(m_geometry->getVertexArray()) );
+        osg::Vec4Array* colors( static_cast<osg::Vec4Array*>(m_geometry->getColorArray()) );
+        verts->clear();
+        colors->clear();
+
+        const osg::Vec3d halfCell( m_cellSize/2.0, m_cellSize/2.0, m_cellSize/2.0 );
+        for ( int iz(0) ; iz<m_nz ; ++iz )
+            for ( int iy(0) ; iy<m_ny ; ++iy )
+                for ( int ix(0) ; ix<m_nx ; ++ix )
+                {
+                    const unsigned int count( m_counts[ix + m_nx * (iy + m_ny * iz)] );
+                    if ( not count ) continue;
+                    verts->push_back( m_minCorner + osg::Vec3d(ix, iy, iz) * m_cellSize + halfCell );
+                    colors->push_back( colorMap(density(count)) );
+                }
+
+        static_cast<osg::DrawArrays*>(m_geometry->getPrimitiveSet(0))->setCount(verts->size());
+        m_geometry->getPrimitiveSet(0)->dirty();
+        verts->dirty();
+        colors->dirty();
+        m_geometry->dirtyBound();
+    };
+
+    /// The grid
+    osg::Vec3d                   m_minCorner;
+    double                       m_cellSize;
+    Layer                        m_layer;
+    int                          m_nx;
+    int                          m_ny;
+    int                          m_nz;
+
+    /// Protect the counts
+    std::mutex                   m_mutex;
+
+    /// The counts for each cell
+    std::vector<unsigned int>    m_counts;
+
+    /// The highest count
+    unsigned int                 m_maxCount;
+
+    /// Do we need to rebuild the display
+    bool                         m_dirty;
+
+    /// The image for the TEXTURE layer
+    osg::ref_ptr<osg::Image>     m_image;
+
+    /// The geometry for the VOXELS layer
+    osg::ref_ptr<osg::Geometry>  m_geometry;
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+DensityMap::DensityMap(const osg::Vec3d& minCorner,
+                       const osg::Vec3d& maxCorner,
+                       const double& cellSize,
+                       const Layer& layer /* = Layer::TEXTURE */,
+                       const float& pointSize /* = 5.0 */) :
+    m_histogram(new Histogram(minCorner, maxCorner, cellSize, layer)),
+    m_root(new osg::Group())
+{
+    if ( Layer::TEXTURE == layer )
+        m_root->addChild(m_histogram->buildTexture());
+    else
+        m_root->addChild(m_histogram->buildVoxels(pointSize));
+
+    m_root->setUpdateCallback(m_histogram);
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+DensityMap::~DensityMap()
+{
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void DensityMap::add(const std::vector<osg::Vec3d>& points)
+{
+    m_histogram->add(points.size(), [&](const size_t& ii) -> const osg::Vec3d& { return points[ii]; });
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void DensityMap::add(const PointVec_t& points)
+{
+    m_histogram->add(points.size(), [&](const size_t& ii) -> const osg::Vec3d& { return points[ii].location; });
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void DensityMap::clear()
+{
+    m_histogram->clear();
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+unsigned int DensityMap::getMaxCount() const
+{
+    return m_histogram->getMaxCount();
+};
+
+} // namespace d3
@@ -0,0 +1,110 @@
+/////////////////////////////////////////////////////////////////
+/// @file      DensityMap.h
+/// @author    Chris L Baker (clb) <chris@chimail.net>
+/// @date      2026.10.18
+/// @brief     Display the density of a massive set of points as a
+///            colormapped 2D texture or 3D voxel layer
+///
+/// @attention Copyright (C) 2026
+/// @attention All rights reserved
+/////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Points.h"
+
+#include <osg/Group>
+#include <osg/Vec3d>
+
+#include <vector>
+
+namespace d3
+{
+
+/////////////////////////////////////////////////////////////////
+/// @brief   Bin points into a 2D or 3D histogram grid and display the
+///          counts through a colormap
+///
+/// When millions of points pile up in the same area, drawing them just makes an
+/// overdrawn blob. This bins them instead. The points are binned in parallel
+/// (each thread fills its own partial histogram, which are then merged), and
+/// points can keep streaming in with more calls to add(). The display is
+/// rebuilt from the histogram during the next update traversal, so the cost of
+/// drawing depends on the size of the grid and not the number of points.
+///
+/// @code
+/// static d3::DensityMap density({-50,-50,0}, {50,50,0}, 0.25);
+/// density.add(detections);
+/// d3::di().add( "detections::density", density.get() );
+/// @endcode
+/////////////////////////////////////////////////////////////////
+class DensityMap
+{
+  public:
+
+    /// @brief   How the density is displayed
+    enum class Layer
+    {
+        TEXTURE = 0, ///< A 2D x/y histogram shown as a texture at the min z
+        VOXELS       ///< A 3D histogram shown as a point at each occupied cell
+    };
+
+    /// @{
+    /// @name Noncopyable
+    DensityMap(const DensityMap&) = delete;
+    DensityMap& operator=(const DensityMap&) = delete;
+    /// @}
+
+    /// @brief   Constructor
+    /// @param   minCorner The minimum corner of the binned volume
+    /// @param   maxCorner The maximum corner of the binned volume
+    /// @param   cellSize The size of a (square or cube) cell
+    /// @param   layer How to display the density
+    /// @param   pointSize The size of the points for the VOXELS layer
+    DensityMap(const osg::Vec3d& minCorner,
+               const osg::Vec3d& maxCorner,
+               const double& cellSize,
+               const Layer& layer = Layer::TEXTURE,
+               const float& pointSize = 5.0);
+
+    /// @brief   Destructor
+    ~DensityMap();
+
+    /// @brief   Accumulate more points, points outside the volume are ignored
+    /// @param   points The points to bin
+    void add(const std::vector<osg::Vec3d>& points);
+
+    /// @brief   Accumulate more points, points outside the volume are ignored
+    /// @param   points The points to bin (the colors are ignored)
+    void add(const PointVec_t& points);
+
+    /// @brief   Throw away all the accumulated counts
+    void clear();
+
+    /// @brief   The highest count in any cell
+    unsigned int getMaxCount() const;
+
+    /// @brief   Access to the display root
+    osg::ref_ptr<osg::Group> get() const { return m_root; };
+
+  private:
+
+    /// The histogram and the display built from it (defined in the .cpp)
+    class Histogram;
+
+    /// The histogram, also the update callback on the root
+    osg::ref_ptr<Histogram>   m_histogram;
+
+    /// The root of the display
+    osg::ref_ptr<osg::Group>  m_root;
+};
+
+/// @brief   get an osg node from a density map
+/// @param   densityMap The density map to display
+/// @return  osg::ref_ptr<osg::Node> The node for the di().add() call
+inline osg::ref_ptr<osg::Node> get(const DensityMap& densityMap)
+{
+    return densityMap.get();
+};
+
+} // namespace d3
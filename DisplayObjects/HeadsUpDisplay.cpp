@@ -248,8 +248,10 @@ void HeadsUpDisplay::setDefaultBackgrounColor()
 /////////////////////////////////////////////////////////////////
 void HeadsUpDisplay::show(const bool& display)
 {
-    // set the node mask based on the display parameter
-    m_root->setNodeMask(display?~0:0);
+    // set the node mask based on the display parameter (a shown hud keeps
+    // the viewports it's hidden in)
+    if ( display != isShown() )
+        m_root->setNodeMask(display?~0:0);
 };
 
 /////////////////////////////////////////////////////////////////
@@ -257,7 +259,7 @@ void HeadsUpDisplay::show(const bool& display)
 bool HeadsUpDisplay::isShown() const
 {
     // is the node mask something non-zero
-    return (m_root->getNodeMask()==~0u?true:false);
+    return (0 != m_root->getNodeMask());
 };
 
 } // namespace d3
@@ -0,0 +1,254 @@
+/////////////////////////////////////////////////////////////////
+/// @file      ImageCache.cpp
+/// @author    Chris L Baker (clb) <chris@chimail.net>
+/// @date      2026.10.18
+/// @brief     Decode image files in the background, with a shared cache
+///
+/// @attention Copyright (C) 2026
+/// @attention All rights reserved
+/////////////////////////////////////////////////////////////////
+
+#include "ImageCache.h"
+#include "TaskScheduler.h"
+
+#include <osg/NodeCallback>
+#include <osgDB/ReadFile>
+
+#include <chrono>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace d3
+{
+
+namespace
+{
+
+/// The default size of the cache
+const size_t defaultCacheBytes( size_t(256) << 20 );
+
+/// An image being (or done being) decoded
+typedef std::shared_future<osg::ref_ptr<osg::Image>> ImageFuture_t;
+
+/////////////////////////////////////////////////////////////////
+/// @brief   The cache of the decoded files
+/////////////////////////////////////////////////////////////////
+class ImageCache
+{
+  public:
+
+    /// @brief   Constructor
+    ImageCache() :
+        m_mutex(),
+        m_entries(),
+        m_lru(),
+        m_bytes(0),
+        m_capacity(defaultCacheBytes)
+    {
+    };
+
+    /// @brief   Get the image of a file, decoding it if it's not cached
+    ImageFuture_t load(const std::string& path)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto found( m_entries.find(path) );
+        if ( m_entries.end() != found )
+        {
+            m_lru.splice(m_lru.begin(), m_lru, found->second.lru);
+            return found->second.image;
+        }
+
+        std::shared_ptr<std::promise<osg::ref_ptr<osg::Image>>> promise
+            ( std::make_shared<std::promise<osg::ref_ptr<osg::Image>>>() );
+        m_lru.push_front(path);
+        m_entries[path] = Entry{promise->get_future().share(), 0, false, m_lru.begin()};
+        schedule([this, path, promise]() { decode(path, *promise); }, Priority::STREAMING);
+        return m_entries[path].image;
+    };
+
+    /// @brief   Set the size of the cache
+    void setCapacity(const size_t& bytes)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_capacity = bytes;
+        evict();
+    };
+
+  private:
+
+    /// A cached image
+    struct Entry
+    {
+        ImageFuture_t                       image;
+        size_t                              bytes;
+        bool                                decoded;
+        std::list<std::string>::iterator    lru;
+    };
+
+    /// @brief   Decode a file (on the workers)
+    void decode(const std::string& path,
+                std::promise<osg::ref_ptr<osg::Image>>& promise)
+    {
+        osg::ref_ptr<osg::Image> image( osgDB::readImageFile(path) );
+        if ( not image )
+            std::cerr << "BUMMER: Couldn't read the image \"" << path << "\"" << std::endl;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto found( m_entries.find(path) );
+            if ( m_entries.end() != found )
+            {
+                if ( image )
+                {
+                    found->second.bytes = image->getTotalSizeInBytes();
+                    found->second.decoded = true;
+                    m_bytes += found->second.bytes;
+                    evict();
+                }
+                else
+                {
+                    // forget it, so it's tried again next time
+                    m_lru.erase(found->second.lru);
+                    m_entries.erase(found);
+                }
+            }
+        }
+
+        promise.set_value(image);
+    };
+
+    /// @brief   Drop the least recently used images until we're under
+    ///          capacity (with the lock)
+    void evict()
+    {
+        auto itt( m_lru.end() );
+        while ( (m_bytes > m_capacity) && (m_lru.begin() != itt) )
+        {
+            --itt;
+            auto found( m_entries.find(*itt) );
+            if ( not found->second.decoded ) continue;
+
+            m_bytes -= found->second.bytes;
+            m_entries.erase(found);
+            itt = m_lru.erase(itt);
+        }
+    };
+
+    /// Protect everything
+    std::mutex                                  m_mutex;
+
+    /// The cache
+    std::unordered_map<std::string, Entry>      m_entries;
+
+    /// The cached paths, most recently used first
+    std::list<std::string>                      m_lru;
+
+    /// The bytes of the decoded images in the cache
+    size_t                                      m_bytes;
+
+    /// The bytes we're allowed
+    size_t                                      m_capacity;
+};
+
+/// @brief   The shared cache - never destroyed, so the decoding still queued
+///          at exit has something to report to
+ImageCache& cache()
+{
+    static ImageCache* pCache( new ImageCache() );
+    return *pCache;
+};
+
+/////////////////////////////////////////////////////////////////
+/// @brief   Put the image in the texture once it's decoded, then remove
+///          itself
+/////////////////////////////////////////////////////////////////
+class TextureLoader : public osg::NodeCallback
+{
+  public:
+
+    TextureLoader(osg::Texture2D& texture,
+                  const ImageFuture_t& image,
+                  std::function<void(const osg::Image&)>&& loaded) :
+        osg::NodeCallback(),
+        m_texture(&texture),
+        m_image(image),
+        m_loaded(std::move(loaded))
+    {};
+
+    virtual void operator()(osg::Node* node, osg::NodeVisitor* nv)
+    {
+        traverse(node, nv);
+
+        if ( std::future_status::ready != m_image.wait_for(std::chrono::seconds(0)) )
+            return;
+
+        const osg::ref_ptr<osg::Image> image( m_image.get() );
+        if ( image )
+        {
+            m_texture->setImage(image);
+            m_loaded(*image);
+        }
+
+        // hold on to ourselves while we're removed
+        osg::ref_ptr<TextureLoader> self(this);
+        node->removeUpdateCallback(this);
+    };
+
+  private:
+
+    osg::ref_ptr<osg::Texture2D>               m_texture;
+    ImageFuture_t                              m_image;
+    std::function<void(const osg::Image&)>     m_loaded;
+};
+
+} // namespace
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+std::shared_future<osg::ref_ptr<osg::Image>> loadImage(const std::string& path)
+{
+    return cache().load(path);
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void setImageCacheSize(const size_t& bytes)
+{
+    cache().setCapacity(bytes);
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+osg::ref_ptr<osg::Image> placeholderImage()
+{
+    static const osg::ref_ptr<osg::Image> placeholder
+        ([]()
+         {
+             osg::ref_ptr<osg::Image> image( new osg::Image() );
+             image->allocateImage(1, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE);
+             unsigned char* pixel( image->data() );
+             pixel[0] = pixel[1] = pixel[2] = 128;
+             pixel[3] = 255;
+             return image;
+         }());
+    return placeholder;
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void loadTexture(osg::Node& node,
+                 osg::Texture2D& texture,
+                 const std::string& path,
+                 std::function<void(const osg::Image&)>&& loaded /* = [](const osg::Image&){} */)
+{
+    // the image changes under the draw, once it's in
+    texture.setDataVariance(osg::Object::DYNAMIC);
+    texture.setImage(placeholderImage());
+    node.addUpdateCallback(new TextureLoader(texture, loadImage(path), std::move(loaded)));
+};
+
+} // namespace d3
@@ -0,0 +1,59 @@
+/////////////////////////////////////////////////////////////////
+/// @file      ImageCache.h
+/// @author    Chris L Baker (clb) <chris@chimail.net>
+/// @date      2026.10.18
+/// @brief     Decode image files in the background, with a shared cache
+///
+/// @attention Copyright (C) 2026
+/// @attention All rights reserved
+/////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <osg/Image>
+#include <osg/Node>
+#include <osg/Texture2D>
+
+#include <functional>
+#include <future>
+#include <string>
+
+namespace d3
+{
+
+/// @brief   Decode an image file on the shared workers (see TaskScheduler.h)
+/// @param   path The file to read (anything osgDB can read)
+/// @return  std::shared_future<osg::ref_ptr<osg::Image>> The image, once it
+///          is decoded (null if it couldn't be read)
+///
+/// The decoded images are kept in a least recently used cache shared by
+/// everything loaded by path, so items showing the same file share one
+/// image, and the file is only decoded once while it stays in the cache.
+/// Images still being decoded are never evicted, and evicting an image only
+/// drops the cache's reference (the items showing it keep theirs).
+std::shared_future<osg::ref_ptr<osg::Image>> loadImage(const std::string& path);
+
+/// @brief   Set the size of the shared image cache
+/// @param   bytes The bytes of decoded images to keep (256 MB by default)
+void setImageCacheSize(const size_t& bytes);
+
+/// @brief   The image shown while a file is being decoded (a gray pixel)
+osg::ref_ptr<osg::Image> placeholderImage();
+
+/// @brief   Show an image file in a texture once it's decoded
+/// @param   node The node to watch the decoding from (in its update callback)
+/// @param   texture The texture to put the image in - it shows the
+///          placeholder until then
+/// @param   path The file to read
+/// @param   loaded Run in the update traversal once the image is in the
+///          texture (i.e. to size the geometry to the image)
+///
+/// This doesn't block, so producers can add hundreds of images by path
+/// without waiting on the decoding. If the file can't be read, the
+/// placeholder stays.
+void loadTexture(osg::Node& node,
+                 osg::Texture2D& texture,
+                 const std::string& path,
+                 std::function<void(const osg::Image&)>&& loaded = [](const osg::Image&){});
+
+} // namespace d3
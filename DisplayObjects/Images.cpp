@@ -9,6 +9,7 @@
 /////////////////////////////////////////////////////////////////
 
 #include "Images.h"
+#include "ImageCache.h"
 
 #include <osg/Geometry>
 #include <osg/Texture2D>
@@ -60,7 +61,10 @@ osg::ref_ptr<osg::Node> get(const ImageVec_t& images)
         osg::ref_ptr<osg::Texture2D> texture( new osg::Texture2D() );
         texture->setResizeNonPowerOfTwoHint(false);
         texture->setDataVariance(osg::Object::STATIC);
-        texture->setImage( image.image );
+        if ( image.image )
+            texture->setImage( image.image );
+        else
+            loadTexture( *geode, *texture, image.path );
         texture->setFilter(osg::Texture::MIN_FILTER, osg::Texture::NEAREST);
         texture->setFilter(osg::Texture::MAG_FILTER, osg::Texture::NEAREST);
 
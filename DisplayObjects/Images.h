@@ -14,6 +14,7 @@
 #include <osg/Image>
 
 #include <array>
+#include <string>
 
 namespace d3
 {
@@ -27,6 +28,11 @@ struct Image
     /// The 4 corners of the image in a clockwise rotation around the image with
     /// the first corner being the position of the upper left corner
     std::array<osg::Vec3,4> corners;
+
+    /// The file to read the image from, when there's no image - it's decoded
+    /// in the background (see loadImage()) and a placeholder is shown until
+    /// then, so adding it doesn't wait on the decoding
+    std::string path;
 };
 
 /// The standard "lots of these things"
@@ -9,6 +9,7 @@
 /////////////////////////////////////////////////////////////////
 
 #include "Lines.h"
+#include "Pool.h"
 
 #include <osg/Geometry>
 #include <osg/Version>
@@ -50,7 +51,7 @@ osg::ref_ptr<osg::Node> get(const LineVec_t& lines)
     }
 
     // now add all this stuff to the geometry object
-    osg::ref_ptr<osg::Geometry> cloudGeometry( new osg::Geometry() );
+    osg::ref_ptr<osg::Geometry> cloudGeometry( new Pooled<osg::Geometry>() );
     cloudGeometry->setVertexArray(verts);
 #if      OSG_MIN_VERSION_REQUIRED(3,2,0)
     cloudGeometry->setColorArray(osgColors, osg::Array::Binding::BIND_PER_VERTEX);
@@ -61,10 +62,11 @@ osg::ref_ptr<osg::Node> get(const LineVec_t& lines)
     cloudGeometry->addPrimitiveSet(theLines);
 
     // set the state - line size and lighting
-    cloudGeometry->getOrCreateStateSet()->setMode(GL_LIGHTING, osg::StateAttribute::OFF);
+    cloudGeometry->setStateSet(new Pooled<osg::StateSet>());
+    cloudGeometry->getStateSet()->setMode(GL_LIGHTING, osg::StateAttribute::OFF);
 
     // create and return the geode
-    osg::ref_ptr<osg::Geode> geode(new osg::Geode());
+    osg::ref_ptr<osg::Geode> geode(new Pooled<osg::Geode>());
     geode->addDrawable(cloudGeometry);
     return geode;
 };
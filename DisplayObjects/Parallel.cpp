@@ -0,0 +1,52 @@
+/////////////////////////////////////////////////////////////////
+/// @file      Parallel.cpp
+/// @author    Chris L Baker (clb) <chris@chimail.net>
+/// @date      2026.10.18
+/// @brief     Split work on big arrays across threads
+///
+/// @attention Copyright (C) 2026
+/// @attention All rights reserved
+/////////////////////////////////////////////////////////////////
+
+#include "Parallel.h"
+#include "TaskScheduler.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace d3
+{
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+size_t parallelChunks(const size_t& count,
+                      const size_t& minPerChunk)
+{
+    static const size_t numThreads( std::max(1u, std::thread::hardware_concurrency()) );
+    return std::max<size_t>(1, std::min(numThreads, count / std::max<size_t>(1, minPerChunk)));
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void parallelFor(const size_t& count,
+                 const size_t& minPerChunk,
+                 const std::function<void(size_t, size_t, size_t)>& func)
+{
+    const size_t chunks( parallelChunks(count, minPerChunk) );
+    const size_t perChunk( (count + chunks - 1) / chunks );
+
+    // hand out all but the first chunk to the workers
+    TaskGroup group(Priority::INTERACTIVE);
+    for ( size_t chunk(1) ; chunk<chunks ; ++chunk )
+    {
+        const size_t begin( std::min(count, chunk * perChunk) );
+        const size_t end( std::min(count, begin + perChunk) );
+        group.run([&func, begin, end, chunk]() { func(begin, end, chunk); });
+    }
+
+    // do the first one ourselves, and then any the workers haven't got to
+    func(0, std::min(count, perChunk), 0);
+    group.wait();
+};
+
+} // namespace d3
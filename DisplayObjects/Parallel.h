@@ -0,0 +1,42 @@
+/////////////////////////////////////////////////////////////////
+/// @file      Parallel.h
+/// @author    Chris L Baker (clb) <chris@chimail.net>
+/// @date      2026.10.18
+/// @brief     Split work on big arrays across threads
+///
+/// @attention Copyright (C) 2026
+/// @attention All rights reserved
+/////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace d3
+{
+
+/// @brief   The number of chunks parallelFor() will split a range into
+/// @param   count The number of elements in the range
+/// @param   minPerChunk The smallest chunk worth handing to a thread
+/// @return  size_t The number of chunks (at least 1)
+///
+/// Useful for sizing per-chunk partial results before calling parallelFor()
+size_t parallelChunks(const size_t& count,
+                      const size_t& minPerChunk);
+
+/// @brief   Run a function over contiguous chunks of a range in parallel
+/// @param   count The number of elements in the range [0,count)
+/// @param   minPerChunk The smallest chunk worth handing to a thread
+/// @param   func The function to run on each chunk, it gets the
+///          [begin,end) of the chunk and the index of the chunk
+///
+/// The range is split into parallelChunks(count, minPerChunk) chunks, which
+/// run on the shared workers (see TaskScheduler.h). This returns once all the
+/// chunks are done. The calling thread works on the chunks too, so this is
+/// safe to call from anywhere, including from a task.
+void parallelFor(const size_t& count,
+                 const size_t& minPerChunk,
+                 const std::function<void(size_t, size_t, size_t)>& func);
+
+} // namespace d3
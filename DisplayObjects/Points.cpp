@@ -9,16 +9,131 @@
 /////////////////////////////////////////////////////////////////
 
 #include "Colors.h"
+#include "Parallel.h"
 #include "Points.h"
+#include "Pool.h"
+#include "VoxelHash.h"
 
 #include <osg/Geometry>
 #include <osg/Point>
 #include <osg/Geode>
 #include <osg/Version>
 
+#include <sstream>
+#include <unordered_map>
+
 namespace d3
 {
 
+namespace
+{
+
+/// @brief   What we know about the points in a voxel
+struct VoxelAccumulator
+{
+    /// The sum of the locations and colors (for the centroid)
+    osg::Vec3d location;
+    osg::Vec4d color;
+
+    /// The number of points
+    size_t count;
+
+    /// The index of the first point
+    size_t first;
+};
+
+typedef std::unordered_map<VoxelKey, VoxelAccumulator, VoxelKeyHash> VoxelMap_t;
+
+} // namespace
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+PointVec_t downsample(const PointVec_t& points,
+                      const VoxelFilter& filter,
+                      DownsampleStats* stats /* = nullptr */)
+{
+    if ( filter.leafSize <= 0.0 )
+    {
+        if ( stats ) *stats = DownsampleStats{points.size(), points.size()};
+        return points;
+    }
+
+    // each chunk of points hashes into its own maps, already split into shards
+    // by the hash, so the shards can be merged in parallel too
+    static const size_t pointsPerChunk(1 << 16);
+    const size_t chunks( parallelChunks(points.size(), pointsPerChunk) );
+    const size_t shards( chunks );
+    std::vector<std::vector<VoxelMap_t>> partials( chunks, std::vector<VoxelMap_t>(shards) );
+    parallelFor(points.size(), pointsPerChunk,
+                [&](size_t begin, size_t end, size_t chunk)
+                {
+                    const VoxelKeyHash hash;
+                    for ( size_t ii(begin) ; ii<end ; ++ii )
+                    {
+                        const VoxelKey key( toVoxelKey(points[ii].location, filter.leafSize) );
+                        VoxelMap_t& shard( partials[chunk][hash(key) % shards] );
+                        auto itt( shard.find(key) );
+                        if ( shard.end() == itt )
+                        {
+                            shard.emplace(key, VoxelAccumulator{points[ii].location, points[ii].color, 1, ii});
+                        }
+                        else if ( VoxelFilter::Selection::CENTROID == filter.selection )
+                        {
+                            itt->second.location += points[ii].location;
+                            itt->second.color += points[ii].color;
+                            ++itt->second.count;
+                        }
+                    }
+                });
+
+    // merge each shard across the chunks - the chunks are in order, so the
+    // first hit from an earlier chunk wins
+    std::vector<PointVec_t> merged( shards );
+    parallelFor(shards, 1,
+                [&](size_t begin, size_t end, size_t)
+                {
+                    for ( size_t ss(begin) ; ss<end ; ++ss )
+                    {
+                        VoxelMap_t& voxels( partials[0][ss] );
+                        for ( size_t chunk(1) ; chunk<chunks ; ++chunk )
+                            for ( const auto& voxel : partials[chunk][ss] )
+                            {
+                                auto itt( voxels.find(voxel.first) );
+                                if ( voxels.end() == itt )
+                                {
+                                    voxels.insert(voxel);
+                                }
+                                else if ( VoxelFilter::Selection::CENTROID == filter.selection )
+                                {
+                                    itt->second.location += voxel.second.location;
+                                    itt->second.color += voxel.second.color;
+                                    itt->second.count += voxel.second.count;
+                                }
+                            }
+
+                        merged[ss].reserve(voxels.size());
+                        for ( const auto& voxel : voxels )
+                        {
+                            const VoxelAccumulator& acc( voxel.second );
+                            if ( VoxelFilter::Selection::CENTROID == filter.selection )
+                                merged[ss].push_back( Point{acc.location / acc.count, acc.color / acc.count} );
+                            else
+                                merged[ss].push_back( points[acc.first] );
+                        }
+                    }
+                });
+
+    PointVec_t filtered;
+    size_t total(0);
+    for ( const auto& shard : merged ) total += shard.size();
+    filtered.reserve(total);
+    for ( const auto& shard : merged )
+        filtered.insert(filtered.end(), shard.begin(), shard.end());
+
+    if ( stats ) *stats = DownsampleStats{points.size(), filtered.size()};
+    return filtered;
+};
+
 /////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////
 osg::ref_ptr<osg::Node> get(const PointVec_t& points,
@@ -48,7 +163,7 @@ osg::ref_ptr<osg::Node> get(const PointVec_t& points,
     }
 
     // now add all this stuff to the geometry object
-    osg::ref_ptr<osg::Geometry> cloudGeometry( new osg::Geometry() );
+    osg::ref_ptr<osg::Geometry> cloudGeometry( new Pooled<osg::Geometry>() );
     cloudGeometry->setVertexArray(verts);
 #if      OSG_MIN_VERSION_REQUIRED(3,2,0)
     cloudGeometry->setColorArray(osgColors, osg::Array::Binding::BIND_PER_VERTEX);
@@ -59,14 +174,35 @@ osg::ref_ptr<osg::Node> get(const PointVec_t& points,
     cloudGeometry->addPrimitiveSet(theCloud);
 
     // set the state - point size and lighting
-    osg::ref_ptr<osg::StateSet> cloudStateSet( cloudGeometry->getOrCreateStateSet() );
+    osg::ref_ptr<osg::StateSet> cloudStateSet( new Pooled<osg::StateSet>() );
+    cloudGeometry->setStateSet(cloudStateSet);
     cloudStateSet->setAttribute(new osg::Point(size), osg::StateAttribute::ON);
     cloudStateSet->setMode(GL_LIGHTING, osg::StateAttribute::OFF);
 
     // build the geode to return
-    osg::ref_ptr<osg::Geode> geode(new osg::Geode());
+    osg::ref_ptr<osg::Geode> geode(new Pooled<osg::Geode>());
     geode->addDrawable(cloudGeometry);
     return geode;
 };
 
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+osg::ref_ptr<osg::Node> get(const PointVec_t& points,
+                            const float size,
+                            const VoxelFilter& filter,
+                            DownsampleStats* stats /* = nullptr */)
+{
+    DownsampleStats localStats;
+    osg::ref_ptr<osg::Node> node( get(downsample(points, filter, &localStats), size) );
+
+    std::ostringstream description;
+    description << "Downsampled " << localStats.inputPoints << " to "
+                << localStats.outputPoints << " points (" << localStats.ratio()
+                << ":1) with a " << filter.leafSize << " voxel filter";
+    node->addDescription(description.str());
+
+    if ( stats ) *stats = localStats;
+    return node;
+};
+
 } // namespace d3
@@ -14,6 +14,8 @@
 #include <osg/Vec4>
 #include <osg/Node>
 
+#include <vector>
+
 namespace d3
 {
 
@@ -30,12 +32,71 @@ struct Point
 /// typedef a vector of points
 typedef std::vector<Point> PointVec_t;
 
+/// @brief   An (opt in) voxel grid filter to thin out heavy clouds
+///
+/// Millions of points at a resolution finer than a few pixels on the screen
+/// look the same as one point per voxel, but cost a lot more to upload and
+/// draw. The points are hashed into the voxel grid in parallel, so there is no
+/// need for bounds.
+struct VoxelFilter
+{
+    /// @brief   Which point represents a voxel
+    enum class Selection
+    {
+        CENTROID = 0, ///< The mean location and color of the points in the voxel
+        FIRST_HIT     ///< The first point (in order) which landed in the voxel
+    };
+
+    /// The size of the voxels - nothing is filtered unless this is positive
+    double leafSize;
+
+    /// Which point represents a voxel
+    Selection selection;
+};
+
+/// @brief   How much a VoxelFilter thinned out a cloud
+struct DownsampleStats
+{
+    /// The number of points in
+    size_t inputPoints;
+
+    /// The number of points out
+    size_t outputPoints;
+
+    /// @brief   The reduction ratio (input / output)
+    double ratio() const
+    {
+        return outputPoints ? static_cast<double>(inputPoints) / outputPoints : 0.0;
+    };
+};
+
+/// @brief   Thin out a cloud to (at most) one point per voxel
+/// @param   points The points to filter
+/// @param   filter The filter
+/// @param   stats Where to report the reduction (if not null)
+/// @return  PointVec_t The filtered points
+PointVec_t downsample(const PointVec_t& points,
+                      const VoxelFilter& filter,
+                      DownsampleStats* stats = nullptr);
+
 /// @brief   get an osg node from a vector of points
 /// @param   points The points to add
 /// @param   size The size of all the points
 osg::ref_ptr<osg::Node> get(const PointVec_t& points,
                             const float size = 3.0);
 
+/// @brief   get an osg node from a vector of points, downsampled first
+/// @param   points The points to add
+/// @param   size The size of all the points
+/// @param   filter The voxel filter to run on the points
+/// @param   stats Where to report the reduction (if not null)
+///
+/// The reduction is also put in the description of the node
+osg::ref_ptr<osg::Node> get(const PointVec_t& points,
+                            const float size,
+                            const VoxelFilter& filter,
+                            DownsampleStats* stats = nullptr);
+
 /// @brief   get an osg node
 /// @param   point The point to add
 /// @param   size The size of the point
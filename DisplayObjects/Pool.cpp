@@ -0,0 +1,255 @@
+/////////////////////////////////////////////////////////////////
+/// @file      Pool.cpp
+/// @author    Chris L Baker (clb) <chris@chimail.net>
+/// @date      2026.10.18
+/// @brief     Pooled allocation for the small objects made for every item
+///
+/// @attention Copyright (C) 2026
+/// @attention All rights reserved
+/////////////////////////////////////////////////////////////////
+
+#include "Pool.h"
+
+#include <functional>
+#include <mutex>
+#include <new>
+#include <unordered_set>
+
+namespace d3
+{
+
+namespace
+{
+
+/// The size classes are multiples of this (which is also the alignment)
+const size_t granularity(16);
+
+/// The biggest block we pool
+const size_t maxPooledSize(512);
+
+/// The number of size classes
+const size_t numClasses(maxPooledSize / granularity);
+
+/// The size of the slabs the blocks are carved out of
+const size_t slabSize(64*1024);
+
+/// The number of blocks moved between a thread cache and the shared lists
+const size_t batchSize(32);
+
+/// The most blocks a thread keeps of each size class
+const size_t maxCached(2*batchSize);
+
+/// A free block
+struct Block
+{
+    Block*    next;
+};
+
+/// @brief   The size class of a block (bytes must be in (0, maxPooledSize])
+inline size_t sizeClass(const size_t& bytes)
+{
+    return (bytes + granularity - 1) / granularity - 1;
+};
+
+/////////////////////////////////////////////////////////////////
+/// @brief   The free lists shared by all the threads
+/////////////////////////////////////////////////////////////////
+class SharedLists
+{
+  public:
+
+    SharedLists() :
+        m_mutexes(),
+        m_lists()
+    {
+    };
+
+    /// @brief   Take up to a batch of blocks
+    /// @return  size_t The number of blocks in the list
+    size_t take(const size_t& sc,
+                Block*& list)
+    {
+        std::lock_guard<std::mutex> lock(m_mutexes[sc]);
+        if ( nullptr == m_lists[sc] ) carve(sc);
+
+        list = m_lists[sc];
+        Block* last( list );
+        size_t count(1);
+        while ( (count < batchSize) && last->next )
+        {
+            last = last->next;
+            ++count;
+        }
+        m_lists[sc] = last->next;
+        last->next = nullptr;
+        return count;
+    };
+
+    /// @brief   Give back a list of blocks
+    void give(const size_t& sc,
+              Block* first,
+              Block* last)
+    {
+        std::lock_guard<std::mutex> lock(m_mutexes[sc]);
+        last->next = m_lists[sc];
+        m_lists[sc] = first;
+    };
+
+  private:
+
+    /// @brief   Carve a new slab into blocks (with the lock held)
+    void carve(const size_t& sc)
+    {
+        const size_t blockSize( (sc + 1) * granularity );
+        char* slab( static_cast<char*>(::operator new(slabSize)) );
+        for ( size_t offset(0) ; offset + blockSize <= slabSize ; offset += blockSize )
+        {
+            Block* block( reinterpret_cast<Block*>(slab + offset) );
+            block->next = m_lists[sc];
+            m_lists[sc] = block;
+        }
+    };
+
+    /// One lock per size class
+    std::mutex    m_mutexes[numClasses];
+
+    /// The free blocks of each size class
+    Block*        m_lists[numClasses];
+};
+
+/// @brief   The shared lists, which are never destroyed (blocks can be freed
+///          by static destructors)
+SharedLists& shared()
+{
+    static SharedLists* theLists( new SharedLists() );
+    return *theLists;
+};
+
+/////////////////////////////////////////////////////////////////
+/// @brief   The free blocks of one thread - plain old data, so it's still
+///          usable (and just bypassed) after the thread's destructors ran
+/////////////////////////////////////////////////////////////////
+struct ThreadCache
+{
+    Block*    lists[numClasses];
+    size_t    counts[numClasses];
+    bool      dead;
+};
+
+thread_local ThreadCache cache;
+
+/////////////////////////////////////////////////////////////////
+/// @brief   Give a thread's cached blocks back when the thread exits
+/////////////////////////////////////////////////////////////////
+struct CacheReleaser
+{
+    ~CacheReleaser()
+    {
+        for ( size_t sc(0) ; sc<numClasses ; ++sc )
+        {
+            Block* first( cache.lists[sc] );
+            if ( nullptr == first ) continue;
+            Block* last( first );
+            while ( last->next ) last = last->next;
+            shared().give(sc, first, last);
+            cache.lists[sc] = nullptr;
+            cache.counts[sc] = 0;
+        }
+        cache.dead = true;
+    };
+
+    /// @brief   Make sure this thread's releaser gets constructed
+    void touch() {};
+};
+
+thread_local CacheReleaser releaser;
+
+} // namespace
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void* poolAllocate(const size_t& bytes)
+{
+    if ( (0 == bytes) || (bytes > maxPooledSize) )
+        return ::operator new(bytes);
+
+    const size_t sc( sizeClass(bytes) );
+    if ( cache.dead )
+    {
+        Block* block;
+        shared().take(sc, block);
+        if ( block->next )
+        {
+            Block* last( block->next );
+            while ( last->next ) last = last->next;
+            shared().give(sc, block->next, last);
+        }
+        return block;
+    }
+
+    if ( nullptr == cache.lists[sc] )
+    {
+        releaser.touch();
+        cache.counts[sc] = shared().take(sc, cache.lists[sc]);
+    }
+
+    Block* block( cache.lists[sc] );
+    cache.lists[sc] = block->next;
+    --cache.counts[sc];
+    return block;
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void poolFree(void* ptr,
+              const size_t& bytes)
+{
+    if ( nullptr == ptr ) return;
+    if ( (0 == bytes) || (bytes > maxPooledSize) )
+    {
+        ::operator delete(ptr);
+        return;
+    }
+
+    const size_t sc( sizeClass(bytes) );
+    Block* block( static_cast<Block*>(ptr) );
+    if ( cache.dead )
+    {
+        shared().give(sc, block, block);
+        return;
+    }
+
+    block->next = cache.lists[sc];
+    cache.lists[sc] = block;
+
+    // too many - give a batch back so other threads can use them
+    if ( ++cache.counts[sc] > maxCached )
+    {
+        Block* first( cache.lists[sc] );
+        Block* last( first );
+        for ( size_t ii(1) ; ii<batchSize ; ++ii )
+            last = last->next;
+        cache.lists[sc] = last->next;
+        cache.counts[sc] -= batchSize;
+        shared().give(sc, first, last);
+    }
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+const std::string& intern(const std::string& str)
+{
+    static const size_t numShards(16);
+    struct Shard
+    {
+        std::mutex                         mutex;
+        std::unordered_set<std::string>    strings;
+    };
+    static Shard* shards( new Shard[numShards] );
+
+    Shard& shard( shards[std::hash<std::string>()(str) % numShards] );
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return *shard.strings.insert(str).first;
+};
+
+} // namespace d3
@@ -0,0 +1,89 @@
+/////////////////////////////////////////////////////////////////
+/// @file      Pool.h
+/// @author    Chris L Baker (clb) <chris@chimail.net>
+/// @date      2026.10.18
+/// @brief     Pooled allocation for the small objects made for every item
+///
+/// @attention Copyright (C) 2026
+/// @attention All rights reserved
+/////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <utility>
+
+namespace d3
+{
+
+/// @brief   Allocate a block from the pool for its size class
+/// @param   bytes The size of the block (anything over 512 bytes just goes to
+///          the global operator new)
+/// @return  void* The block
+///
+/// Every thread keeps a small cache of free blocks for each size class, and
+/// only goes to the shared lists (under a lock per size class) to move a batch
+/// of blocks in or out of its cache. So threads churning through small items
+/// mostly don't touch a lock, and the blocks of a size class come from the
+/// same slabs, which keeps the heap from fragmenting. The slabs are never
+/// handed back to the system.
+void* poolAllocate(const size_t& bytes);
+
+/// @brief   Give a block back to the pool
+/// @param   ptr The block from poolAllocate()
+/// @param   bytes The size it was allocated with
+void poolFree(void* ptr,
+              const size_t& bytes);
+
+/// @brief   Intern a string
+/// @param   str The string
+/// @return  const std::string& The one shared copy of that string, which
+///          lives as long as the program
+///
+/// The names and paths of the tree view items repeat a lot (every scan adds
+/// the same "slam::scan" again), so they are interned instead of allocated
+/// for every item.
+const std::string& intern(const std::string& str);
+
+/////////////////////////////////////////////////////////////////
+/// @brief   Inherit from this to allocate a class from the pool
+/////////////////////////////////////////////////////////////////
+class PoolAllocated
+{
+  public:
+
+    /// @{
+    /// @name    Class allocation functions, the size passed to delete is the
+    ///          size of the dynamic type for classes with a virtual destructor
+    static void* operator new(std::size_t bytes) { return poolAllocate(bytes); };
+    static void operator delete(void* ptr, std::size_t bytes) { poolFree(ptr, bytes); };
+    /// @}
+};
+
+/////////////////////////////////////////////////////////////////
+/// @brief   An osg object allocated from the pool
+///
+/// For the scene objects made for every item:
+/// @code
+/// osg::ref_ptr<osg::Geode> geode( new d3::Pooled<osg::Geode>() );
+/// @endcode
+/// osg deletes them through their virtual destructor, so they go back to the
+/// pool.
+/////////////////////////////////////////////////////////////////
+template <typename T>
+class Pooled : public T, public PoolAllocated
+{
+  public:
+
+    /// @brief   Constructor - forwards to the osg constructor
+    template <typename... Args>
+    Pooled(Args&&... args) : T(std::forward<Args>(args)...) {};
+
+  protected:
+
+    /// @brief   Destructor - osg objects are only deleted by unref()
+    virtual ~Pooled() {};
+};
+
+} // namespace d3
@@ -0,0 +1,380 @@
+/////////////////////////////////////////////////////////////////
+/// @file      TaskScheduler.cpp
+/// @author    Chris L Baker (clb) <chris@chimail.net>
+/// @date      2026.10.18
+/// @brief     The one pool of threads for all the background work
+///
+/// @attention Copyright (C) 2026
+/// @attention All rights reserved
+/////////////////////////////////////////////////////////////////
+
+#include "TaskScheduler.h"
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <exception>
+#include <iostream>
+#include <thread>
+
+namespace d3
+{
+
+namespace
+{
+
+/// The number of priorities
+const size_t numPriorities(3);
+
+/// A scheduled function
+struct Task
+{
+    Task() : func(), token(CancelToken::none()) {};
+    Task(std::function<void()>&& ff, const CancelToken& tt) : func(std::move(ff)), token(tt) {};
+
+    std::function<void()>   func;
+    CancelToken             token;
+};
+
+/// The queues of one worker (or the shared queues), one per priority
+struct Queues
+{
+    std::mutex              mutex;
+    std::deque<Task>        tasks[numPriorities];
+};
+
+/////////////////////////////////////////////////////////////////
+/// @brief   The workers, and the queues they take the tasks from
+/////////////////////////////////////////////////////////////////
+class Scheduler
+{
+  public:
+
+    /// @brief   Constructor - starts the workers
+    Scheduler() :
+        m_configMutex(),
+        m_mutex(),
+        m_notify(),
+        m_queued(0),
+        m_running(false),
+        m_shared(),
+        m_workers(),
+        m_threads()
+    {
+        start(0, std::vector<int>());
+    };
+
+    /// @brief   Queue a task
+    void push(Task&& task,
+              const Priority& priority)
+    {
+        // a worker keeps what it schedules, the others go on the shared queues
+        Queues& queues( (this == s_pScheduler) && s_pQueues ? *s_pQueues : m_shared );
+        {
+            std::lock_guard<std::mutex> lock(queues.mutex);
+            queues.tasks[static_cast<size_t>(priority)].push_back(std::move(task));
+        }
+
+        m_queued.fetch_add(1);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_notify.notify_one();
+    };
+
+    /// @brief   Replace the workers
+    void configure(const unsigned int& numWorkers,
+                   const std::vector<int>& cpus)
+    {
+        if ( this == s_pScheduler )
+        {
+            std::cerr << "BUMMER: The workers can't be set up from a task" << std::endl;
+            return;
+        }
+
+        std::lock_guard<std::mutex> configLock(m_configMutex);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_running = false;
+        }
+        m_notify.notify_all();
+        for ( auto& thread : m_threads )
+            thread.join();
+        m_threads.clear();
+
+        // the queued tasks go on to the new workers
+        std::lock_guard<std::mutex> sharedLock(m_shared.mutex);
+        for ( const auto& worker : m_workers )
+            for ( size_t pp(0) ; pp<numPriorities ; ++pp )
+                for ( auto& task : worker->tasks[pp] )
+                    m_shared.tasks[pp].push_back(std::move(task));
+        m_workers.clear();
+
+        start(numWorkers, cpus);
+    };
+
+    /// @brief   The number of workers
+    unsigned int size()
+    {
+        std::lock_guard<std::mutex> configLock(m_configMutex);
+        return m_threads.size();
+    };
+
+  private:
+
+    /// @brief   Start the workers (with the config lock)
+    void start(unsigned int numWorkers,
+               const std::vector<int>& cpus)
+    {
+        if ( 0 == numWorkers )
+            numWorkers = std::max(2u, std::thread::hardware_concurrency()) - 1;
+
+        m_running = true;
+        for ( unsigned int ii(0) ; ii<numWorkers ; ++ii )
+            m_workers.emplace_back(new Queues());
+        for ( unsigned int ii(0) ; ii<numWorkers ; ++ii )
+        {
+            m_threads.emplace_back([this, ii]() { run(*m_workers[ii]); });
+
+            if ( cpus.empty() ) continue;
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            for ( const int& cpu : cpus )
+                CPU_SET(cpu, &set);
+            if ( pthread_setaffinity_np(m_threads.back().native_handle(), sizeof(set), &set) )
+                std::cerr << "BUMMER: Couldn't set the affinity of worker " << ii << std::endl;
+        }
+    };
+
+    /// @brief   The workers
+    void run(Queues& own)
+    {
+        s_pScheduler = this;
+        s_pQueues = &own;
+
+        while ( m_running )
+        {
+            Task task;
+            if ( not take(own, task) )
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_notify.wait(lock, [&]() { return (m_queued.load() > 0) || not m_running; });
+                continue;
+            }
+
+            if ( task.token.isCancelled() ) continue;
+
+            try
+            {
+                task.func();
+            }
+            catch ( const std::exception& ex )
+            {
+                std::cerr << "BUMMER: A task threw: " << ex.what() << std::endl;
+            }
+        }
+
+        s_pScheduler = nullptr;
+        s_pQueues = nullptr;
+    };
+
+    /// @brief   Take the most urgent task - our own newest, then the oldest
+    ///          shared one, then the oldest of another worker
+    bool take(Queues& own,
+              Task& task)
+    {
+        for ( size_t pp(0) ; pp<numPriorities ; ++pp )
+        {
+            if ( takeFrom(own, pp, false, task) ||
+                 takeFrom(m_shared, pp, true, task) )
+                return true;
+
+            for ( const auto& worker : m_workers )
+                if ( (worker.get() != &own) && takeFrom(*worker, pp, true, task) )
+                    return true;
+        }
+        return false;
+    };
+
+    /// @brief   Take a task off one of the queues
+    bool takeFrom(Queues& queues,
+                  const size_t& priority,
+                  const bool& oldest,
+                  Task& task)
+    {
+        std::lock_guard<std::mutex> lock(queues.mutex);
+        std::deque<Task>& tasks( queues.tasks[priority] );
+        if ( tasks.empty() ) return false;
+
+        if ( oldest )
+        {
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        else
+        {
+            task = std::move(tasks.back());
+            tasks.pop_back();
+        }
+        m_queued.fetch_sub(1);
+        return true;
+    };
+
+    /// The scheduler and the queues of the worker on this thread (if it is
+    /// one)
+    static thread_local Scheduler*  s_pScheduler;
+    static thread_local Queues*     s_pQueues;
+
+    /// Protect the workers while they are replaced
+    std::mutex                                  m_configMutex;
+
+    /// Protect the sleeping
+    std::mutex                                  m_mutex;
+
+    /// Wake up the workers
+    std::condition_variable                     m_notify;
+
+    /// The number of queued tasks
+    std::atomic<size_t>                         m_queued;
+
+    /// Flag for the workers
+    std::atomic<bool>                           m_running;
+
+    /// The tasks scheduled from other threads
+    Queues                                      m_shared;
+
+    /// The queues of the workers
+    std::vector<std::unique_ptr<Queues>>        m_workers;
+
+    /// The workers
+    std::vector<std::thread>                    m_threads;
+};
+
+thread_local Scheduler* Scheduler::s_pScheduler( nullptr );
+thread_local Queues* Scheduler::s_pQueues( nullptr );
+
+/// @brief   The shared scheduler - never destroyed, the workers just wait on
+///          it at exit
+Scheduler& scheduler()
+{
+    static Scheduler* pScheduler( new Scheduler() );
+    return *pScheduler;
+};
+
+} // namespace
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void schedule(std::function<void()>&& func,
+              const Priority& priority /* = Priority::BACKGROUND */,
+              const CancelToken& token /* = CancelToken::none() */)
+{
+    if ( token.isCancelled() ) return;
+    scheduler().push(Task(std::move(func), token), priority);
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void setWorkerThreads(const unsigned int& numWorkers,
+                      const std::vector<int>& cpus /* = std::vector<int>() */)
+{
+    scheduler().configure(numWorkers, cpus);
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+unsigned int getWorkerThreads()
+{
+    return scheduler().size();
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+TaskGroup::TaskGroup(const Priority& priority /* = Priority::INTERACTIVE */,
+                     const CancelToken& token /* = CancelToken::none() */) :
+    m_priority(priority),
+    m_token(token),
+    m_pState(std::make_shared<State>())
+{
+    m_pState->pending = 0;
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+TaskGroup::~TaskGroup()
+{
+    wait();
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void TaskGroup::run(std::function<void()>&& func)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_pState->mutex);
+        m_pState->waiting.push_back(std::move(func));
+        ++m_pState->pending;
+    }
+    m_pState->done.notify_all();
+
+    // whoever gets to it first - a worker, or the thread waiting - runs it
+    std::shared_ptr<State> state( m_pState );
+    schedule([state]() { runOne(*state); }, m_priority, m_token);
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void TaskGroup::wait()
+{
+    State& state( *m_pState );
+    while ( true )
+    {
+        if ( m_token.isCancelled() )
+        {
+            std::lock_guard<std::mutex> lock(state.mutex);
+            state.pending -= state.waiting.size();
+            state.waiting.clear();
+        }
+
+        if ( runOne(state) ) continue;
+
+        // the rest are running on the workers
+        std::unique_lock<std::mutex> lock(state.mutex);
+        state.done.wait(lock, [&]() { return (0 == state.pending) || not state.waiting.empty(); });
+        if ( 0 == state.pending ) return;
+    }
+};
+
+/////////////////////////////////////////////////////////////////
+///////////////////// PRIVATES /////////////////////////////////
+///////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+bool TaskGroup::runOne(State& state)
+{
+    std::function<void()> func;
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        if ( state.waiting.empty() ) return false;
+        func = std::move(state.waiting.front());
+        state.waiting.pop_front();
+    }
+
+    try
+    {
+        func();
+    }
+    catch ( const std::exception& ex )
+    {
+        std::cerr << "BUMMER: A task threw: " << ex.what() << std::endl;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        --state.pending;
+    }
+    state.done.notify_all();
+    return true;
+};
+
+} // namespace d3
@@ -0,0 +1,171 @@
+/////////////////////////////////////////////////////////////////
+/// @file      TaskScheduler.h
+/// @author    Chris L Baker (clb) <chris@chimail.net>
+/// @date      2026.10.18
+/// @brief     The one pool of threads for all the background work
+///
+/// @attention Copyright (C) 2026
+/// @attention All rights reserved
+/////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+namespace d3
+{
+
+/// @brief   How soon a task should run - a worker always takes the most
+///          urgent task there is
+enum class Priority
+{
+    INTERACTIVE = 0, ///< Someone is waiting on it (handlers, parallel builds)
+    STREAMING,       ///< Keeps the live data coming (decoding, reloading)
+    BACKGROUND       ///< Nobody is waiting on it (analysis, prebuilding)
+};
+
+/////////////////////////////////////////////////////////////////
+/// @brief   Call off the tasks scheduled with it
+///
+/// Copies share the flag. A cancelled task which hasn't started is dropped
+/// without running (its function is destroyed, so anything it holds is
+/// released). A task which has started runs to the end, unless it checks
+/// isCancelled() itself.
+/////////////////////////////////////////////////////////////////
+class CancelToken
+{
+  public:
+
+    /// @brief   Constructor for a token which can be cancelled
+    CancelToken() : m_pCancelled(std::make_shared<std::atomic<bool>>(false)) {};
+
+    /// @brief   A token which is never cancelled (and costs nothing)
+    static CancelToken none() { return CancelToken(nullptr); };
+
+    /// @brief   Cancel the tasks (from any thread)
+    void cancel() { if ( m_pCancelled ) m_pCancelled->store(true); };
+
+    /// @brief   Has it been cancelled
+    bool isCancelled() const { return m_pCancelled && m_pCancelled->load(std::memory_order_relaxed); };
+
+  private:
+
+    explicit CancelToken(std::nullptr_t) : m_pCancelled() {};
+
+    std::shared_ptr<std::atomic<bool>>   m_pCancelled;
+};
+
+/// @brief   Run a function on the shared workers
+/// @param   func The function
+/// @param   priority How soon it should run
+/// @param   token To call it off before it starts
+///
+/// The display libraries run all their background work here - the parallel
+/// builders, the image decoding, the handlers on the worker pool - so the
+/// display uses a known number of threads however many features are busy.
+/// Each worker has its own queues, and a task scheduled from a worker goes
+/// on that worker's queue (so the data it uses is likely still in the
+/// cache). An idle worker takes work from the other workers. A function which
+/// throws is reported and dropped. Don't block a task on another task (other
+/// than with a TaskGroup), since all the workers could end up waiting.
+void schedule(std::function<void()>&& func,
+              const Priority& priority = Priority::BACKGROUND,
+              const CancelToken& token = CancelToken::none());
+
+/// @brief   Run a function on the shared workers, and get its result
+/// @return  std::future The result - if the task is cancelled before it
+///          starts, the future holds a std::future_error (broken promise)
+template <typename Func>
+std::future<typename std::result_of<Func()>::type>
+scheduleAsync(Func&& func,
+              const Priority& priority = Priority::BACKGROUND,
+              const CancelToken& token = CancelToken::none())
+{
+    typedef typename std::result_of<Func()>::type Result_t;
+    std::shared_ptr<std::packaged_task<Result_t()>> task
+        ( std::make_shared<std::packaged_task<Result_t()>>(std::forward<Func>(func)) );
+    std::future<Result_t> result( task->get_future() );
+    schedule([task]() { (*task)(); }, priority, token);
+    return result;
+};
+
+/// @brief   Set up the shared workers
+/// @param   numWorkers The number of workers (0 for one less than the
+///          number of cores, leaving one for the display)
+/// @param   cpus The cores the workers can run on (empty for any)
+///
+/// This can be called at any time (other than from a task) - the workers
+/// finish what they are running and are replaced, and the queued tasks carry
+/// over to the new ones.
+void setWorkerThreads(const unsigned int& numWorkers,
+                      const std::vector<int>& cpus = std::vector<int>());
+
+/// @brief   The number of shared workers
+unsigned int getWorkerThreads();
+
+/////////////////////////////////////////////////////////////////
+/// @brief   A batch of tasks to wait on together
+///
+/// The tasks go to the shared workers, and wait() runs the ones no worker
+/// has started yet on the calling thread. Only the group's own tasks are run
+/// while waiting, so it's safe to wait with locks held, and groups can nest
+/// (a task can start a group of its own and wait on it).
+/////////////////////////////////////////////////////////////////
+class TaskGroup
+{
+  public:
+
+    /// @{
+    /// @name Noncopyable
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+    /// @}
+
+    /// @brief   Constructor
+    /// @param   priority How soon the tasks should run
+    /// @param   token To call the tasks off
+    explicit TaskGroup(const Priority& priority = Priority::INTERACTIVE,
+                       const CancelToken& token = CancelToken::none());
+
+    /// @brief   Destructor - waits for the tasks
+    ~TaskGroup();
+
+    /// @brief   Add a task
+    void run(std::function<void()>&& func);
+
+    /// @brief   Wait for the tasks, helping with them
+    void wait();
+
+  private:
+
+    /// What the group shares with its tasks
+    struct State
+    {
+        std::mutex                                 mutex;
+        std::condition_variable                    done;
+        std::deque<std::function<void()>>          waiting;
+        size_t                                     pending;
+    };
+
+    /// @brief   Run one of the tasks not started yet, if there is one
+    static bool runOne(State& state);
+
+    /// How soon the tasks should run
+    Priority                  m_priority;
+
+    /// To call the tasks off
+    CancelToken               m_token;
+
+    /// What the group shares with its tasks
+    std::shared_ptr<State>    m_pState;
+};
+
+} // namespace d3
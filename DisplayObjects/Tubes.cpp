@@ -0,0 +1,334 @@
+/////////////////////////////////////////////////////////////////
+/// @file      Tubes.cpp
+/// @author    Chris L Baker (clb) <chris@chimail.net>
+/// @date      2026.10.18
+/// @brief     Provide a simple interface to draw thick paths
+///
+/// @attention Copyright (C) 2026
+/// @attention All rights reserved
+/////////////////////////////////////////////////////////////////
+
+#include "Parallel.h"
+#include "Pool.h"
+#include "Tubes.h"
+
+#include <osg/Geode>
+#include <osg/Geometry>
+#include <osg/Math>
+#include <osg/Version>
+
+#include <algorithm>
+#include <cmath>
+
+namespace d3
+{
+
+namespace
+{
+
+/// The fewest and most sides of a tube
+const unsigned int minSides(4);
+const unsigned int maxSides(32);
+
+/// Vertices closer than this (squared) are the same vertex
+const double minLength2(1e-12);
+
+/// The most a ring is widened at a corner (a hairpin would go to infinity)
+const double maxMiter(4.0);
+
+/// The smallest chunk of tubes worth handing to a thread
+const size_t tubesPerChunk(64);
+
+/// @brief   Where a tube goes in the mesh
+struct Layout
+{
+    /// The vertices of the tube left once the repeats are dropped (empty if
+    /// there's nothing to draw)
+    std::vector<size_t>   kept;
+
+    /// The number of sides
+    unsigned int          sides;
+
+    /// Is it a loop (otherwise it's capped)
+    bool                  closed;
+
+    /// The first vertex and index of the tube in the mesh
+    size_t                firstVertex;
+    size_t                firstIndex;
+};
+
+/// @brief   The number of sides for the facets to be within the tolerance of
+///          the circle
+unsigned int sidesFor(const double& radius,
+                      const double& tolerance)
+{
+    if ( tolerance <= 0.0 ) return maxSides;
+    if ( tolerance >= radius ) return minSides;
+
+    // the middle of a side is radius * cos(pi / sides) from the center
+    const double sides( std::ceil(osg::PI / std::acos(1.0 - tolerance / radius)) );
+    return static_cast<unsigned int>(std::max<double>(minSides, std::min<double>(maxSides, sides)));
+};
+
+/// @brief   The number of vertices of a tube in the mesh
+size_t numVertices(const Layout& layout)
+{
+    return layout.kept.size() * layout.sides + (layout.closed ? 0 : 2 * (layout.sides + 1));
+};
+
+/// @brief   The number of indices of a tube in the mesh
+size_t numIndices(const Layout& layout)
+{
+    const size_t segments( layout.closed ? layout.kept.size() : layout.kept.size() - 1 );
+    return 6 * segments * layout.sides + (layout.closed ? 0 : 6 * layout.sides);
+};
+
+/// @brief   Carry the normal of a ring's frame on to the next ring without
+///          twisting it (the double reflection method)
+osg::Vec3d transport(const osg::Vec3d& from,
+                     const osg::Vec3d& fromTangent,
+                     const osg::Vec3d& normal,
+                     const osg::Vec3d& to,
+                     const osg::Vec3d& toTangent)
+{
+    // reflect the frame in the plane between the rings, then in the plane
+    // which takes the reflected tangent to the new one
+    const osg::Vec3d v1( to - from );
+    const double c1( v1 * v1 );
+    osg::Vec3d next( normal );
+    if ( c1 > minLength2 )
+    {
+        const osg::Vec3d reflected( normal - v1 * (2.0 / c1 * (v1 * normal)) );
+        const osg::Vec3d reflectedTangent( fromTangent - v1 * (2.0 / c1 * (v1 * fromTangent)) );
+        const osg::Vec3d v2( toTangent - reflectedTangent );
+        const double c2( v2 * v2 );
+        next = (c2 > minLength2) ? reflected - v2 * (2.0 / c2 * (v2 * reflected)) : reflected;
+    }
+
+    // take out the rounding, so it stays a frame
+    next -= toTangent * (next * toTangent);
+    next.normalize();
+    return next;
+};
+
+/// @brief   Fill in the mesh of a tube
+void build(const Tube& tube,
+           const Layout& layout,
+           osg::Vec3Array& verts,
+           osg::Vec3Array& normals,
+           osg::Vec4Array& colors,
+           osg::DrawElementsUInt& triangles)
+{
+    const size_t rings( layout.kept.size() );
+    const size_t segments( layout.closed ? rings : rings - 1 );
+    const unsigned int sides( layout.sides );
+    auto vertex = [&](const size_t& rr) -> const TubeVertex& { return tube.vertices[layout.kept[rr]]; };
+
+    // the direction of each segment
+    std::vector<osg::Vec3d> directions( segments );
+    for ( size_t kk(0) ; kk<segments ; ++kk )
+    {
+        directions[kk] = vertex((kk + 1) % rings).location - vertex(kk).location;
+        directions[kk].normalize();
+    }
+
+    // the tangent at each ring splits the corner, and the ring is widened
+    // across the corner so the tube keeps its thickness
+    std::vector<osg::Vec3d> tangents( rings ), bends( rings );
+    std::vector<double> widen( rings, 0.0 );
+    for ( size_t kk(0) ; kk<rings ; ++kk )
+    {
+        const bool hasIn( layout.closed || (kk > 0) );
+        const bool hasOut( layout.closed || (kk + 1 < rings) );
+        const osg::Vec3d in( hasIn ? directions[(kk + segments - 1) % segments] : directions[kk] );
+        const osg::Vec3d out( hasOut ? directions[kk] : in );
+
+        tangents[kk] = in + out;
+        if ( tangents[kk].normalize() < 1e-6 ) tangents[kk] = out;
+
+        osg::Vec3d bend( out - in );
+        bend -= tangents[kk] * (bend * tangents[kk]);
+        if ( bend.normalize() > 1e-6 )
+        {
+            bends[kk] = bend;
+            widen[kk] = 1.0 / std::max(tangents[kk] * out, 1.0 / maxMiter) - 1.0;
+        }
+    }
+
+    // the frames - the first normal is any direction across the tube
+    std::vector<osg::Vec3d> frameNormals( rings );
+    const osg::Vec3d& t0( tangents[0] );
+    frameNormals[0] = t0 ^ (std::fabs(t0.z()) < 0.9 ? osg::Vec3d(0, 0, 1) : osg::Vec3d(1, 0, 0));
+    frameNormals[0].normalize();
+    for ( size_t kk(1) ; kk<rings ; ++kk )
+        frameNormals[kk] = transport(vertex(kk - 1).location, tangents[kk - 1], frameNormals[kk - 1],
+                                     vertex(kk).location, tangents[kk]);
+
+    // a loop comes back around turned a little, so that's spread over the
+    // rings to make the last segment line up with the first
+    double twist(0.0);
+    if ( layout.closed )
+    {
+        const osg::Vec3d back( transport(vertex(rings - 1).location, tangents[rings - 1], frameNormals[rings - 1],
+                                         vertex(0).location, t0) );
+        twist = std::atan2((frameNormals[0] ^ back) * t0, frameNormals[0] * back);
+    }
+
+    // the rings
+    size_t vv( layout.firstVertex );
+    for ( size_t kk(0) ; kk<rings ; ++kk )
+    {
+        const osg::Vec3d& tt( tangents[kk] );
+        const osg::Vec3d& nn( frameNormals[kk] );
+        const osg::Vec3d bb( tt ^ nn );
+        const TubeVertex& tv( vertex(kk) );
+        const double offset( -twist * kk / rings );
+        for ( unsigned int ss(0) ; ss<sides ; ++ss, ++vv )
+        {
+            const double phi( 2.0 * osg::PI * ss / sides + offset );
+            const osg::Vec3d dir( nn * std::cos(phi) + bb * std::sin(phi) );
+            verts[vv] = tv.location + (dir + bends[kk] * ((dir * bends[kk]) * widen[kk])) * tv.radius;
+            normals[vv] = dir;
+            colors[vv] = tv.color;
+        }
+    }
+
+    // the sides, wound counter clockwise from the outside
+    size_t ii( layout.firstIndex );
+    const unsigned int first( static_cast<unsigned int>(layout.firstVertex) );
+    for ( size_t kk(0) ; kk<segments ; ++kk )
+    {
+        const unsigned int ring( first + static_cast<unsigned int>(kk * sides) );
+        const unsigned int next( first + static_cast<unsigned int>(((kk + 1) % rings) * sides) );
+        for ( unsigned int ss(0) ; ss<sides ; ++ss )
+        {
+            const unsigned int s1( (ss + 1) % sides );
+            triangles[ii++] = ring + ss;
+            triangles[ii++] = ring + s1;
+            triangles[ii++] = next + s1;
+            triangles[ii++] = ring + ss;
+            triangles[ii++] = next + s1;
+            triangles[ii++] = next + ss;
+        }
+    }
+
+    if ( layout.closed ) return;
+
+    // flat caps on the ends, with their own vertices for the flat normals
+    const size_t caps[2] = { 0, rings - 1 };
+    for ( const size_t cap : caps )
+    {
+        const osg::Vec3d normal( (0 == cap) ? -tangents[cap] : tangents[cap] );
+        const unsigned int center( static_cast<unsigned int>(vv) );
+        verts[vv] = vertex(cap).location;
+        normals[vv] = normal;
+        colors[vv] = vertex(cap).color;
+        ++vv;
+        for ( unsigned int ss(0) ; ss<sides ; ++ss, ++vv )
+        {
+            const size_t ringVertex( layout.firstVertex + cap * sides + ss );
+            verts[vv] = verts[ringVertex];
+            normals[vv] = normal;
+            colors[vv] = colors[ringVertex];
+        }
+
+        for ( unsigned int ss(0) ; ss<sides ; ++ss )
+        {
+            const unsigned int s1( (ss + 1) % sides );
+            triangles[ii++] = center;
+            triangles[ii++] = center + 1 + ((0 == cap) ? s1 : ss);
+            triangles[ii++] = center + 1 + ((0 == cap) ? ss : s1);
+        }
+    }
+};
+
+} // namespace
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+osg::ref_ptr<osg::Node> get(const TubeVec_t& tubes,
+                            const double& tolerance /* = 0.002 */)
+{
+    // lay the tubes out in the mesh
+    std::vector<Layout> layouts( tubes.size() );
+    size_t totalVertices(0), totalIndices(0);
+    bool transparent(false);
+    for ( size_t tt(0) ; tt<tubes.size() ; ++tt )
+    {
+        const Tube& tube( tubes[tt] );
+        Layout& layout( layouts[tt] );
+
+        double maxRadius(0.0);
+        layout.kept.reserve(tube.vertices.size());
+        for ( size_t vv(0) ; vv<tube.vertices.size() ; ++vv )
+        {
+            const TubeVertex& vertex( tube.vertices[vv] );
+            if ( not layout.kept.empty() &&
+                 ((vertex.location - tube.vertices[layout.kept.back()].location).length2() < minLength2) )
+                continue;
+
+            layout.kept.push_back(vv);
+            maxRadius = std::max(maxRadius, vertex.radius);
+            transparent = transparent || (vertex.color.a() < 1.0);
+        }
+        if ( tube.closed && (layout.kept.size() > 1) &&
+             ((tube.vertices[layout.kept.back()].location -
+               tube.vertices[layout.kept.front()].location).length2() < minLength2) )
+            layout.kept.pop_back();
+
+        if ( (layout.kept.size() < 2) || (maxRadius <= 0.0) )
+        {
+            layout.kept.clear();
+            continue;
+        }
+
+        layout.closed = tube.closed && (layout.kept.size() > 2);
+        layout.sides = sidesFor(maxRadius, tolerance);
+        layout.firstVertex = totalVertices;
+        layout.firstIndex = totalIndices;
+        totalVertices += numVertices(layout);
+        totalIndices += numIndices(layout);
+    }
+
+    // and fill it in
+    osg::ref_ptr<osg::Vec3Array> verts( new osg::Vec3Array(totalVertices) );
+    osg::ref_ptr<osg::Vec3Array> normals( new osg::Vec3Array(totalVertices) );
+    osg::ref_ptr<osg::Vec4Array> colors( new osg::Vec4Array(totalVertices) );
+    osg::ref_ptr<osg::DrawElementsUInt> triangles( new osg::DrawElementsUInt(osg::PrimitiveSet::TRIANGLES, totalIndices) );
+    parallelFor(tubes.size(), tubesPerChunk,
+                [&](size_t begin, size_t end, size_t)
+                {
+                    for ( size_t tt(begin) ; tt<end ; ++tt )
+                        if ( not layouts[tt].kept.empty() )
+                            build(tubes[tt], layouts[tt], *verts, *normals, *colors, *triangles);
+                });
+
+    // one geometry for all of them
+    osg::ref_ptr<osg::Geometry> geometry( new Pooled<osg::Geometry>() );
+    geometry->setUseDisplayList(false);
+    geometry->setUseVertexBufferObjects(true);
+    geometry->setVertexArray(verts);
+#if      OSG_MIN_VERSION_REQUIRED(3,2,0)
+    geometry->setNormalArray(normals, osg::Array::Binding::BIND_PER_VERTEX);
+    geometry->setColorArray(colors, osg::Array::Binding::BIND_PER_VERTEX);
+#else    // OSG_MIN_VERSION_REQUIRED(3,2,0)
+    geometry->setNormalArray(normals);
+    geometry->setNormalBinding(osg::Geometry::BIND_PER_VERTEX);
+    geometry->setColorArray(colors);
+    geometry->setColorBinding(osg::Geometry::BIND_PER_VERTEX);
+#endif   // OSG_MIN_VERSION_REQUIRED(3,2,0)
+    if ( totalIndices ) geometry->addPrimitiveSet(triangles);
+
+    if ( transparent )
+    {
+        geometry->setStateSet(new Pooled<osg::StateSet>());
+        geometry->getStateSet()->setMode(GL_BLEND, osg::StateAttribute::ON);
+        geometry->getStateSet()->setRenderingHint(osg::StateSet::TRANSPARENT_BIN);
+    }
+
+    osg::ref_ptr<osg::Geode> geode( new Pooled<osg::Geode>() );
+    geode->addDrawable(geometry);
+    return geode;
+};
+
+} // namespace d3
@@ -0,0 +1,75 @@
+/////////////////////////////////////////////////////////////////
+/// @file      Tubes.h
+/// @author    Chris L Baker (clb) <chris@chimail.net>
+/// @date      2026.10.18
+/// @brief     Provide a simple interface to draw thick paths
+///
+/// @attention Copyright (C) 2026
+/// @attention All rights reserved
+/////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <osg/Vec3>
+#include <osg/Vec4>
+#include <osg/Node>
+
+#include <vector>
+
+namespace d3
+{
+
+/// @brief   Define a vertex of a tube
+struct TubeVertex
+{
+    /// The location of the vertex
+    osg::Vec3d location;
+
+    /// The radius of the tube at the vertex (it tapers between the vertices)
+    double radius;
+
+    /// The color of the tube at the vertex (it blends between the vertices)
+    osg::Vec4 color;
+};
+
+/// @brief   Define a tube - a circle swept along a polyline
+struct Tube
+{
+    /// The vertices of the polyline
+    std::vector<TubeVertex> vertices;
+
+    /// Join the last vertex back to the first (i.e. a loop of cable),
+    /// otherwise the ends are capped
+    bool closed;
+};
+
+/// typedef a vector of tubes
+typedef std::vector<Tube> TubeVec_t;
+
+/// @brief   Create an osg::Node from a vector of tubes
+/// @param   tubes The vector of tubes to create the node from
+/// @param   tolerance How far the facets can be from the true surface, which
+///          sets the number of sides of each tube (from 4 to 32) by its
+///          radius
+/// @return  osg::ref_ptr<osg::Node> The displayable node
+///
+/// All the tubes go in one mesh (one vertex buffer and one draw call), so
+/// thousands of paths cost about what one does. Each vertex of a polyline is
+/// one ring of the mesh, shared by the segments on either side of it, and
+/// the rings are turned along the path without twisting (a parallel
+/// transport frame), so the sides run smoothly along the tube. At a corner
+/// the ring is widened so the tube keeps its thickness through the bend.
+osg::ref_ptr<osg::Node> get(const TubeVec_t& tubes,
+                            const double& tolerance = 0.002);
+
+/// @brief   Create an osg::Node from a single tube
+/// @param   tube The tube to create the node from
+/// @param   tolerance How far the facets can be from the true surface
+/// @return  osg::ref_ptr<osg::Node> The displayable node
+inline osg::ref_ptr<osg::Node> get(const Tube& tube,
+                                   const double& tolerance = 0.002)
+{
+    return get(TubeVec_t(1, tube), tolerance);
+};
+
+} // namespace d3
@@ -0,0 +1,57 @@
+/////////////////////////////////////////////////////////////////
+/// @file      VoxelHash.h
+/// @author    Chris L Baker (clb) <chris@chimail.net>
+/// @date      2026.10.18
+/// @brief     Hash points into the cells of an unbounded voxel grid
+///
+/// @attention Copyright (C) 2026
+/// @attention All rights reserved
+/////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <osg/Vec3d>
+
+#include <cmath>
+#include <cstdint>
+#include <functional>
+
+namespace d3
+{
+
+/// @brief   The integer coordinates of a voxel grid cell
+struct VoxelKey
+{
+    int64_t xx;
+    int64_t yy;
+    int64_t zz;
+
+    bool operator==(const VoxelKey& other) const
+    {
+        return (xx == other.xx) && (yy == other.yy) && (zz == other.zz);
+    };
+};
+
+/// @brief   The cell a point falls in
+/// @param   point The point
+/// @param   leafSize The size of a cell
+inline VoxelKey toVoxelKey(const osg::Vec3d& point,
+                           const double& leafSize)
+{
+    return VoxelKey{ static_cast<int64_t>(std::floor(point.x() / leafSize)),
+                     static_cast<int64_t>(std::floor(point.y() / leafSize)),
+                     static_cast<int64_t>(std::floor(point.z() / leafSize)) };
+};
+
+/// @brief   Hash a cell (the usual large prime spatial hash)
+struct VoxelKeyHash
+{
+    size_t operator()(const VoxelKey& key) const
+    {
+        return static_cast<size_t>( (key.xx * 73856093) ^
+                                    (key.yy * 19349663) ^
+                                    (key.zz * 83492791) );
+    };
+};
+
+} // namespace d3
@@ -0,0 +1,282 @@
+/////////////////////////////////////////////////////////////////
+/// @file      AssetCache.cpp
+/// @author    Chris L Baker (clb) <chris@chimail.net>
+/// @date      2026.10.18
+/// @brief     An on-disk cache of converted and optimized scenes
+///
+/// @attention Copyright (C) 2026
+/// @attention All rights reserved
+/////////////////////////////////////////////////////////////////
+
+#include "AssetCache.h"
+
+#include <osgDB/ReadFile>
+#include <osgDB/Registry>
+#include <osgUtil/Optimizer>
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <streambuf>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fs = boost::filesystem;
+
+namespace d3
+{
+
+namespace
+{
+
+/// The size of each sample of the content we hash
+const size_t sampleSize(64*1024);
+
+/// @brief   Fold some bytes into an FNV-1a hash
+inline uint64_t fnv1a(const void* data,
+                      const size_t& size,
+                      uint64_t hash = 14695981039346656037ull)
+{
+    const unsigned char* bytes( static_cast<const unsigned char*>(data) );
+    for ( size_t ii(0) ; ii<size ; ++ii )
+    {
+        hash ^= bytes[ii];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+};
+
+/// @brief   A read only stream buffer over a block of memory
+struct MemoryBuffer : public std::streambuf
+{
+    MemoryBuffer(const char* begin,
+                 const size_t& size)
+    {
+        char* data( const_cast<char*>(begin) );
+        setg(data, data, data + size);
+    };
+};
+
+/// @brief   The osgb reader/writer
+osgDB::ReaderWriter* osgb()
+{
+    return osgDB::Registry::instance()->getReaderWriterForExtension("osgb");
+};
+
+} // namespace
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+AssetCache::AssetCache(const std::string& directory /* = defaultDirectory() */,
+                       const uint64_t& maxBytes /* = 4GB */) :
+    m_directory(directory),
+    m_maxBytes(maxBytes),
+    m_mutex()
+{
+    boost::system::error_code ec;
+    fs::create_directories(m_directory, ec);
+    if ( ec )
+        std::cerr << "BUMMER: Can't create the cache in " << m_directory << ": " << ec.message() << std::endl;
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+std::string AssetCache::defaultDirectory()
+{
+    if ( const char* xdg = std::getenv("XDG_CACHE_HOME") )
+        return std::string(xdg) + "/d3";
+    if ( const char* home = std::getenv("HOME") )
+        return std::string(home) + "/.cache/d3";
+    return "/tmp/d3_cache";
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+osg::ref_ptr<osg::Node> AssetCache::load(const std::string& file)
+{
+    const std::string cached( entry(file) );
+
+    // a hit - mark it as recently used
+    if ( not cached.empty() && fs::exists(cached) )
+    {
+        osg::ref_ptr<osg::Node> node( read(cached) );
+        if ( node )
+        {
+            boost::system::error_code ec;
+            fs::last_write_time(cached, std::time(nullptr), ec);
+            return node;
+        }
+
+        std::cerr << "BUMMER: Bad cache entry for " << file << ", converting it again" << std::endl;
+    }
+
+    // a miss - do the full parse and optimization
+    osg::ref_ptr<osg::Node> node( osgDB::readNodeFile(file) );
+    if ( not node )
+        return nullptr;
+
+    osgUtil::Optimizer optimizer;
+    optimizer.optimize(node);
+
+    if ( not cached.empty() && write(node, cached) )
+        cleanup();
+
+    return node;
+};
+
+/////////////////////////////////////////////////////////////////
+///////////////////// PRIVATES /////////////////////////////////
+///////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+std::string AssetCache::entry(const std::string& file) const
+{
+    const int fd( open(file.c_str(), O_RDONLY | O_CLOEXEC) );
+    if ( fd < 0 ) return "";
+
+    struct stat info;
+    if ( fstat(fd, &info) < 0 )
+    {
+        close(fd);
+        return "";
+    }
+
+    // the key - hashing multi-GB files would take longer than loading them
+    // from the cache, so we hash samples from the head, middle and tail
+    boost::system::error_code ec;
+    const std::string canonical( fs::canonical(file, ec).string() );
+    uint64_t hash( fnv1a(canonical.data(), canonical.size()) );
+    hash = fnv1a(&info.st_size, sizeof(info.st_size), hash);
+    hash = fnv1a(&info.st_mtim, sizeof(info.st_mtim), hash);
+
+    std::vector<char> sample(sampleSize);
+    const off_t size( info.st_size );
+    for ( const off_t offset : { off_t(0),
+                                 std::max<off_t>(0, size/2 - off_t(sampleSize)/2),
+                                 std::max<off_t>(0, size - off_t(sampleSize)) } )
+    {
+        const ssize_t len( pread(fd, sample.data(), sample.size(), offset) );
+        if ( len > 0 ) hash = fnv1a(sample.data(), len, hash);
+    }
+    close(fd);
+
+    std::ostringstream name;
+    name << m_directory << "/" << std::hex << std::setw(16) << std::setfill('0') << hash << ".osgb";
+    return name.str();
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+osg::ref_ptr<osg::Node> AssetCache::read(const std::string& cached) const
+{
+    if ( nullptr == osgb() ) return nullptr;
+
+    const int fd( open(cached.c_str(), O_RDONLY | O_CLOEXEC) );
+    if ( fd < 0 ) return nullptr;
+
+    struct stat info;
+    if ( (fstat(fd, &info) < 0) || (0 == info.st_size) )
+    {
+        close(fd);
+        return nullptr;
+    }
+
+    void* data( mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0) );
+    close(fd);
+    if ( MAP_FAILED == data ) return nullptr;
+    madvise(data, info.st_size, MADV_SEQUENTIAL);
+    madvise(data, info.st_size, MADV_WILLNEED);
+
+    MemoryBuffer buffer( static_cast<const char*>(data), info.st_size );
+    std::istream stream(&buffer);
+    osgDB::ReaderWriter::ReadResult result( osgb()->readNode(stream) );
+
+    munmap(data, info.st_size);
+    return result.getNode();
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+bool AssetCache::write(const osg::ref_ptr<osg::Node>& node,
+                       const std::string& cached) const
+{
+    if ( nullptr == osgb() ) return false;
+
+    // write somewhere unique, so a reader never sees a partial entry
+    static std::atomic<unsigned int> count(0);
+    std::ostringstream temp;
+    temp << cached << ".tmp" << getpid() << "_" << count++;
+
+    {
+        std::ofstream stream(temp.str(), std::ios::out | std::ios::binary);
+        osg::ref_ptr<osgDB::Options> options( new osgDB::Options("WriteImageHint=IncludeData") );
+        if ( not stream || not osgb()->writeNode(*node, stream, options).success() )
+        {
+            std::cerr << "BUMMER: Could not write the cache entry " << cached << std::endl;
+            std::remove(temp.str().c_str());
+            return false;
+        }
+    }
+
+    boost::system::error_code ec;
+    fs::rename(temp.str(), cached, ec);
+    if ( ec )
+    {
+        std::remove(temp.str().c_str());
+        return false;
+    }
+    return true;
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void AssetCache::cleanup()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // the entries, most recently used first
+    struct Entry
+    {
+        fs::path     path;
+        uint64_t     size;
+        std::time_t  used;
+    };
+    std::vector<Entry> entries;
+    uint64_t total(0);
+
+    boost::system::error_code ec;
+    for ( fs::directory_iterator itt(m_directory, ec) ; itt != fs::directory_iterator() ; itt.increment(ec) )
+    {
+        if ( ec ) break;
+        if ( ".osgb" != itt->path().extension() ) continue;
+        Entry entry{ itt->path(), fs::file_size(itt->path(), ec), fs::last_write_time(itt->path(), ec) };
+        if ( ec ) continue;
+        total += entry.size;
+        entries.push_back(entry);
+    }
+
+    std::sort(entries.begin(), entries.end(),
+              [](const Entry& aa, const Entry& bb) { return aa.used > bb.used; });
+
+    while ( (total > m_maxBytes) && not entries.empty() )
+    {
+        fs::remove(entries.back().path, ec);
+        total -= entries.back().size;
+        entries.pop_back();
+    }
+};
+
+} // namespace d3
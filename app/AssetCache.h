@@ -0,0 +1,85 @@
+/////////////////////////////////////////////////////////////////
+/// @file      AssetCache.h
+/// @author    Chris L Baker (clb) <chris@chimail.net>
+/// @date      2026.10.18
+/// @brief     An on-disk cache of converted and optimized scenes
+///
+/// @attention Copyright (C) 2026
+/// @attention All rights reserved
+/////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <osg/Node>
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+namespace d3
+{
+
+/////////////////////////////////////////////////////////////////
+/// @brief   Cache converted scenes in the native osg binary format
+///
+/// Parsing and optimizing a big .ply, .obj or .osg file is slow, and dsp does
+/// it every time the same file is opened. The first open of a file runs the
+/// optimizer on the scene and writes it to the cache as .osgb, later opens
+/// memory map that and read it straight back in. The cache entries are keyed
+/// by the path, size and modification time of the file and a hash of samples
+/// of its content, so a changed file just misses. Once the cache goes over its
+/// size limit, the least recently used entries are removed.
+/////////////////////////////////////////////////////////////////
+class AssetCache
+{
+  public:
+
+    /// @{
+    /// @name Noncopyable
+    AssetCache(const AssetCache&) = delete;
+    AssetCache& operator=(const AssetCache&) = delete;
+    /// @}
+
+    /// @brief   Constructor
+    /// @param   directory Where to keep the cache, it gets created if needed
+    /// @param   maxBytes The most space the cache can use
+    explicit AssetCache(const std::string& directory = defaultDirectory(),
+                        const uint64_t& maxBytes = uint64_t(4) << 30);
+
+    /// @brief   The default place for the cache ($XDG_CACHE_HOME/d3 or
+    ///          ~/.cache/d3)
+    static std::string defaultDirectory();
+
+    /// @brief   Load a file, from the cache if we can
+    /// @param   file The file to load
+    /// @return  osg::ref_ptr<osg::Node> The scene, nullptr if it can't be read
+    osg::ref_ptr<osg::Node> load(const std::string& file);
+
+  private:
+
+    /// @brief   The name of the cache entry for a file
+    /// @param   file The file
+    /// @return  std::string The entry, empty if the file can't be read
+    std::string entry(const std::string& file) const;
+
+    /// @brief   Read an entry through a memory map
+    osg::ref_ptr<osg::Node> read(const std::string& entry) const;
+
+    /// @brief   Write an entry (to a temp file which is renamed into place)
+    bool write(const osg::ref_ptr<osg::Node>& node,
+               const std::string& entry) const;
+
+    /// @brief   Remove the least recently used entries until the cache fits
+    void cleanup();
+
+    /// Where the cache lives
+    std::string     m_directory;
+
+    /// The most space the cache can use
+    uint64_t        m_maxBytes;
+
+    /// Protect the cleanup
+    std::mutex      m_mutex;
+};
+
+} // namespace d3
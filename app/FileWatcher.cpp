@@ -0,0 +1,166 @@
+/////////////////////////////////////////////////////////////////
+/// @file      FileWatcher.cpp
+/// @author    Chris L Baker (clb) <chris@chimail.net>
+/// @date      2026.10.18
+/// @brief     Watch files and directories for changes with inotify
+///
+/// @attention Copyright (C) 2026
+/// @attention All rights reserved
+/////////////////////////////////////////////////////////////////
+
+#include "FileWatcher.h"
+
+#include <boost/filesystem.hpp>
+
+#include <chrono>
+#include <iostream>
+
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+namespace d3
+{
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+FileWatcher::FileWatcher(Callback_t&& callback,
+                         const unsigned int& settleTime_ms /* = 50 */) :
+    m_fd(inotify_init1(IN_NONBLOCK | IN_CLOEXEC)),
+    m_callback(std::move(callback)),
+    m_settleTime_ms(settleTime_ms),
+    m_mutex(),
+    m_watchDescriptors(),
+    m_files(),
+    m_directories(),
+    m_threadShouldRun(true),
+    m_thread()
+{
+    if ( m_fd < 0 )
+    {
+        std::cerr << "BUMMER: Could not initialize inotify" << std::endl;
+        return;
+    }
+
+    m_thread = std::thread([&]() { run(); });
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+FileWatcher::~FileWatcher()
+{
+    m_threadShouldRun = false;
+    if ( m_thread.joinable() )
+        m_thread.join();
+
+    if ( m_fd >= 0 )
+        close(m_fd);
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+bool FileWatcher::watch(const std::string& path)
+{
+    namespace fs = boost::filesystem;
+
+    if ( m_fd < 0 ) return false;
+
+    boost::system::error_code ec;
+    fs::path canonical( fs::canonical(path, ec) );
+    if ( ec )
+    {
+        std::cerr << "BUMMER: Can't watch " << path << ": " << ec.message() << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if ( fs::is_directory(canonical) )
+    {
+        if ( not watchDirectory(canonical.string()) ) return false;
+        m_directories.insert(canonical.string());
+    }
+    else
+    {
+        if ( not watchDirectory(canonical.parent_path().string()) ) return false;
+        m_files.insert(canonical.string());
+    }
+
+    return true;
+};
+
+/////////////////////////////////////////////////////////////////
+///////////////////// PRIVATES /////////////////////////////////
+///////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void FileWatcher::run()
+{
+    // the changed files, and when they last changed
+    std::map<std::string, std::chrono::steady_clock::time_point> pending;
+
+    // inotify events are variable length, so read into an aligned buffer
+    alignas(struct inotify_event) char buffer[64*1024];
+
+    while ( m_threadShouldRun )
+    {
+        // wait for something to happen - but not forever, so we can stop
+        struct pollfd pfd{m_fd, POLLIN, 0};
+        const int ready( poll(&pfd, 1, pending.empty() ? 100 : m_settleTime_ms / 2 + 1) );
+
+        if ( ready > 0 )
+        {
+            ssize_t len(0);
+            while ( (len = read(m_fd, buffer, sizeof(buffer))) > 0 )
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                for ( char* ptr(buffer) ; ptr < buffer + len ; )
+                {
+                    const struct inotify_event* event( reinterpret_cast<const struct inotify_event*>(ptr) );
+                    ptr += sizeof(struct inotify_event) + event->len;
+
+                    auto itt( m_watchDescriptors.find(event->wd) );
+                    if ( (m_watchDescriptors.end() == itt) || (0 == event->len) ) continue;
+
+                    const std::string file( itt->second + "/" + event->name );
+                    if ( m_files.count(file) || m_directories.count(itt->second) )
+                        pending[file] = std::chrono::steady_clock::now();
+                }
+            }
+        }
+
+        // report the files which have settled
+        const auto now( std::chrono::steady_clock::now() );
+        for ( auto itt(pending.begin()) ; itt != pending.end() ; )
+        {
+            if ( now - itt->second < std::chrono::milliseconds(m_settleTime_ms) )
+            {
+                ++itt;
+                continue;
+            }
+
+            m_callback(itt->first);
+            itt = pending.erase(itt);
+        }
+    }
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+bool FileWatcher::watchDirectory(const std::string& directory)
+{
+    for ( const auto& wd : m_watchDescriptors )
+        if ( wd.second == directory ) return true;
+
+    const int wd( inotify_add_watch(m_fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) );
+    if ( wd < 0 )
+    {
+        std::cerr << "BUMMER: Could not watch " << directory << std::endl;
+        return false;
+    }
+
+    m_watchDescriptors[wd] = directory;
+    return true;
+};
+
+} // namespace d3
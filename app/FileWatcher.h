@@ -0,0 +1,97 @@
+/////////////////////////////////////////////////////////////////
+/// @file      FileWatcher.h
+/// @author    Chris L Baker (clb) <chris@chimail.net>
+/// @date      2026.10.18
+/// @brief     Watch files and directories for changes with inotify
+///
+/// @attention Copyright (C) 2026
+/// @attention All rights reserved
+/////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+
+namespace d3
+{
+
+/////////////////////////////////////////////////////////////////
+/// @brief   Watch a set of files and directories and call back with the
+///          path of every file that has been (re)written
+///
+/// The parent directory of each watched file is what is handed to inotify,
+/// which catches the case of tools that write a temp file and rename it over
+/// the original. Changes are collected for a short settle time so a file that
+/// is written in several chunks only gets reported once.
+/////////////////////////////////////////////////////////////////
+class FileWatcher
+{
+  public:
+
+    /// The callback with the path of a changed file
+    typedef std::function<void(const std::string&)> Callback_t;
+
+    /// @{
+    /// @name Noncopyable
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+    /// @}
+
+    /// @brief   Constructor
+    /// @param   callback Called from the watcher thread for every changed file
+    /// @param   settleTime_ms How long to wait for more changes before
+    ///          reporting a file
+    explicit FileWatcher(Callback_t&& callback,
+                         const unsigned int& settleTime_ms = 50);
+
+    /// @brief   Destructor - stops the watcher thread
+    ~FileWatcher();
+
+    /// @brief   Watch a file, or all the files in a directory
+    /// @param   path The file or directory to watch
+    /// @return  boolean True if the path is being watched
+    bool watch(const std::string& path);
+
+  private:
+
+    /// @brief   The watcher thread loop
+    void run();
+
+    /// @brief   Add an inotify watch on a directory (if we don't already have one)
+    bool watchDirectory(const std::string& directory);
+
+    /// The inotify file descriptor
+    int                                   m_fd;
+
+    /// The callback for changed files
+    Callback_t                            m_callback;
+
+    /// How long changes have to settle
+    unsigned int                          m_settleTime_ms;
+
+    /// Protect the watch lists
+    std::mutex                            m_mutex;
+
+    /// The inotify watch descriptors to the directory they watch
+    std::map<int, std::string>            m_watchDescriptors;
+
+    /// The individually watched files
+    std::set<std::string>                 m_files;
+
+    /// The directories where every file is watched
+    std::set<std::string>                 m_directories;
+
+    /// Flag for the thread
+    std::atomic<bool>                     m_threadShouldRun;
+
+    /// The watcher thread
+    std::thread                           m_thread;
+};
+
+} // namespace d3
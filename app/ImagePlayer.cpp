@@ -0,0 +1,417 @@
+/////////////////////////////////////////////////////////////////
+/// @file      ImagePlayer.cpp
+/// @author    Chris L Baker (clb) <chris@chimail.net>
+/// @date      2026.10.18
+/// @brief     Play a sequence of images at its recorded rate
+///
+/// @attention Copyright (C) 2026
+/// @attention All rights reserved
+/////////////////////////////////////////////////////////////////
+
+#include "ImagePlayer.h"
+
+#include <DDDisplayObjects/Images.h>
+
+#include <osg/Texture2D>
+#include <osgDB/ReadFile>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory>
+
+namespace d3
+{
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+ImagePlayer::ImagePlayer(const std::vector<std::string>& files,
+                         const double& rate_hz,
+                         const size_t& readAhead /* = 32 */,
+                         const bool& loop /* = true */) :
+    m_files(files),
+    m_rawFile(),
+    m_width(0),
+    m_height(0),
+    m_pixelFormat(0),
+    m_frameBytes(0),
+    m_numFrames(files.size()),
+    m_loop(loop),
+    m_period(),
+    m_readAhead(),
+    m_mutex(),
+    m_notify(),
+    m_frames(),
+    m_playhead(0),
+    m_shownFrame(0),
+    m_next(1),
+    m_startFrame(0),
+    m_startTime(),
+    m_paused(false),
+    m_dropped(0),
+    m_display(),
+    m_shown(),
+    m_node(),
+    m_pUpdater(new Updater(this)),
+    m_maxDecoding(1),
+    m_decoding(0),
+    m_cancel()
+{
+    start(rate_hz, readAhead);
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+ImagePlayer::ImagePlayer(const std::string& rawFile,
+                         const unsigned int& width,
+                         const unsigned int& height,
+                         const GLenum& pixelFormat,
+                         const double& rate_hz,
+                         const size_t& readAhead /* = 32 */,
+                         const bool& loop /* = true */) :
+    m_files(),
+    m_rawFile(rawFile),
+    m_width(width),
+    m_height(height),
+    m_pixelFormat(pixelFormat),
+    m_frameBytes(size_t(width) * height * osg::Image::computeNumComponents(pixelFormat)),
+    m_numFrames(0),
+    m_loop(loop),
+    m_period(),
+    m_readAhead(),
+    m_mutex(),
+    m_notify(),
+    m_frames(),
+    m_playhead(0),
+    m_shownFrame(0),
+    m_next(1),
+    m_startFrame(0),
+    m_startTime(),
+    m_paused(false),
+    m_dropped(0),
+    m_display(),
+    m_shown(),
+    m_node(),
+    m_pUpdater(new Updater(this)),
+    m_maxDecoding(1),
+    m_decoding(0),
+    m_cancel()
+{
+    // the frames are back to back, so the size gives the count
+    std::ifstream raw(m_rawFile, std::ios::binary | std::ios::ate);
+    if ( raw && m_frameBytes )
+        m_numFrames = static_cast<size_t>(raw.tellg()) / m_frameBytes;
+
+    start(rate_hz, readAhead);
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+ImagePlayer::~ImagePlayer()
+{
+    m_pUpdater->detach();
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cancel.cancel();
+        m_notify.wait(lock, [&]() { return 0 == m_decoding; });
+    }
+
+    // the display image can outlive us in the scene, so it gets its own copy
+    // of the pixels of the frame it points into
+    if ( m_shown )
+    {
+        m_display->allocateImage(m_shown->s(), m_shown->t(), m_shown->r(),
+                                 m_shown->getPixelFormat(), m_shown->getDataType(),
+                                 m_shown->getPacking());
+        std::memcpy(m_display->data(), m_shown->data(), m_shown->getTotalSizeInBytes());
+    }
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void ImagePlayer::seek(const int64_t& frame)
+{
+    if ( not isValid() ) return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    const int64_t numFrames( m_numFrames );
+    const int64_t target( m_loop ? ((frame % numFrames) + numFrames) % numFrames
+                                 : std::max<int64_t>(0, std::min(frame, numFrames - 1)) );
+
+    // keep what's already decoded for the frames from there on
+    for ( auto itt(m_frames.begin()) ; m_frames.end() != itt ; )
+    {
+        if ( (itt->first < target) || (itt->first >= target + static_cast<int64_t>(m_readAhead)) )
+            itt = m_frames.erase(itt);
+        else
+            ++itt;
+    }
+
+    m_playhead = m_startFrame = m_next = target;
+    m_shownFrame = -1;
+    m_startTime = std::chrono::steady_clock::now();
+
+    // what's queued for the old position won't be shown
+    m_cancel.cancel();
+    m_cancel = CancelToken();
+    fill();
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void ImagePlayer::step(const int64_t& frames)
+{
+    int64_t playhead(0);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        playhead = m_playhead;
+    }
+    seek(playhead + frames);
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void ImagePlayer::setPaused(const bool& paused)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if ( paused == m_paused ) return;
+
+    // play on from the frame we stopped at
+    m_paused = paused;
+    m_startFrame = m_playhead;
+    m_startTime = std::chrono::steady_clock::now();
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+bool ImagePlayer::isPaused() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_paused;
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+size_t ImagePlayer::getDroppedFrames() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_dropped;
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void ImagePlayer::Updater::operator()(osg::Node* node, osg::NodeVisitor* nv)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if ( m_pPlayer ) m_pPlayer->update();
+    }
+    traverse(node, nv);
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void ImagePlayer::Updater::detach()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_pPlayer = nullptr;
+};
+
+/////////////////////////////////////////////////////////////////
+///////////////////// PRIVATES /////////////////////////////////
+///////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void ImagePlayer::start(const double& rate_hz,
+                        const size_t& readAhead)
+{
+    m_readAhead = std::max<size_t>(1, readAhead);
+    m_period = std::chrono::nanoseconds(static_cast<int64_t>(1e9 / std::max(rate_hz, 1e-3)));
+
+    // the first frame sizes the display, so it's decoded right here
+    std::ifstream raw;
+    if ( not m_rawFile.empty() )
+        raw.open(m_rawFile, std::ios::binary);
+    osg::ref_ptr<osg::Image> first( m_numFrames ? decode(0, raw) : nullptr );
+    if ( not first )
+    {
+        std::cerr << "BUMMER: Nothing to play" << std::endl;
+        m_numFrames = 0;
+        return;
+    }
+
+    m_display = new osg::Image();
+    display(first);
+
+    // a flat image at one unit per 100 pixels, upright when seen from above
+    const float ww( first->s() / 100.0f ), hh( first->t() / 100.0f );
+    m_node = get(Image{m_display, {{osg::Vec3(0, hh, 0), osg::Vec3(ww, hh, 0),
+                                    osg::Vec3(ww, 0, 0), osg::Vec3(0, 0, 0)}}});
+
+    // the texture is made by the image display, but it's subloaded with every
+    // frame here, so it has to be dynamic
+    osg::StateSet* stateSet( m_node->asGroup()->getChild(0)->getStateSet() );
+    stateSet->setDataVariance(osg::Object::DYNAMIC);
+    osg::Texture2D* texture
+        ( dynamic_cast<osg::Texture2D*>(stateSet->getTextureAttribute(0, osg::StateAttribute::TEXTURE)) );
+    if ( texture )
+    {
+        texture->setDataVariance(osg::Object::DYNAMIC);
+        texture->setFilter(osg::Texture::MIN_FILTER, osg::Texture::LINEAR);
+        texture->setFilter(osg::Texture::MAG_FILTER, osg::Texture::LINEAR);
+    }
+    m_node->addUpdateCallback(m_pUpdater);
+
+    m_startTime = std::chrono::steady_clock::now();
+
+    // leave most of the workers to everything else
+    m_maxDecoding = std::max(1u, std::min(4u, getWorkerThreads() / 2));
+    std::lock_guard<std::mutex> lock(m_mutex);
+    fill();
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+osg::ref_ptr<osg::Image> ImagePlayer::decode(const size_t& index,
+                                             std::ifstream& raw) const
+{
+    if ( m_rawFile.empty() )
+    {
+        osg::ref_ptr<osg::Image> image( osgDB::readImageFile(m_files[index]) );
+        if ( not image )
+            std::cerr << "BUMMER: Couldn't read the frame \"" << m_files[index] << "\"" << std::endl;
+        return image;
+    }
+
+    osg::ref_ptr<osg::Image> image( new osg::Image() );
+    image->allocateImage(m_width, m_height, 1, m_pixelFormat, GL_UNSIGNED_BYTE);
+
+    raw.clear();
+    raw.seekg(static_cast<std::streamoff>(index * m_frameBytes));
+    if ( not raw.read(reinterpret_cast<char*>(image->data()), m_frameBytes) )
+    {
+        std::cerr << "BUMMER: Couldn't read frame " << index << " of \"" << m_rawFile << "\"" << std::endl;
+        return nullptr;
+    }
+
+    // the rows are top down, and the texture is bottom up
+    image->flipVertical();
+    return image;
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void ImagePlayer::fill()
+{
+    if ( m_cancel.isCancelled() ) return;
+
+    while ( (m_decoding < m_maxDecoding) &&
+            (m_next < m_playhead + static_cast<int64_t>(m_readAhead)) &&
+            (m_next <= lastFrame()) )
+    {
+        const int64_t frame( m_next++ );
+        ++m_decoding;
+        std::shared_ptr<Decoding> decoding( std::make_shared<Decoding>(*this) );
+        schedule([this, frame, decoding]() { decodeFrame(frame); }, Priority::STREAMING, m_cancel);
+    }
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void ImagePlayer::decodeFrame(const int64_t& frame)
+{
+    std::ifstream raw;
+    if ( not m_rawFile.empty() )
+        raw.open(m_rawFile, std::ios::binary);
+
+    osg::ref_ptr<osg::Image> image( decode(toIndex(frame), raw) );
+
+    // it may have been seeked away from while we were decoding
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if ( image &&
+         (frame >= m_playhead) &&
+         (frame < m_playhead + static_cast<int64_t>(m_readAhead)) )
+        m_frames[frame] = image;
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void ImagePlayer::decoded()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    --m_decoding;
+    fill();
+    m_notify.notify_all();
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void ImagePlayer::update()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if ( not m_paused )
+    {
+        // the frame due now, by the clock
+        const int64_t due( std::min(lastFrame(),
+                                    m_startFrame + (std::chrono::steady_clock::now() - m_startTime) / m_period) );
+        if ( due > m_playhead )
+        {
+            // the frames passed over were never shown
+            m_dropped += (due - m_playhead - 1) + ((m_shownFrame == m_playhead) ? 0 : 1);
+            while ( not m_frames.empty() && (m_frames.begin()->first < due) )
+                m_frames.erase(m_frames.begin());
+
+            m_playhead = due;
+            m_next = std::max(m_next, m_playhead);
+            fill();
+        }
+    }
+
+    if ( m_shownFrame == m_playhead ) return;
+
+    auto found( m_frames.find(m_playhead) );
+    if ( m_frames.end() == found ) return;
+
+    display(found->second);
+    m_shownFrame = m_playhead;
+    m_frames.erase(found);
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+void ImagePlayer::display(const osg::ref_ptr<osg::Image>& image)
+{
+    // point the display image at the frame's pixels - the texture keeps its
+    // GL object and subloads them (and we hold on to the frame meanwhile)
+    m_shown = image;
+    m_display->setImage(image->s(), image->t(), image->r(),
+                        image->getInternalTextureFormat(),
+                        image->getPixelFormat(),
+                        image->getDataType(),
+                        image->data(),
+                        osg::Image::NO_DELETE,
+                        image->getPacking());
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+size_t ImagePlayer::toIndex(const int64_t& frame) const
+{
+    return m_loop ? static_cast<size_t>(frame % static_cast<int64_t>(m_numFrames))
+                  : static_cast<size_t>(std::min<int64_t>(frame, m_numFrames - 1));
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+int64_t ImagePlayer::lastFrame() const
+{
+    return m_loop ? std::numeric_limits<int64_t>::max() : static_cast<int64_t>(m_numFrames) - 1;
+};
+
+} // namespace d3
@@ -0,0 +1,246 @@
+/////////////////////////////////////////////////////////////////
+/// @file      ImagePlayer.h
+/// @author    Chris L Baker (clb) <chris@chimail.net>
+/// @date      2026.10.18
+/// @brief     Play a sequence of images at its recorded rate
+///
+/// @attention Copyright (C) 2026
+/// @attention All rights reserved
+/////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <DDDisplayObjects/TaskScheduler.h>
+
+#include <osg/Image>
+#include <osg/Node>
+#include <osg/NodeCallback>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace d3
+{
+
+/////////////////////////////////////////////////////////////////
+/// @brief   Play a sequence of image files, or a file of raw frames, as a
+///          flat image in the scene
+///
+/// The frames ahead of the one shown are decoded on the shared workers (a
+/// few at a time), into a queue of at most readAhead frames, so the decoding
+/// never waits on the display or the other way around. A seek calls off the
+/// decoding which hasn't started. Frame n is shown at start + n / rate (from
+/// the clock, not by counting draws), so playback keeps the recorded rate -
+/// if the decoding falls behind, the late frames are dropped and counted. The
+/// frames are swapped into one persistent image and texture, so a new frame
+/// is a texture subload, not a new texture.
+/////////////////////////////////////////////////////////////////
+class ImagePlayer
+{
+  public:
+
+    /// @{
+    /// @name Noncopyable
+    ImagePlayer(const ImagePlayer&) = delete;
+    ImagePlayer& operator=(const ImagePlayer&) = delete;
+    /// @}
+
+    /// @brief   Play a sequence of image files
+    /// @param   files The frames in order
+    /// @param   rate_hz The frames per second
+    /// @param   readAhead The most frames decoded ahead of the one shown
+    /// @param   loop Start over at the end
+    ImagePlayer(const std::vector<std::string>& files,
+                const double& rate_hz,
+                const size_t& readAhead = 32,
+                const bool& loop = true);
+
+    /// @brief   Play a file of raw frames (one after another, rows top down,
+    ///          8 bits per channel)
+    /// @param   rawFile The file of frames
+    /// @param   width The width of the frames (pixels)
+    /// @param   height The height of the frames (pixels)
+    /// @param   pixelFormat GL_LUMINANCE, GL_RGB or GL_RGBA
+    /// @param   rate_hz The frames per second
+    /// @param   readAhead The most frames decoded ahead of the one shown
+    /// @param   loop Start over at the end
+    ImagePlayer(const std::string& rawFile,
+                const unsigned int& width,
+                const unsigned int& height,
+                const GLenum& pixelFormat,
+                const double& rate_hz,
+                const size_t& readAhead = 32,
+                const bool& loop = true);
+
+    /// @brief   Destructor - calls off the decoding, and waits for what's
+    ///          already running
+    ~ImagePlayer();
+
+    /// @brief   Is there anything to play (the first frame could be read)
+    bool isValid() const { return m_numFrames > 0; };
+
+    /// @brief   The node showing the frames (one unit per 100 pixels)
+    osg::ref_ptr<osg::Node> getNode() const { return m_node; };
+
+    /// @brief   The number of frames in the sequence
+    const size_t& getNumFrames() const { return m_numFrames; };
+
+    /// @brief   Show a frame, and play on from there (unless paused)
+    /// @param   frame The frame (clamped to the sequence)
+    void seek(const int64_t& frame);
+
+    /// @brief   Seek relative to the frame shown
+    /// @param   frames The number of frames to move (negative is back)
+    void step(const int64_t& frames);
+
+    /// @brief   Pause or resume the playback
+    void setPaused(const bool& paused);
+
+    /// @brief   Is the playback paused
+    bool isPaused() const;
+
+    /// @brief   The number of frames which weren't decoded in time
+    size_t getDroppedFrames() const;
+
+  private:
+
+    /// @brief   Calls update() from the update traversal, until the player is
+    ///          gone
+    class Updater : public osg::NodeCallback
+    {
+      public:
+        explicit Updater(ImagePlayer* player) : m_mutex(), m_pPlayer(player) {};
+        virtual void operator()(osg::Node* node, osg::NodeVisitor* nv);
+        void detach();
+      private:
+        std::mutex      m_mutex;
+        ImagePlayer*    m_pPlayer;
+    };
+
+    /// @brief   Counts a decoding task until it's done with - a cancelled
+    ///          task is dropped rather than run, so it's counted by what the
+    ///          task holds on to
+    class Decoding
+    {
+      public:
+        explicit Decoding(ImagePlayer& player) : m_player(player) {};
+        ~Decoding() { m_player.decoded(); };
+      private:
+        ImagePlayer&    m_player;
+    };
+
+    /// @brief   Decode the first frame, build the node and start decoding
+    void start(const double& rate_hz,
+               const size_t& readAhead);
+
+    /// @brief   Decode a frame
+    /// @param   index The index of the frame in the sequence
+    /// @param   raw The raw file, opened by the calling thread
+    osg::ref_ptr<osg::Image> decode(const size_t& index,
+                                    std::ifstream& raw) const;
+
+    /// @brief   Schedule the decoding of the frames coming up (with the
+    ///          lock)
+    void fill();
+
+    /// @brief   Decode a frame of the playback (on the workers)
+    void decodeFrame(const int64_t& frame);
+
+    /// @brief   A decoding task is done with
+    void decoded();
+
+    /// @brief   Show the frame which is due (update traversal)
+    void update();
+
+    /// @brief   Swap a decoded frame into the display image (with the lock)
+    void display(const osg::ref_ptr<osg::Image>& image);
+
+    /// @brief   The frame of the sequence for a frame of the playback
+    size_t toIndex(const int64_t& frame) const;
+
+    /// @brief   The last frame of the playback, if there is one
+    int64_t lastFrame() const;
+
+    /// The frame files
+    std::vector<std::string>                     m_files;
+
+    /// The raw frame file
+    std::string                                  m_rawFile;
+
+    /// @{
+    /// @name    The raw frame layout
+    unsigned int                                 m_width;
+    unsigned int                                 m_height;
+    GLenum                                       m_pixelFormat;
+    size_t                                       m_frameBytes;
+    /// @}
+
+    /// The number of frames in the sequence
+    size_t                                       m_numFrames;
+
+    /// Start over at the end
+    bool                                         m_loop;
+
+    /// The time between frames
+    std::chrono::nanoseconds                     m_period;
+
+    /// The most frames decoded ahead
+    size_t                                       m_readAhead;
+
+    /// Protect the playback
+    mutable std::mutex                           m_mutex;
+
+    /// Signal the decoding tasks being done with
+    std::condition_variable                      m_notify;
+
+    /// The decoded frames, by playback frame
+    std::map<int64_t, osg::ref_ptr<osg::Image>>  m_frames;
+
+    /// The playback frame due (the count goes on through the loops)
+    int64_t                                      m_playhead;
+
+    /// The playback frame shown
+    int64_t                                      m_shownFrame;
+
+    /// The next playback frame to decode
+    int64_t                                      m_next;
+
+    /// The playback frame played from, and when
+    int64_t                                      m_startFrame;
+    std::chrono::steady_clock::time_point        m_startTime;
+
+    /// Is the playback paused
+    bool                                         m_paused;
+
+    /// The frames not decoded in time
+    size_t                                       m_dropped;
+
+    /// The persistent image the frames are swapped into
+    osg::ref_ptr<osg::Image>                     m_display;
+
+    /// The decoded frame the display image points into
+    osg::ref_ptr<osg::Image>                     m_shown;
+
+    /// The node showing the frames
+    osg::ref_ptr<osg::Node>                      m_node;
+
+    /// The update callback
+    osg::ref_ptr<Updater>                        m_pUpdater;
+
+    /// The most frames decoded at once
+    size_t                                       m_maxDecoding;
+
+    /// The decoding tasks not done with yet
+    size_t                                       m_decoding;
+
+    /// Calls off the decoding (replaced on a seek)
+    CancelToken                                  m_cancel;
+};
+
+} // namespace d3
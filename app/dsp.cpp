@@ -18,8 +18,22 @@
 #include <DDDisplayObjects/Grids.h>
 #include <DDDisplayObjects/Triads.h>
 
+/// run the background work on the shared workers
+#include <DDDisplayObjects/TaskScheduler.h>
+
+/// watch files for changes
+#include "FileWatcher.h"
+
+/// cache the converted files
+#include "AssetCache.h"
+
+/// play image sequences
+#include "ImagePlayer.h"
+
 /// osg
 #include <osgDB/ReadFile>
+#include <osgDB/FileNameUtils>
+#include <osgDB/Registry>
 #include <osg/MatrixTransform>
 #include <osg/Material>
 
@@ -28,10 +42,18 @@
 #include <boost/filesystem.hpp>
 
 /// std
+#include <algorithm>
+#include <cstdio>
 #include <thread>
 #include <chrono>
+#include <future>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
 
 namespace po = boost::program_options;
+namespace fs = boost::filesystem;
 
 /////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////
@@ -42,11 +64,31 @@ bool setupOptions(int argc, char** argv,
     po::options_description desc("Options");
     desc.add_options()
         ("help,h", "Print this help message")
-        ("file,f", po::value<boost::filesystem::path>(), "The file to load and display")
+        ("file,f", po::value<std::vector<fs::path>>()->multitoken(),
+         "The files (or directories of files) to load and display")
         ("scale,s", po::value<double>()->default_value(1.0), "The scale to apply to the model" )
+        ("watch,w", po::bool_switch()->default_value(false),
+         "Watch the files and directories and reload the files that change")
+        ("no-cache", po::bool_switch()->default_value(false),
+         "Don't use (or fill) the cache of converted files")
+        ("cache-size", po::value<unsigned int>()->default_value(4096),
+         "The most space (in MB) the cache of converted files can use")
+        ("play", po::value<fs::path>(),
+         "Play a directory of images (in name order), or a file of raw frames")
+        ("rate", po::value<double>()->default_value(30.0),
+         "The frames per second to play at")
+        ("read-ahead", po::value<unsigned int>()->default_value(32),
+         "The most frames to decode ahead of the one shown")
+        ("raw-size", po::value<std::string>(),
+         "The WIDTHxHEIGHT of the raw frames")
+        ("raw-format", po::value<std::string>()->default_value("rgb"),
+         "The pixels of the raw frames: gray, rgb or rgba")
+        ("workers", po::value<unsigned int>()->default_value(0),
+         "The number of threads for the background work (0 for one less than the cores)")
         ;
 
     po::positional_options_description positionalOptions;
+    positionalOptions.add("file", -1);
 
     po::store(po::command_line_parser(argc, argv).
               options(desc).positional(positionalOptions).run(), vm);
@@ -62,6 +104,73 @@ bool setupOptions(int argc, char** argv,
     return true;
 };
 
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+bool canLoad(const fs::path& file)
+{
+    return fs::is_regular_file(file) &&
+        (nullptr != osgDB::Registry::instance()->
+         getReaderWriterForExtension(osgDB::getLowerCaseFileExtension(file.string())));
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+osg::ref_ptr<osg::Node> loadFile(const fs::path& file,
+                                 const double& scale,
+                                 d3::AssetCache* cache)
+{
+    // read in the osg model
+    osg::ref_ptr<osg::Node> node( cache ? cache->load(file.string()) : osgDB::readNodeFile(file.string()) );
+    if ( not node )
+        return nullptr;
+
+    // make a scaling transform
+    osg::ref_ptr<osg::MatrixTransform> xform(new osg::MatrixTransform(osg::Matrix::scale(osg::Vec3d(scale,scale,scale))));
+    xform->addChild(node);
+    return xform;
+};
+
+/////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////
+std::unique_ptr<d3::ImagePlayer> makePlayer(const po::variables_map& vm)
+{
+    const fs::path source( vm["play"].as<fs::path>() );
+    const double rate( vm["rate"].as<double>() );
+    const size_t readAhead( vm["read-ahead"].as<unsigned int>() );
+
+    // a directory of image files
+    if ( fs::is_directory(source) )
+    {
+        std::vector<std::string> files;
+        for ( fs::directory_iterator itt(source) ; itt != fs::directory_iterator() ; ++itt )
+            if ( canLoad(itt->path()) ) files.push_back(itt->path().string());
+        std::sort(files.begin(), files.end());
+        return std::unique_ptr<d3::ImagePlayer>(new d3::ImagePlayer(files, rate, readAhead));
+    }
+
+    // a file of raw frames
+    unsigned int width(0), height(0);
+    if ( (not vm.count("raw-size")) ||
+         (2 != std::sscanf(vm["raw-size"].as<std::string>().c_str(), "%ux%u", &width, &height)) )
+    {
+        std::cerr << "BUMMER: Playing raw frames needs --raw-size WIDTHxHEIGHT" << std::endl;
+        return nullptr;
+    }
+
+    static const std::map<std::string, GLenum> formats{ {"gray", GL_LUMINANCE},
+                                                        {"rgb",  GL_RGB},
+                                                        {"rgba", GL_RGBA} };
+    auto format( formats.find(vm["raw-format"].as<std::string>()) );
+    if ( formats.end() == format )
+    {
+        std::cerr << "BUMMER: Unknown raw format " << vm["raw-format"].as<std::string>() << std::endl;
+        return nullptr;
+    }
+
+    return std::unique_ptr<d3::ImagePlayer>
+        (new d3::ImagePlayer(source.string(), width, height, format->second, rate, readAhead));
+};
+
 /////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////
 int main(int argc, char** argv)
@@ -71,31 +180,213 @@ int main(int argc, char** argv)
     setupOptions(argc, argv, vm);
 
     // make sure we have a file to read
-    if ( not vm.count("file") )
+    if ( not vm.count("file") && not vm.count("play") )
     {
         std::cerr << "No file specified: try --help for help" << std::endl;
         return EXIT_FAILURE;
     }
 
+    // size the shared workers before anything is handed to them
+    if ( vm["workers"].as<unsigned int>() )
+        d3::setWorkerThreads(vm["workers"].as<unsigned int>());
+
     // get the scale
     double scale(vm["scale"].as<double>());
 
+    // the cache of converted files
+    std::unique_ptr<d3::AssetCache> cache;
+    if ( not vm["no-cache"].as<bool>() )
+        cache.reset(new d3::AssetCache(d3::AssetCache::defaultDirectory(),
+                                       uint64_t(vm["cache-size"].as<unsigned int>()) << 20));
+
     // add common stuff
     d3::di().add( "ground", d3::ground(0.1, 5.0) );
     d3::di().add( "triad", d3::origin() );
 
-    // read in the osg model
-    osg::ref_ptr<osg::Node> node( osgDB::readNodeFile(vm["file"].as<boost::filesystem::path>().string()) );
+    // the tree view names of the files we've loaded (by canonical path)
+    std::mutex namesMutex;
+    std::map<std::string, std::string> names;
 
-    // make a scaling transform
-    osg::ref_ptr<osg::MatrixTransform> xform(new osg::MatrixTransform(osg::Matrix::scale(osg::Vec3d(scale,scale,scale))));
-    xform->addChild(node);
-    if ( node )
-        d3::di().add( vm["file"].as<boost::filesystem::path>().string(), xform );
+    // load all the files, and all the files in the directories
+    const std::vector<fs::path> paths( vm.count("file") ? vm["file"].as<std::vector<fs::path>>()
+                                                        : std::vector<fs::path>() );
+    for ( const fs::path& path : paths )
+    {
+        std::vector<fs::path> files;
+        if ( fs::is_directory(path) )
+        {
+            for ( fs::directory_iterator itt(path) ; itt != fs::directory_iterator() ; ++itt )
+                if ( canLoad(itt->path()) ) files.push_back(itt->path());
+        }
+        else
+        {
+            files.push_back(path);
+        }
+
+        for ( const fs::path& file : files )
+        {
+            osg::ref_ptr<osg::Node> node( loadFile(file, scale, cache.get()) );
+            if ( not node )
+            {
+                std::cerr << "BUMMER: Could not load " << file.string() << std::endl;
+                continue;
+            }
+
+            names[fs::canonical(file).string()] = file.string();
+            d3::di().add( file.string(), node );
+        }
+    }
+
+    // play the image sequence - space pauses, the arrows step a frame, and
+    // the brackets seek 10 seconds (on the key press, the release comes to the
+    // handlers too)
+    std::unique_ptr<d3::ImagePlayer> player;
+    if ( vm.count("play") )
+    {
+        player = makePlayer(vm);
+        if ( player && player->isValid() )
+        {
+            d3::di().add( "sequence", player->getNode() );
+
+            d3::ImagePlayer* pPlayer( player.get() );
+            const int64_t seekFrames( static_cast<int64_t>(10.0 * vm["rate"].as<double>()) );
+            d3::di().add( ' ',
+                          [pPlayer](const osgGA::GUIEventAdapter& ev)->bool
+                          {
+                              if ( osgGA::GUIEventAdapter::KEYDOWN != ev.getEventType() ) return false;
+                              pPlayer->setPaused(not pPlayer->isPaused());
+                              return true;
+                          },
+                          "Pause or play the image sequence" );
+            d3::di().add( osgGA::GUIEventAdapter::KEY_Right,
+                          [pPlayer](const osgGA::GUIEventAdapter& ev)->bool
+                          {
+                              if ( osgGA::GUIEventAdapter::KEYDOWN != ev.getEventType() ) return false;
+                              pPlayer->setPaused(true);
+                              pPlayer->step(1);
+                              return true;
+                          },
+                          "Step the image sequence forward a frame" );
+            d3::di().add( osgGA::GUIEventAdapter::KEY_Left,
+                          [pPlayer](const osgGA::GUIEventAdapter& ev)->bool
+                          {
+                              if ( osgGA::GUIEventAdapter::KEYDOWN != ev.getEventType() ) return false;
+                              pPlayer->setPaused(true);
+                              pPlayer->step(-1);
+                              return true;
+                          },
+                          "Step the image sequence back a frame" );
+            d3::di().add( ']',
+                          [pPlayer, seekFrames](const osgGA::GUIEventAdapter& ev)->bool
+                          {
+                              if ( osgGA::GUIEventAdapter::KEYDOWN != ev.getEventType() ) return false;
+                              pPlayer->step(seekFrames);
+                              return true;
+                          },
+                          "Seek the image sequence forward 10 seconds" );
+            d3::di().add( '[',
+                          [pPlayer, seekFrames](const osgGA::GUIEventAdapter& ev)->bool
+                          {
+                              if ( osgGA::GUIEventAdapter::KEYDOWN != ev.getEventType() ) return false;
+                              pPlayer->step(-seekFrames);
+                              return true;
+                          },
+                          "Seek the image sequence back 10 seconds" );
+        }
+        else
+        {
+            std::cerr << "BUMMER: Could not play " << vm["play"].as<fs::path>().string() << std::endl;
+        }
+    }
+
+    // the reloads which are in flight - these need to outlive the watcher
+    std::mutex reloadsMutex;
+    std::list<std::future<void>> reloads;
+
+    // the newest change of each file - a reload of an older change is dropped,
+    // so two quick writes can't end up showing the first one
+    std::map<std::string, uint64_t> generations;
+
+    // reload the files when they change - each changed file is parsed on the
+    // shared workers and swapped into its tree view entry, which keeps the
+    // camera and the visibility of the entry as it was
+    std::unique_ptr<d3::FileWatcher> watcher;
+    if ( vm["watch"].as<bool>() )
+    {
+        watcher.reset
+            (new d3::FileWatcher
+             ([&](const std::string& changed)
+              {
+                  if ( not canLoad(changed) ) return;
+
+                  std::lock_guard<std::mutex> lock(reloadsMutex);
+                  reloads.remove_if([](const std::future<void>& reload)
+                                    {
+                                        return std::future_status::ready ==
+                                            reload.wait_for(std::chrono::seconds(0));
+                                    });
+
+                  const uint64_t generation( ++generations[changed] );
+                  reloads.push_back
+                      (d3::scheduleAsync
+                       ([&, changed, generation]()
+                        {
+                            const auto isNewest = [&]()
+                                {
+                                    return generations[changed] == generation;
+                                };
+                            {
+                                std::lock_guard<std::mutex> lock(reloadsMutex);
+                                if ( not isNewest() ) return;
+                            }
+
+                            const auto start( std::chrono::steady_clock::now() );
+                            osg::ref_ptr<osg::Node> node( loadFile(changed, scale, cache.get()) );
+                            if ( not node )
+                            {
+                                std::cerr << "BUMMER: Could not reload " << changed << std::endl;
+                                return;
+                            }
+
+                            std::string name;
+                            {
+                                std::lock_guard<std::mutex> lock(namesMutex);
+                                auto itt( names.find(changed) );
+                                name = (names.end() == itt) ? changed : itt->second;
+                            }
+
+                            // a newer change may have been parsed while we were at it
+                            {
+                                std::lock_guard<std::mutex> lock(reloadsMutex);
+                                if ( not isNewest() ) return;
+                                d3::di().add( name, node );
+                            }
+
+                            std::cout << "Reloaded " << name << " in "
+                                      << std::chrono::duration_cast<std::chrono::milliseconds>
+                                (std::chrono::steady_clock::now() - start).count()
+                                      << " ms" << std::endl;
+                        },
+                        d3::Priority::STREAMING));
+              }));
+
+        for ( const fs::path& path : paths )
+            watcher->watch(path.string());
+    }
 
     // wait for close
     d3::di().blockForClose();
 
+    // stop watching before we wait on the reloads
+    watcher.reset();
+    for ( auto& reload : reloads )
+        reload.wait();
+
+    // stop the decoding
+    if ( player && player->isValid() )
+        std::cout << "Dropped " << player->getDroppedFrames() << " frames of the sequence" << std::endl;
+    player.reset();
+
     // we're done
     return EXIT_SUCCESS;
 }
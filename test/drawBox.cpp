@@ -15,7 +15,7 @@
 #include <DDDisplayObjects/Grids.h>    // for ground()
 #include <DDDisplayObjects/Triads.h>   // for the world origin
 #include <DDDisplayObjects/Colors.h>   // gets various colors
-#include <DDDisplayObjects/Capsules.h> // to draw the actual box
+#include <DDDisplayObjects/Tubes.h>    // to draw the actual box
 #include <DDDisplayObjects/HeadsUpDisplay.h> // flashing awesome
 
 /// std stuff
@@ -59,30 +59,30 @@ int main()
              }
          });
 
-    // create the box as a set of capsules
+    // create the box as a set of tubes - all of them are one mesh
     static const double radius(0.1);
-    d3::CapsuleVec_t capsules;
+    d3::TubeVec_t tubes;
 
-    // The bottom square
-    capsules.push_back({{-1.0, -1.0, -1.0}, { 1.0, -1.0, -1.0}, radius, d3::nextColor()});
-    capsules.push_back({{ 1.0, -1.0, -1.0}, { 1.0,  1.0, -1.0}, radius, d3::nextColor()});
-    capsules.push_back({{ 1.0,  1.0, -1.0}, {-1.0,  1.0, -1.0}, radius, d3::nextColor()});
-    capsules.push_back({{-1.0,  1.0, -1.0}, {-1.0, -1.0, -1.0}, radius, d3::nextColor()});
-
-    // The top square
-    capsules.push_back({{-1.0, -1.0,  1.0}, { 1.0, -1.0,  1.0}, radius, d3::nextColor()});
-    capsules.push_back({{ 1.0, -1.0,  1.0}, { 1.0,  1.0,  1.0}, radius, d3::nextColor()});
-    capsules.push_back({{ 1.0,  1.0,  1.0}, {-1.0,  1.0,  1.0}, radius, d3::nextColor()});
-    capsules.push_back({{-1.0,  1.0,  1.0}, {-1.0, -1.0,  1.0}, radius, d3::nextColor()});
+    // The bottom and top squares, as loops
+    for ( const double zz : {-1.0, 1.0} )
+        tubes.push_back({{{{-1.0, -1.0, zz}, radius, d3::nextColor()},
+                          {{ 1.0, -1.0, zz}, radius, d3::nextColor()},
+                          {{ 1.0,  1.0, zz}, radius, d3::nextColor()},
+                          {{-1.0,  1.0, zz}, radius, d3::nextColor()}},
+                         true});
 
     // Joins the top to the bottom
-    capsules.push_back({{-1.0, -1.0, -1.0}, {-1.0, -1.0,  1.0}, radius, d3::nextColor()});
-    capsules.push_back({{ 1.0, -1.0, -1.0}, { 1.0, -1.0,  1.0}, radius, d3::nextColor()});
-    capsules.push_back({{ 1.0,  1.0, -1.0}, { 1.0,  1.0,  1.0}, radius, d3::nextColor()});
-    capsules.push_back({{-1.0,  1.0, -1.0}, {-1.0,  1.0,  1.0}, radius, d3::nextColor()});
-
-    // add the capsules to the display
-    d3::di().add( "box", d3::get(capsules) );
+    for ( const double xx : {-1.0, 1.0} )
+        for ( const double yy : {-1.0, 1.0} )
+        {
+            const osg::Vec4 color( d3::nextColor() );
+            tubes.push_back({{{{xx, yy, -1.0}, radius, color},
+                              {{xx, yy,  1.0}, radius, color}},
+                             false});
+        }
+
+    // add the tubes to the display
+    d3::di().add( "box", d3::get(tubes) );
 
     // wait for the drawing to close
     d3::di().blockForClose();
@@ -0,0 +1,118 @@
+/////////////////////////////////////////////////////////////////
+/// @file      occlusionBenchmark.cpp
+/// @author    Chris L Baker (clb) <chris@chimail.net>
+/// @date      2026.10.18
+/// @brief     Time heavy clouds behind a wall, with and without the occlusion
+///            culling
+///
+/// The occlusion culling pays off most where the vertices are expensive, so
+/// run this on software GL to see it:
+///
+///     LIBGL_ALWAYS_SOFTWARE=1 ./occlusionBenchmark [points] [frames]
+///
+/// @attention Copyright (C) 2026
+/// @attention All rights reserved
+/////////////////////////////////////////////////////////////////
+
+/// The culling
+#include <DDDisplayInterface/OcclusionCulling.h>
+
+/// The things to include for drawing
+#include <DDDisplayObjects/Colors.h>
+#include <DDDisplayObjects/Points.h>
+
+/// osg stuff
+#include <osg/Geode>
+#include <osg/Group>
+#include <osg/ShapeDrawable>
+#include <osgViewer/Viewer>
+
+/// std stuff
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+namespace
+{
+
+/// Points per geode before it goes behind a query
+const size_t minVertices(100000);
+
+/// A cloud of points in a box
+osg::ref_ptr<osg::Node> cloud(const size_t& numPoints,
+                              const osg::Vec3& center,
+                              const float& halfSize)
+{
+    std::mt19937 generator(numPoints);
+    std::uniform_real_distribution<float> offset(-halfSize, halfSize);
+
+    d3::PointVec_t points(numPoints);
+    for ( d3::Point& point : points )
+    {
+        point.location = center + osg::Vec3(offset(generator), offset(generator), offset(generator));
+        point.color = d3::green();
+    }
+    return d3::get(points, 2.0);
+};
+
+/// Draw some frames
+/// @return  double The time per frame (ms)
+double msPerFrame(osgViewer::Viewer& viewer, const int& frames)
+{
+    // let the queries settle first
+    for ( int ii(0) ; ii<10 ; ++ii )
+        viewer.frame();
+
+    const auto begin( std::chrono::steady_clock::now() );
+    for ( int ii(0) ; ii<frames ; ++ii )
+        viewer.frame();
+    const auto end( std::chrono::steady_clock::now() );
+
+    return std::chrono::duration<double, std::milli>(end - begin).count() / frames;
+};
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const size_t numPoints( (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 2000000 );
+    const int frames( (argc > 2) ? std::atoi(argv[2]) : 100 );
+
+    // a wall at x=0, with the clouds behind it (one of them peeks out over the
+    // top, so some of the chunks are still drawn)
+    osg::ref_ptr<osg::Geode> wall( new osg::Geode() );
+    osg::ref_ptr<osg::ShapeDrawable> box( new osg::ShapeDrawable(new osg::Box(osg::Vec3(0,0,0), 0.5, 40, 20)) );
+    box->setColor(d3::white());
+    wall->addDrawable(box);
+
+    osg::ref_ptr<osg::Node> hidden( cloud(numPoints, osg::Vec3(10, 0, 0), 5) );
+    osg::ref_ptr<osg::Node> peeking( cloud(numPoints, osg::Vec3(10, 0, 12), 5) );
+
+    osg::ref_ptr<osg::Group> root( new osg::Group() );
+    root->addChild(wall);
+    root->addChild(hidden);
+    root->addChild(peeking);
+
+    // a fixed camera in front of the wall
+    osgViewer::Viewer viewer;
+    viewer.setThreadingModel(osgViewer::Viewer::SingleThreaded);
+    viewer.setUpViewInWindow(0, 0, 800, 600);
+    viewer.setSceneData(root);
+    viewer.getCamera()->setViewMatrixAsLookAt(osg::Vec3(-30, 0, 0),
+                                              osg::Vec3(0, 0, 0),
+                                              osg::Vec3(0, 0, 1));
+    viewer.realize();
+
+    const double plain_ms( msPerFrame(viewer, frames) );
+
+    root->replaceChild(hidden, d3::occlusionCulled(hidden, minVertices));
+    root->replaceChild(peeking, d3::occlusionCulled(peeking, minVertices));
+    const double culled_ms( msPerFrame(viewer, frames) );
+
+    std::cout << "Two clouds of " << numPoints << " points behind a wall, "
+              << frames << " frames" << std::endl
+              << "  without occlusion culling: " << plain_ms << " ms/frame" << std::endl
+              << "  with occlusion culling:    " << culled_ms << " ms/frame" << std::endl;
+    return 0;
+};